@@ -0,0 +1,102 @@
+/// Measures BLE ingestion through BLEPriorityManager's MPSC queue: 1..N
+/// receiver threads enqueue while the engine thread drains and applies the
+/// batches. Reports end-to-end events per second and enqueue latency
+/// percentiles (a push that finds the queue full retries and counts as one).
+///
+/// Usage: tip_ble_bench [eventsPerProducer=200000] [maxProducers=16] [devices=20000]
+
+#include "ble/BLEEvent.hpp"
+#include "ble/BLEPriorityManager.hpp"
+#include "ble/BLERegistry.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tip;
+using Clock = std::chrono::steady_clock;
+
+static double percentile(std::vector<uint32_t>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    auto nth = samples.begin() + static_cast<std::ptrdiff_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t perProducer  = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const std::size_t maxProducers = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+    const std::size_t devices      = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 20000;
+
+    std::vector<std::string> deviceIds;
+    ble::BLERegistry registry;
+    for (std::size_t d = 0; d < devices; ++d) {
+        deviceIds.push_back("BUS-" + std::to_string(d));
+        registry.authorize(deviceIds.back());
+    }
+
+    std::cout << "BLE ingestion: " << perProducer << " events per producer, "
+              << devices << " devices\n";
+
+    for (std::size_t producers = 1;; producers = std::min(producers * 2, maxProducers)) {
+        ble::BLEConfig config;
+        config.queueCapacity = 65536;
+        ble::BLEPriorityManager manager(config, registry);
+
+        std::atomic<bool>        start{false};
+        std::atomic<std::size_t> running{producers};
+        std::vector<std::vector<uint32_t>> latencies(producers);
+        std::vector<std::thread> threads;
+
+        for (std::size_t p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p] {
+                auto& samples = latencies[p];
+                samples.reserve(perProducer);
+                while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+
+                for (std::size_t i = 0; i < perProducer; ++i) {
+                    ble::BLEEvent event;
+                    event.deviceId  = deviceIds[(p * perProducer + i) % devices];
+                    event.direction = model::Direction(static_cast<uint16_t>(i % 4), 4);
+
+                    auto begin = Clock::now();
+                    event.timestamp = begin;
+                    while (!manager.enqueue(event)) std::this_thread::yield();
+                    samples.push_back(static_cast<uint32_t>(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+                }
+                running.fetch_sub(1, std::memory_order_release);
+            });
+        }
+
+        std::size_t accepted = 0;
+        auto begin = Clock::now();
+        start.store(true, std::memory_order_release);
+        while (running.load(std::memory_order_acquire) > 0) {
+            accepted += manager.drainQueue();
+        }
+        for (auto& t : threads) t.join();
+        accepted += manager.drainQueue();
+        std::chrono::duration<double> elapsed = Clock::now() - begin;
+
+        std::vector<uint32_t> all;
+        for (auto& s : latencies) all.insert(all.end(), s.begin(), s.end());
+        const double total = static_cast<double>(producers * perProducer);
+
+        std::cout << "  producers=" << std::setw(2) << producers
+                  << " | " << std::setw(8) << std::fixed << std::setprecision(2) << total / elapsed.count() / 1e6 << " M events/s"
+                  << " | enqueue p50=" << std::setw(6) << std::setprecision(0) << percentile(all, 0.50) << " ns"
+                  << " p99=" << std::setw(8) << percentile(all, 0.99) << " ns"
+                  << " | accepted=" << accepted << "\n";
+
+        if (producers >= maxProducers) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,107 @@
+/// Measures BatchEnvironment::step throughput from 1 to N threads and checks
+/// that every threaded run matches the serial observations, rewards and
+/// episode ends exactly.
+///
+/// Usage: tip_rl_batch_bench [batch=256] [steps=720] [maxThreads=hw]
+
+#include "rl/BatchEnvironment.hpp"
+#include "model/Lane.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace tip;
+
+static std::vector<model::Lane> createFourWayIntersection() {
+    std::vector<model::Lane> lanes;
+    std::size_t id = 0;
+    for (uint16_t a = 0; a < 4; ++a) {
+        model::Direction dir(a, 4);
+        lanes.push_back({id++, dir, model::MovementType::THROUGH,        {}});
+        lanes.push_back({id++, dir, model::MovementType::LEFT_PROTECTED, {}});
+    }
+    return lanes;
+}
+
+/// Deterministic stand-in for a policy: nudges each environment differently.
+static void writeActions(rl::BatchEnvironment& env, std::size_t step) {
+    auto actions = env.actions();
+    for (std::size_t k = 0; k < env.batchSize(); ++k) {
+        const auto phase = static_cast<float>((k * 7 + step) % 11) - 5.0F;
+        actions[k * rl::ACTION_SIZE + 0] = 0.01F * phase;
+        actions[k * rl::ACTION_SIZE + 1] = -0.01F * phase;
+        actions[k * rl::ACTION_SIZE + 2] = 0.02F * phase;
+    }
+}
+
+/// FNV-1a over the bytes of every output buffer.
+static uint64_t digest(uint64_t h, const rl::BatchEnvironment& env) {
+    auto mix = [&h](const void* data, std::size_t bytes) {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < bytes; ++i) h = (h ^ p[i]) * 0x100000001B3ULL;
+    };
+    mix(env.observations().data(), env.observations().size_bytes());
+    mix(env.rewards().data(), env.rewards().size_bytes());
+    mix(env.dones().data(), env.dones().size_bytes());
+    return h;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t batch      = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+    const std::size_t steps      = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 720;
+    const std::size_t maxThreads = argc > 3 ? std::strtoull(argv[3], nullptr, 10)
+                                            : std::max(1U, std::thread::hardware_concurrency());
+    if (batch == 0 || steps == 0) {
+        std::cerr << "batch and steps must be positive\n";
+        return 2;
+    }
+
+    rl::BatchConfig config;
+    config.episodeTicks = 1800;
+    std::cout << "Batched RL environment: " << batch << " environments, " << steps << " steps of "
+              << config.ticksPerStep << " ticks\n";
+
+    uint64_t referenceDigest = 0;
+    double baselineNs = 0.0;
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        config.threads = threads;
+        rl::BatchEnvironment env(createFourWayIntersection(), engine::EngineConfig{}, batch, config);
+
+        uint64_t h = 0xCBF29CE484222325ULL;
+        double rewardSum = 0.0;
+        std::chrono::nanoseconds elapsed{0};
+        for (std::size_t s = 0; s < steps; ++s) {
+            writeActions(env, s);
+            auto start = std::chrono::steady_clock::now();
+            env.step();
+            elapsed += std::chrono::steady_clock::now() - start;
+            h = digest(h, env);
+            for (float r : env.rewards()) rewardSum += r;
+        }
+        if (threads == 1) referenceDigest = h;
+        const bool identical = h == referenceDigest;
+
+        const double perStepNs = static_cast<double>(elapsed.count()) / static_cast<double>(steps);
+        if (threads == 1) baselineNs = perStepNs;
+        const double envStepsPerSecond = static_cast<double>(batch) * 1e9 / perStepNs;
+
+        std::cout << "  threads=" << std::setw(3) << env.threadCount()
+                  << " | step=" << std::setw(9) << std::fixed << std::setprecision(1) << perStepNs / 1000.0 << " us"
+                  << " | " << std::setw(10) << std::setprecision(0) << envStepsPerSecond << " env-steps/s"
+                  << " | " << std::setw(10) << envStepsPerSecond * config.ticksPerStep << " sim-s/s"
+                  << " | mean reward=" << std::setprecision(3)
+                  << rewardSum / static_cast<double>(batch * steps)
+                  << " | episodes=" << env.episodes()
+                  << " | speedup=" << std::setprecision(2) << baselineNs / perStepNs << "x"
+                  << " | " << (identical ? "identical" : "MISMATCH") << "\n";
+
+        if (!identical) return 1;
+        if (threads >= maxThreads) break;
+    }
+    return 0;
+}
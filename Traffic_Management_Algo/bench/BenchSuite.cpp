@@ -0,0 +1,370 @@
+/// Benchmark suite for the engine hot paths, swept across lane counts
+/// (8..64) and corridor sizes (1..10k). Writes JSON results and optionally
+/// compares them against a baseline written by an earlier run.
+///
+/// Usage: tip_bench [--out=results.json] [--baseline=baseline.json]
+///                  [--threshold=0.10] [--filter=substring] [--min-time-ms=200]
+///
+/// Exits with status 1 if any benchmark is slower than its baseline by more
+/// than threshold (a fraction of the baseline time).
+///
+/// Baseline: bench/update_baseline.sh builds tip_bench in Release and writes
+/// bench/baseline.json. Generate and commit it on the host the regression
+/// checks run on (timings do not carry across machines), then check a build
+/// with --baseline=bench/baseline.json.
+///
+/// Instrumentation overhead: run the default (TIP_INSTRUMENTATION=OFF) build
+/// with --out=off.json, then a -DTIP_INSTRUMENTATION=ON build with
+/// --baseline=off.json --threshold=0.02.
+
+#include "ble/BLEEvent.hpp"
+#include "ble/BLEPriorityManager.hpp"
+#include "ble/BLERegistry.hpp"
+#include "coordination/CorridorCoordinator.hpp"
+#include "engine/PhaseBuilder.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "metrics/Metrics.hpp"
+#include "model/ConflictMatrix.hpp"
+#include "model/Lane.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace tip;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+    struct Options {
+        std::string outPath;
+        std::string baselinePath;
+        std::string filter;
+        double      threshold = 0.10;
+        std::chrono::milliseconds minTime{200};
+    };
+
+    struct Result {
+        std::string name;
+        std::string param;    ///< Swept parameter ("lanes", "intersections", "devices")
+        std::size_t value;    ///< Parameter value
+        double      nsPerOp;  ///< Median over samples
+        uint64_t    iterations;
+
+        [[nodiscard]] std::string key() const { return name + "/" + std::to_string(value); }
+    };
+
+    /// Keep a value observable so the compiler cannot drop the work producing it.
+    template <typename T>
+    void keep(const T& value) {
+        asm volatile("" : : "m"(value) : "memory");
+    }
+
+    /// Run op repeatedly: calibrate a batch that takes about minTime / SAMPLES,
+    /// then report the median per-op time over SAMPLES batches.
+    template <typename Op>
+    Result measure(const Options& options, std::string name, std::string param, std::size_t value, Op&& op) {
+        constexpr int SAMPLES = 5;
+        const auto target = std::chrono::duration_cast<Clock::duration>(options.minTime) / SAMPLES;
+
+        auto timeBatch = [&](uint64_t n) {
+            auto start = Clock::now();
+            for (uint64_t i = 0; i < n; ++i) op();
+            return Clock::now() - start;
+        };
+
+        uint64_t batch = 1;
+        for (auto elapsed = timeBatch(batch); elapsed < target; elapsed = timeBatch(batch)) {
+            const double scale = elapsed.count() > 0
+                ? static_cast<double>(target.count()) / static_cast<double>(elapsed.count())
+                : 10.0;
+            batch = std::max<uint64_t>(batch + 1, static_cast<uint64_t>(static_cast<double>(batch) * std::min(scale * 1.2, 10.0)));
+        }
+
+        std::vector<double> samples;
+        for (int s = 0; s < SAMPLES; ++s) {
+            samples.push_back(static_cast<double>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(timeBatch(batch)).count()) /
+                static_cast<double>(batch));
+        }
+        std::nth_element(samples.begin(), samples.begin() + SAMPLES / 2, samples.end());
+        return {std::move(name), std::move(param), value, samples[SAMPLES / 2], batch * SAMPLES};
+    }
+
+    /// N-way intersection with lanes/2 approaches and no geometry (rule-based conflicts).
+    std::vector<model::Lane> createLanes(std::size_t laneCount, std::mt19937& rng) {
+        const auto approaches = static_cast<uint16_t>(laneCount / 2);
+        std::vector<model::Lane> lanes;
+        std::size_t id = 0;
+        for (uint16_t a = 0; a < approaches; ++a) {
+            model::Direction dir(a, approaches);
+            lanes.push_back({id++, dir, model::MovementType::THROUGH,        {}, static_cast<uint32_t>(rng() % 20)});
+            lanes.push_back({id++, dir, model::MovementType::LEFT_PROTECTED, {}, static_cast<uint32_t>(rng() % 8)});
+        }
+        return lanes;
+    }
+
+    /// Same topology with polyline paths, so conflicts come from geometry.
+    std::vector<model::Lane> createGeometricLanes(std::size_t laneCount, std::mt19937& rng) {
+        auto lanes = createLanes(laneCount, rng);
+        const double step = 2.0 * std::numbers::pi / static_cast<double>(laneCount / 2);
+        for (auto& lane : lanes) {
+            const double entry = lane.direction.index * step;
+            const double exit = entry + (lane.movement == model::MovementType::THROUGH ? std::numbers::pi
+                                                                                       : std::numbers::pi / 2.0);
+            const double bend = lane.movement == model::MovementType::THROUGH ? 0.1 : 0.4;
+            for (int s = 0; s <= 16; ++s) {
+                const double t = s / 16.0;
+                const double angle = entry + (exit - entry) * t;
+                const double radius = 30.0 * (1.0 - (1.0 - bend) * std::sin(std::numbers::pi * t));
+                lane.path.push_back({radius * std::cos(angle), radius * std::sin(angle)});
+            }
+        }
+        return lanes;
+    }
+
+    std::vector<Result> runSuite(const Options& options) {
+        static constexpr std::size_t LANE_COUNTS[]    = {8, 16, 32, 64};
+        static constexpr std::size_t CORRIDOR_SIZES[] = {1, 10, 100, 1000, 10000};
+        static constexpr std::size_t DEVICE_COUNTS[]  = {100, 10000, 1000000};
+
+        std::vector<Result> results;
+        auto enabled = [&](std::string_view name) {
+            return options.filter.empty() || name.find(options.filter) != std::string_view::npos;
+        };
+        auto report = [&](Result r) {
+            std::cout << "  " << std::left << std::setw(28) << r.name << std::right
+                      << std::setw(14) << r.param + "=" + std::to_string(r.value)
+                      << std::setw(14) << std::fixed << std::setprecision(1) << r.nsPerOp << " ns/op\n";
+            results.push_back(std::move(r));
+        };
+
+        for (std::size_t lanes : LANE_COUNTS) {
+            std::mt19937 rng(42);
+            auto topology = createLanes(lanes, rng);
+            auto geometry = createGeometricLanes(lanes, rng);
+
+            if (enabled("conflict_matrix")) {
+                report(measure(options, "conflict_matrix", "lanes", lanes, [&] {
+                    model::ConflictMatrix conflicts(topology);
+                    keep(conflicts);
+                }));
+            }
+            if (enabled("conflict_matrix.geometry")) {
+                report(measure(options, "conflict_matrix.geometry", "lanes", lanes, [&] {
+                    model::ConflictMatrix conflicts(geometry);
+                    keep(conflicts);
+                }));
+            }
+            if (enabled("phase_builder")) {
+                model::ConflictMatrix conflicts(topology);
+                report(measure(options, "phase_builder", "lanes", lanes, [&] {
+                    auto phases = engine::PhaseBuilder::build(topology, conflicts);
+                    keep(phases);
+                }));
+            }
+            if (enabled("engine.step")) {
+                engine::TrafficEngine engine(topology, engine::EngineConfig{});
+                report(measure(options, "engine.step", "lanes", lanes, [&] {
+                    auto decision = engine.step();
+                    keep(decision);
+                }));
+            }
+            if (enabled("engine.select_phase")) {
+                // With zero clearance and green times every third step runs
+                // selectBestPhase(); report the cost of one full cycle
+                engine::EngineConfig config;
+                config.minGreen = config.maxGreen = 0;
+                config.yellowTime = config.allRedTime = 0;
+                engine::TrafficEngine engine(topology, config);
+                std::size_t cycle = 0;
+                report(measure(options, "engine.select_phase", "lanes", lanes, [&] {
+                    for (int s = 0; s < 3; ++s) {
+                        const engine::LaneDelta arrival{static_cast<uint32_t>(cycle++ % lanes), 1};
+                        engine.applyDeltas({&arrival, 1});
+                        auto decision = engine.step();
+                        keep(decision);
+                    }
+                }));
+            }
+        }
+
+        for (std::size_t devices : DEVICE_COUNTS) {
+            if (!enabled("ble.process_event")) break;
+            ble::BLERegistry registry;
+            std::vector<ble::BLEEvent> events(std::min<std::size_t>(devices, 65536));
+            for (std::size_t d = 0; d < devices; ++d) {
+                std::string id = "BUS-" + std::to_string(d);
+                if (d < events.size()) events[d].deviceId = id;
+                registry.authorize(id);
+            }
+            for (std::size_t e = 0; e < events.size(); ++e) {
+                events[e].direction = model::Direction(static_cast<uint16_t>(e % 4), 4);
+            }
+            ble::BLEPriorityManager manager(ble::BLEConfig{}, std::move(registry));
+
+            // Event time advances one second per event, so devices mix accepts
+            // with cooldown and rate-cap rejections
+            auto now = std::chrono::steady_clock::time_point{};
+            std::size_t next = 0;
+            report(measure(options, "ble.process_event", "devices", devices, [&] {
+                auto& event = events[next++ % events.size()];
+                now += std::chrono::seconds(1);
+                event.timestamp = now;
+                bool accepted = manager.processEvent(event);
+                keep(accepted);
+            }));
+        }
+
+        for (std::size_t size : CORRIDOR_SIZES) {
+            if (!enabled("corridor.tick")) break;
+            std::mt19937 rng(42);
+            coordination::CorridorCoordinator corridor;
+            for (std::size_t i = 0; i < size; ++i) {
+                corridor.addIntersection(
+                    std::make_shared<engine::TrafficEngine>(createLanes(6 + 2 * (i % 4), rng), engine::EngineConfig{}),
+                    static_cast<int32_t>(i % 30));
+            }
+            uint32_t t = 0;
+            report(measure(options, "corridor.tick", "intersections", size, [&] {
+                corridor.tick(t++);
+            }));
+        }
+
+        return results;
+    }
+
+    void writeJson(std::ostream& out, const std::vector<Result>& results) {
+        // One result per line; readBaseline() relies on this layout
+        out << "{\n  \"suite\": \"tip_bench\",\n"
+            << "  \"instrumentation\": " << (metrics::enabled() ? "true" : "false") << ",\n"
+            << "  \"results\": [\n";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const auto& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"param\": \"" << r.param
+                << "\", \"value\": " << r.value
+                << ", \"ns_per_op\": " << std::fixed << std::setprecision(2) << r.nsPerOp
+                << ", \"iterations\": " << r.iterations << "}"
+                << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n}\n";
+    }
+
+    /// Field value following "key": on a result line, or empty.
+    std::string field(const std::string& line, std::string_view key) {
+        const std::string tag = "\"" + std::string(key) + "\": ";
+        auto pos = line.find(tag);
+        if (pos == std::string::npos) return {};
+        pos += tag.size();
+        if (line[pos] == '"') {
+            return line.substr(pos + 1, line.find('"', pos + 1) - pos - 1);
+        }
+        return line.substr(pos, line.find_first_of(",}", pos) - pos);
+    }
+
+    /// Read ns_per_op by benchmark key from a file written by writeJson().
+    std::map<std::string, double> readBaseline(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) throw std::runtime_error("cannot open baseline " + path);
+        std::map<std::string, double> baseline;
+        for (std::string line; std::getline(in, line);) {
+            const auto name = field(line, "name");
+            if (name.empty()) continue;
+            baseline[name + "/" + field(line, "value")] = std::stod(field(line, "ns_per_op"));
+        }
+        return baseline;
+    }
+
+    /// Print the comparison and return the number of regressions.
+    std::size_t compare(const std::vector<Result>& results, const std::map<std::string, double>& baseline,
+                        double threshold) {
+        std::size_t regressions = 0;
+        std::cout << "\nComparison against baseline (threshold " << threshold * 100.0 << "%):\n";
+        for (const auto& r : results) {
+            auto it = baseline.find(r.key());
+            if (it == baseline.end()) {
+                std::cout << "  " << std::left << std::setw(42) << r.key() << std::right << "   (new)\n";
+                continue;
+            }
+            const double change = r.nsPerOp / it->second - 1.0;
+            const bool regressed = change > threshold;
+            regressions += regressed;
+            std::cout << "  " << std::left << std::setw(42) << r.key() << std::right
+                      << std::setw(10) << std::showpos << std::setprecision(1) << change * 100.0 << "%"
+                      << std::noshowpos << (regressed ? "  REGRESSION" : "") << "\n";
+        }
+        return regressions;
+    }
+
+    Options parseOptions(int argc, char** argv) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto value = [&](std::string_view flag) -> std::string {
+                return arg.starts_with(flag) ? std::string(arg.substr(flag.size())) : std::string{};
+            };
+            if (arg.starts_with("--out="))              options.outPath = value("--out=");
+            else if (arg.starts_with("--baseline="))    options.baselinePath = value("--baseline=");
+            else if (arg.starts_with("--filter="))      options.filter = value("--filter=");
+            else if (arg.starts_with("--threshold="))   options.threshold = std::stod(value("--threshold="));
+            else if (arg.starts_with("--min-time-ms=")) options.minTime = std::chrono::milliseconds(std::stoll(value("--min-time-ms=")));
+            else throw std::invalid_argument("unknown option " + std::string(arg));
+        }
+        return options;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    try {
+        const auto options = parseOptions(argc, argv);
+        std::cout << "tip_bench (instrumentation " << (metrics::enabled() ? "on" : "off") << ")\n";
+        const auto results = runSuite(options);
+
+        if (metrics::enabled()) {
+            const auto snap = metrics::snapshot();
+            std::cout << "\nMetrics:\n";
+            for (std::size_t c = 0; c < metrics::COUNTER_COUNT; ++c) {
+                std::cout << "  " << std::left << std::setw(28) << metrics::to_string(static_cast<metrics::Counter>(c))
+                          << std::right << std::setw(14) << snap.counters[c] << "\n";
+            }
+            for (std::size_t t = 0; t < metrics::TIMER_COUNT; ++t) {
+                const auto& timer = snap.timers[t];
+                std::cout << "  " << std::left << std::setw(28) << metrics::to_string(static_cast<metrics::Timer>(t))
+                          << std::right << " p50=" << timer.percentile(0.5) << "ns p99=" << timer.percentile(0.99)
+                          << "ns mean=" << std::setprecision(1) << timer.meanNanos() << "ns ("
+                          << timer.samples << " samples)\n";
+            }
+        }
+
+        if (!options.outPath.empty()) {
+            std::ofstream out(options.outPath);
+            writeJson(out, results);
+            if (!out) throw std::runtime_error("cannot write " + options.outPath);
+            std::cout << "\nWrote " << results.size() << " results to " << options.outPath << "\n";
+        }
+        if (!options.baselinePath.empty()) {
+            const auto regressions = compare(results, readBaseline(options.baselinePath), options.threshold);
+            if (regressions > 0) {
+                std::cout << regressions << " regression(s)\n";
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+/// Measures ConflictMatrix construction on high-segment-count lane geometry
+/// against the all-pairs reference, serially and on 1..N pool threads, and
+/// checks that every build matches the reference matrix exactly.
+///
+/// Usage: tip_conflict_bench [approaches=24] [segments=512] [reps=5] [maxThreads=hw]
+
+#include "concurrency/WorkStealingPool.hpp"
+#include "model/ConflictMatrix.hpp"
+#include "model/Geometry.hpp"
+#include "model/Lane.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace tip;
+
+/// Quadratic Bézier from an entry to an exit on a circle of radius r,
+/// sampled into segments pieces, with a small wobble so curves are not
+/// trivially convex.
+static std::vector<model::Point> curve(double entryAngle, double exitAngle, double bend,
+                                       double r, std::size_t segments) {
+    const model::Point p0{r * std::cos(entryAngle), r * std::sin(entryAngle)};
+    const model::Point p2{r * std::cos(exitAngle),  r * std::sin(exitAngle)};
+    const double mid = (entryAngle + exitAngle) / 2.0;
+    const model::Point p1{bend * r * std::cos(mid), bend * r * std::sin(mid)};
+
+    std::vector<model::Point> path;
+    path.reserve(segments + 1);
+    for (std::size_t s = 0; s <= segments; ++s) {
+        const double t = static_cast<double>(s) / static_cast<double>(segments);
+        const double u = 1.0 - t;
+        const double wobble = 0.05 * std::sin(40.0 * t);
+        path.push_back({u * u * p0.x + 2 * u * t * p1.x + t * t * p2.x + wobble,
+                        u * u * p0.y + 2 * u * t * p1.y + t * t * p2.y - wobble});
+    }
+    return path;
+}
+
+static std::vector<model::Lane> createGeometry(uint16_t approaches, std::size_t segments) {
+    constexpr double radius = 30.0;
+    const double step = 2.0 * std::numbers::pi / approaches;
+
+    std::vector<model::Lane> lanes;
+    std::size_t id = 0;
+    for (uint16_t a = 0; a < approaches; ++a) {
+        model::Direction dir(a, approaches);
+        const double entry = a * step;
+        lanes.push_back({id++, dir, model::MovementType::THROUGH,
+                         curve(entry, entry + std::numbers::pi, 0.1, radius, segments)});
+        lanes.push_back({id++, dir, model::MovementType::LEFT_PROTECTED,
+                         curve(entry, entry + std::numbers::pi / 2.0, 0.3, radius, segments)});
+    }
+    return lanes;
+}
+
+static bool sameMatrix(const model::ConflictMatrix& m, const std::vector<std::vector<bool>>& ref) {
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+        for (std::size_t j = 0; j < ref.size(); ++j) {
+            if (i != j && m.conflicts(i, j) != ref[i][j]) return false;
+        }
+    }
+    return true;
+}
+
+template <typename Fn>
+static double bestOfMs(uint32_t reps, Fn&& fn) {
+    double best = 0.0;
+    for (uint32_t r = 0; r < reps; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::milli> ms = std::chrono::steady_clock::now() - start;
+        if (r == 0 || ms.count() < best) best = ms.count();
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    const auto        approaches = static_cast<uint16_t>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 24);
+    const std::size_t segments   = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 512;
+    const uint32_t    reps       = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 5;
+    const std::size_t maxThreads = argc > 4 ? std::strtoull(argv[4], nullptr, 10)
+                                            : std::max(1U, std::thread::hardware_concurrency());
+
+    const auto lanes = createGeometry(approaches, segments);
+    std::cout << "ConflictMatrix build: " << lanes.size() << " lanes, "
+              << segments << " segments per lane\n";
+
+    // All-pairs reference (the pre-index construction)
+    std::vector<std::vector<bool>> reference;
+    const double referenceMs = bestOfMs(reps, [&] {
+        reference.assign(lanes.size(), std::vector<bool>(lanes.size(), false));
+        for (std::size_t i = 0; i < lanes.size(); ++i) {
+            for (std::size_t j = i + 1; j < lanes.size(); ++j) {
+                if (model::polylinesIntersect(lanes[i].path, lanes[j].path)) {
+                    reference[i][j] = reference[j][i] = true;
+                }
+            }
+        }
+    });
+
+    auto report = [&](const char* label, double ms, bool identical) {
+        std::cout << "  " << std::left << std::setw(12) << label << std::right
+                  << " | build=" << std::setw(10) << std::fixed << std::setprecision(3) << ms << " ms"
+                  << " | speedup=" << std::setprecision(2) << referenceMs / ms << "x"
+                  << " | " << (identical ? "identical" : "MISMATCH") << "\n";
+    };
+
+    report("all-pairs", referenceMs, true);
+
+    bool allIdentical = true;
+    {
+        std::optional<model::ConflictMatrix> m;
+        const double ms = bestOfMs(reps, [&] { m.emplace(lanes); });
+        const bool identical = sameMatrix(*m, reference);
+        report("indexed", ms, identical);
+        allIdentical = allIdentical && identical;
+    }
+
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        concurrency::WorkStealingPool pool(threads);
+        std::optional<model::ConflictMatrix> m;
+        const double ms = bestOfMs(reps, [&] { m.emplace(lanes, pool); });
+        const bool identical = sameMatrix(*m, reference);
+        const std::string label = "threads=" + std::to_string(threads);
+        report(label.c_str(), ms, identical);
+        allIdentical = allIdentical && identical;
+        if (threads >= maxThreads) break;
+    }
+
+    return allIdentical ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+
+/// Measures CorridorCoordinator::tick latency from 1 to N threads and
+/// checks that every parallel run matches the serial decisions exactly.
+///
+/// Usage: tip_corridor_bench [intersections=10000] [ticks=200] [maxThreads=hw]
+
+#include "coordination/CorridorCoordinator.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace tip;
+
+static std::vector<model::Lane> createNWayIntersection(uint16_t numApproaches, std::mt19937& rng) {
+    std::vector<model::Lane> lanes;
+    std::size_t id = 0;
+    for (uint16_t a = 0; a < numApproaches; ++a) {
+        model::Direction dir(a, numApproaches);
+        lanes.push_back({id++, dir, model::MovementType::THROUGH,        {}, static_cast<uint32_t>(rng() % 20)});
+        lanes.push_back({id++, dir, model::MovementType::LEFT_PROTECTED, {}, static_cast<uint32_t>(rng() % 8)});
+    }
+    return lanes;
+}
+
+static coordination::CorridorCoordinator buildCorridor(std::size_t size) {
+    std::mt19937 rng(42);
+    engine::EngineConfig config;
+    coordination::CorridorCoordinator corridor;
+    for (std::size_t i = 0; i < size; ++i) {
+        auto approaches = static_cast<uint16_t>(3 + i % 4);
+        corridor.addIntersection(
+            std::make_shared<engine::TrafficEngine>(createNWayIntersection(approaches, rng), config),
+            static_cast<int32_t>(i % 30));
+    }
+    return corridor;
+}
+
+static bool sameDecision(const model::Decision& a, const model::Decision& b) {
+    return a.selectedPhaseIndex == b.selectedPhaseIndex
+        && a.phaseNameId == b.phaseNameId
+        && a.signalState == b.signalState
+        && a.phaseScore == b.phaseScore
+        && a.greenDuration == b.greenDuration
+        && a.activePriority == b.activePriority;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t intersections = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    const uint32_t    ticks         = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 200;
+    const std::size_t maxThreads    = argc > 3 ? std::strtoull(argv[3], nullptr, 10)
+                                               : std::max(1U, std::thread::hardware_concurrency());
+
+    std::cout << "Corridor tick scaling: " << intersections << " intersections, "
+              << ticks << " ticks\n";
+
+    // Serial reference trace
+    std::vector<model::Decision> reference;
+    reference.reserve(intersections * ticks);
+    {
+        auto corridor = buildCorridor(intersections);
+        for (uint32_t t = 0; t < ticks; ++t) {
+            corridor.tick(t);
+            const auto& d = corridor.lastDecisions();
+            reference.insert(reference.end(), d.begin(), d.end());
+        }
+    }
+
+    double baselineNs = 0.0;
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        auto corridor = buildCorridor(intersections);
+        corridor.setThreadCount(threads);
+
+        bool identical = true;
+        std::chrono::nanoseconds elapsed{0};
+        for (uint32_t t = 0; t < ticks; ++t) {
+            auto start = std::chrono::steady_clock::now();
+            corridor.tick(t);
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            const auto& d = corridor.lastDecisions();
+            for (std::size_t i = 0; i < d.size(); ++i) {
+                identical = identical && sameDecision(d[i], reference[t * intersections + i]);
+            }
+        }
+
+        double perTickNs = static_cast<double>(elapsed.count()) / ticks;
+        if (threads == 1) baselineNs = perTickNs;
+
+        std::cout << "  threads=" << std::setw(3) << threads
+                  << " | tick=" << std::setw(10) << std::fixed << std::setprecision(1) << perTickNs / 1000.0 << " us"
+                  << " | speedup=" << std::setprecision(2) << baselineNs / perTickNs << "x"
+                  << " | " << (identical ? "identical" : "MISMATCH") << "\n";
+
+        if (!identical) return 1;
+        if (threads >= maxThreads) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+/// Compares stepping every intersection every tick (CorridorCoordinator) with
+/// stepping only on state changes (EventScheduler), and checks on a smaller
+/// corridor that both report identical decisions on every tick.
+///
+/// Usage: tip_event_bench [intersections=10000] [ticks=3600]
+
+#include "coordination/CorridorCoordinator.hpp"
+#include "coordination/EventScheduler.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace tip;
+
+static std::vector<model::Lane> createNWayIntersection(uint16_t numApproaches, std::mt19937& rng) {
+    std::vector<model::Lane> lanes;
+    std::size_t id = 0;
+    for (uint16_t a = 0; a < numApproaches; ++a) {
+        model::Direction dir(a, numApproaches);
+        lanes.push_back({id++, dir, model::MovementType::THROUGH,        {}, static_cast<uint32_t>(rng() % 20)});
+        lanes.push_back({id++, dir, model::MovementType::LEFT_PROTECTED, {}, static_cast<uint32_t>(rng() % 8)});
+    }
+    return lanes;
+}
+
+template <typename Corridor>
+static Corridor buildCorridor(std::size_t size) {
+    std::mt19937 rng(42);
+    engine::EngineConfig config;
+    Corridor corridor;
+    for (std::size_t i = 0; i < size; ++i) {
+        auto approaches = static_cast<uint16_t>(3 + i % 4);
+        corridor.addIntersection(
+            std::make_shared<engine::TrafficEngine>(createNWayIntersection(approaches, rng), config),
+            static_cast<int32_t>(i % 30));
+    }
+    return corridor;
+}
+
+static bool sameDecision(const model::Decision& a, const model::Decision& b) {
+    return a.selectedPhaseIndex == b.selectedPhaseIndex
+        && a.phaseNameId == b.phaseNameId
+        && a.signalState == b.signalState
+        && a.phaseScore == b.phaseScore
+        && a.greenDuration == b.greenDuration
+        && a.activePriority == b.activePriority;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t intersections = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+    const uint32_t    ticks         = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 3600;
+
+    // Equivalence on every tick for a smaller corridor
+    bool identical = true;
+    {
+        const std::size_t checked = std::min<std::size_t>(intersections, 500);
+        auto reference = buildCorridor<coordination::CorridorCoordinator>(checked);
+        auto events    = buildCorridor<coordination::EventScheduler>(checked);
+        for (uint32_t t = 0; t < std::min<uint32_t>(ticks, 600) && identical; ++t) {
+            reference.tick(t);
+            (void)events.tick();
+            for (std::size_t i = 0; i < checked; ++i) {
+                identical = identical && sameDecision(events.decision(i), reference.lastDecisions()[i]);
+            }
+        }
+    }
+
+    std::cout << "Event-driven advance: " << intersections << " intersections, "
+              << ticks << " ticks\n";
+
+    using Clock = std::chrono::steady_clock;
+    double perTickUs = 0.0;
+    {
+        auto corridor = buildCorridor<coordination::CorridorCoordinator>(intersections);
+        auto start = Clock::now();
+        for (uint32_t t = 0; t < ticks; ++t) corridor.tick(t);
+        std::chrono::duration<double, std::micro> us = Clock::now() - start;
+        perTickUs = us.count() / ticks;
+        std::cout << "  every tick   | tick=" << std::setw(10) << std::fixed << std::setprecision(1)
+                  << perTickUs << " us | steps/tick=" << intersections << "\n";
+    }
+    {
+        auto corridor = buildCorridor<coordination::EventScheduler>(intersections);
+        std::size_t transitions = 0;
+        auto start = Clock::now();
+        for (uint32_t t = 0; t < ticks; ++t) transitions += corridor.tick().size();
+        std::chrono::duration<double, std::micro> us = Clock::now() - start;
+        std::cout << "  event-driven | tick=" << std::setw(10) << std::fixed << std::setprecision(1)
+                  << us.count() / ticks << " us | steps/tick=" << std::setprecision(1)
+                  << static_cast<double>(transitions) / ticks
+                  << " | speedup=" << std::setprecision(2) << perTickUs * ticks / us.count() << "x"
+                  << " | " << (identical ? "identical" : "MISMATCH") << "\n";
+    }
+
+    return identical ? 0 : 1;
+}
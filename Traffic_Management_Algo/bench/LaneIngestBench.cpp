@@ -0,0 +1,104 @@
+/// Measures lane-input publishing from 0..N sensor threads against
+/// TrafficEngine::step() latency on the engine thread. Writers publish whole
+/// snapshots in which every lane carries the same stamp, so a torn read shows
+/// up as lanes with different values after a step.
+///
+/// Usage: tip_lane_ingest_bench [maxWriters=8] [durationMs=1000] [approaches=8]
+
+#include "engine/LaneStateBuffer.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace tip;
+using Clock = std::chrono::steady_clock;
+
+static std::vector<model::Lane> createNWayIntersection(uint16_t numApproaches) {
+    std::vector<model::Lane> lanes;
+    std::size_t id = 0;
+    for (uint16_t a = 0; a < numApproaches; ++a) {
+        model::Direction dir(a, numApproaches);
+        lanes.push_back({id++, dir, model::MovementType::THROUGH,        {}, 0, 0});
+        lanes.push_back({id++, dir, model::MovementType::LEFT_PROTECTED, {}, 0, 0});
+    }
+    return lanes;
+}
+
+static double percentile(std::vector<uint32_t>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    auto nth = samples.begin() + static_cast<std::ptrdiff_t>(p * static_cast<double>(samples.size() - 1));
+    std::nth_element(samples.begin(), nth, samples.end());
+    return *nth;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t maxWriters = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 8;
+    const auto        duration   = std::chrono::milliseconds(argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000);
+    const auto        approaches = static_cast<uint16_t>(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 8);
+
+    std::cout << "Lane input ingestion: " << approaches * 2 << " lanes, "
+              << duration.count() << " ms per run\n";
+
+    for (std::size_t writers = 0;; writers = writers == 0 ? 1 : std::min(writers * 2, maxWriters)) {
+        engine::TrafficEngine engine(createNWayIntersection(approaches), engine::EngineConfig{});
+        auto& inputs = engine.laneInputs();
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (std::size_t w = 0; w < writers; ++w) {
+            threads.emplace_back([&, w] {
+                std::vector<engine::LaneInput> snapshot(inputs.size());
+                for (uint32_t k = 1; !stop.load(std::memory_order_relaxed); ++k) {
+                    const uint32_t stamp = static_cast<uint32_t>(w << 24) | (k & 0xFFFFFF);
+                    for (auto& lane : snapshot) {
+                        lane.queueLength = stamp;
+                        lane.bleBoost    = stamp;
+                    }
+                    inputs.publish(snapshot);
+                }
+            });
+        }
+
+        std::vector<uint32_t> latencies;
+        std::size_t torn = 0;
+        const uint64_t before = inputs.publications();
+        const auto end = Clock::now() + duration;
+        while (Clock::now() < end) {
+            auto begin = Clock::now();
+            (void)engine.step();
+            latencies.push_back(static_cast<uint32_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin).count()));
+
+            const auto& lanes = engine.lanes();
+            for (const auto& lane : lanes) {
+                if (lane.queueLength != lanes.front().queueLength || lane.bleBoost != lane.queueLength) {
+                    ++torn;
+                    break;
+                }
+            }
+        }
+        stop.store(true);
+        for (auto& t : threads) t.join();
+        const double updates = static_cast<double>(inputs.publications() - before);
+        const double seconds = std::chrono::duration<double>(duration).count();
+
+        std::cout << "  writers=" << std::setw(2) << writers
+                  << " | " << std::setw(7) << std::fixed << std::setprecision(2) << updates / seconds / 1e6 << " M updates/s"
+                  << " | step p50=" << std::setw(6) << std::setprecision(0) << percentile(latencies, 0.50) << " ns"
+                  << " p99=" << std::setw(7) << percentile(latencies, 0.99) << " ns"
+                  << " | " << (torn == 0 ? "consistent" : "TORN") << "\n";
+
+        if (torn != 0) return 1;
+        if (writers >= maxWriters) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,187 @@
+/// Measures NetworkCoordinator on a grid district from 1 to N threads and
+/// checks that every partitioned run matches the serial run exactly and
+/// that every departed vehicle is accounted for (exited, handed off,
+/// delivered or still on a link).
+///
+/// Usage: tip_network_bench [rows=32] [cols=32] [ticks=600] [maxThreads=hw]
+
+#include "coordination/NetworkCoordinator.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace tip;
+
+namespace {
+
+    /// Approach a's vehicles head east, south, west, north for a = 0..3;
+    /// lane 2a is its through lane, 2a + 1 its left turn.
+    constexpr int ROW_STEP[4] = {0, 1, 0, -1};
+    constexpr int COL_STEP[4] = {1, 0, -1, 0};
+
+    struct Grid {
+        coordination::NetworkCoordinator network;
+        std::vector<std::shared_ptr<engine::TrafficEngine>> engines;
+        std::vector<std::pair<std::size_t, uint32_t>> entries; ///< (node, lane) with no incoming link
+    };
+
+    std::vector<model::Lane> createFourWayIntersection(std::mt19937& rng) {
+        std::vector<model::Lane> lanes;
+        std::size_t id = 0;
+        for (uint16_t a = 0; a < 4; ++a) {
+            model::Direction dir(a, 4);
+            lanes.push_back({id++, dir, model::MovementType::THROUGH,        {}, static_cast<uint32_t>(rng() % 20)});
+            lanes.push_back({id++, dir, model::MovementType::LEFT_PROTECTED, {}, static_cast<uint32_t>(rng() % 8)});
+        }
+        return lanes;
+    }
+
+    Grid buildGrid(int rows, int cols) {
+        std::mt19937 rng(42);
+        engine::EngineConfig config;
+        Grid grid;
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                grid.engines.push_back(std::make_shared<engine::TrafficEngine>(createFourWayIntersection(rng), config));
+                grid.network.addIntersection(grid.engines.back(), (r * 7 + c * 3) % 30);
+            }
+        }
+
+        std::vector<uint8_t> fed(grid.engines.size() * 8, 0);
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                const auto node = static_cast<std::size_t>(r * cols + c);
+                for (int a = 0; a < 4; ++a) {
+                    // Through keeps the heading, a left turn rotates it
+                    for (int turn = 0; turn < 2; ++turn) {
+                        const int heading = turn == 0 ? a : (a + 3) % 4;
+                        const int nr = r + ROW_STEP[heading];
+                        const int nc = c + COL_STEP[heading];
+                        if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+                        const auto next = static_cast<std::size_t>(nr * cols + nc);
+                        grid.network.addLink(node, static_cast<std::size_t>(2 * a + turn),
+                                             next, static_cast<std::size_t>(2 * heading),
+                                             static_cast<uint32_t>(20 + (r * 7 + c * 3) % 15));
+                        fed[next * 8 + static_cast<std::size_t>(2 * heading)] = 1;
+                    }
+                }
+            }
+        }
+        for (std::size_t i = 0; i < fed.size(); ++i) {
+            if (!fed[i]) grid.entries.emplace_back(i / 8, static_cast<uint32_t>(i % 8));
+        }
+        return grid;
+    }
+
+    /// Deterministic demand on every lane the network does not feed.
+    void inject(Grid& grid, uint32_t t) {
+        for (const auto& [node, lane] : grid.entries) {
+            const uint32_t period = 6 + static_cast<uint32_t>((node + lane) % 20);
+            if ((t + node * 3 + lane) % period == 0) {
+                const engine::LaneDelta delta{lane, 1};
+                grid.engines[node]->applyDeltas({&delta, 1});
+            }
+        }
+    }
+
+    /// Every departure left the network, was handed off, arrived, or is on a link.
+    bool conservesVehicles(const coordination::NetworkStats& stats, uint64_t inTransit) {
+        return stats.departures == stats.exits + stats.handedOff + stats.delivered + inTransit;
+    }
+
+    bool sameDecision(const model::Decision& a, const model::Decision& b) {
+        return a.selectedPhaseIndex == b.selectedPhaseIndex
+            && a.phaseNameId == b.phaseNameId
+            && a.signalState == b.signalState
+            && a.phaseScore == b.phaseScore
+            && a.greenDuration == b.greenDuration;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const int         rows       = argc > 1 ? std::atoi(argv[1]) : 32;
+    const int         cols       = argc > 2 ? std::atoi(argv[2]) : 32;
+    const uint32_t    ticks      = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 600;
+    const std::size_t maxThreads = argc > 4 ? std::strtoull(argv[4], nullptr, 10)
+                                            : std::max(1U, std::thread::hardware_concurrency());
+    if (rows <= 0 || cols <= 0) {
+        std::cerr << "rows and cols must be positive\n";
+        return 2;
+    }
+
+    std::cout << "Network tick scaling: " << rows << "x" << cols << " grid, " << ticks << " ticks\n";
+
+    // Serial reference trace
+    std::vector<model::Decision> reference;
+    coordination::NetworkStats referenceStats;
+    uint64_t referenceInTransit = 0;
+    {
+        auto grid = buildGrid(rows, cols);
+        for (uint32_t t = 0; t < ticks; ++t) {
+            inject(grid, t);
+            grid.network.tick(t);
+            const auto& d = grid.network.lastDecisions();
+            reference.insert(reference.end(), d.begin(), d.end());
+        }
+        referenceStats = grid.network.stats();
+        referenceInTransit = grid.network.inTransit();
+        const bool conserved = conservesVehicles(referenceStats, referenceInTransit);
+        std::cout << "  " << grid.network.linkCount() << " links | departures=" << referenceStats.departures
+                  << " | delivered=" << referenceStats.delivered << " | exits=" << referenceStats.exits
+                  << " | in transit=" << referenceInTransit
+                  << " | " << (conserved ? "conserved" : "VEHICLES LOST") << "\n";
+        if (!conserved) return 1;
+    }
+
+    double baselineNs = 0.0;
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, maxThreads)) {
+        auto grid = buildGrid(rows, cols);
+        grid.network.setThreadCount(threads);
+
+        bool identical = true;
+        std::chrono::nanoseconds elapsed{0};
+        const std::size_t nodes = grid.network.size();
+        for (uint32_t t = 0; t < ticks; ++t) {
+            inject(grid, t);
+            auto start = std::chrono::steady_clock::now();
+            grid.network.tick(t);
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            const auto& d = grid.network.lastDecisions();
+            for (std::size_t i = 0; i < nodes; ++i) {
+                identical = identical && sameDecision(d[i], reference[t * nodes + i]);
+            }
+        }
+        const auto& stats = grid.network.stats();
+        identical = identical && stats.departures == referenceStats.departures
+                              && stats.delivered == referenceStats.delivered
+                              && stats.exits == referenceStats.exits
+                              && stats.queuedVehicleSeconds == referenceStats.queuedVehicleSeconds
+                              && grid.network.inTransit() == referenceInTransit
+                              && conservesVehicles(stats, grid.network.inTransit());
+
+        const double perTickNs = static_cast<double>(elapsed.count()) / ticks;
+        if (threads == 1) baselineNs = perTickNs;
+
+        std::cout << "  threads=" << std::setw(3) << threads
+                  << " | boundary links=" << std::setw(5) << grid.network.boundaryLinkCount()
+                  << " | tick=" << std::setw(9) << std::fixed << std::setprecision(1) << perTickNs / 1000.0 << " us"
+                  << " | " << std::setw(8) << std::setprecision(0) << 1e9 / perTickNs << "x real time"
+                  << " | speedup=" << std::setprecision(2) << baselineNs / perTickNs << "x"
+                  << " | " << (identical ? "identical" : "MISMATCH") << "\n";
+
+        if (!identical) return 1;
+        if (threads >= maxThreads) break;
+    }
+
+    return 0;
+}
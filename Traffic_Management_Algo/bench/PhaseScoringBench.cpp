@@ -0,0 +1,336 @@
+
+/// Checks incremental phase scoring (PhaseScoreIndex) against a full rescore
+/// and measures both on large phase plans.
+///
+///   1. Engine differential: paired engines, one forced incremental and one
+///      forced full, receive the same random updates (bulk, delta, published,
+///      direct lane writes, α/β retuning, emergencies); every decision must
+///      match exactly.
+///   2. Index differential: random overlapping plans, PhaseScoreIndex::best()
+///      against a lane-order rescore of every phase.
+///   3. Timings: selection cycle on wide engines with planned and dynamic
+///      phases, and best() against the full rescore on overlapping plans of
+///      up to 64k phases.
+///
+/// Usage: tip_scoring_bench [selections=2000] [--check]   (--check skips the timings)
+///
+/// Exits with status 1 on any mismatch.
+
+#include "engine/PhaseScoreIndex.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace tip;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+    constexpr uint32_t ALWAYS = 0;
+    constexpr uint32_t NEVER  = UINT32_MAX;
+
+    std::vector<model::Lane> createLanes(uint16_t approaches) {
+        std::vector<model::Lane> lanes;
+        for (uint16_t a = 0; a < approaches; ++a) {
+            model::Direction dir(a, approaches);
+            lanes.push_back({lanes.size(), dir, model::MovementType::THROUGH,        {}});
+            lanes.push_back({lanes.size(), dir, model::MovementType::LEFT_PROTECTED, {}});
+        }
+        return lanes;
+    }
+
+    bool sameDecision(const model::Decision& a, const model::Decision& b) {
+        return a.selectedPhaseIndex == b.selectedPhaseIndex
+            && a.phaseNameId == b.phaseNameId
+            && a.signalState == b.signalState
+            && a.phaseScore == b.phaseScore
+            && a.greenDuration == b.greenDuration
+            && a.activePriority == b.activePriority;
+    }
+
+    engine::EngineConfig fastConfig(bool dynamic, uint32_t minPhases) {
+        engine::EngineConfig config;
+        config.minGreen = config.maxGreen = 0;
+        config.yellowTime = config.allRedTime = 0;
+        config.dynamicPhases = dynamic;
+        config.incrementalScoringMinPhases = minPhases;
+        return config;
+    }
+
+    /// Drive an incremental and a full engine with identical random updates.
+    template <typename Engine>
+    bool engineDifferential(uint16_t approaches, bool dynamic, bool fractional, std::size_t selections) {
+        const auto lanes = createLanes(approaches);
+        // Dynamic mode is switched on after construction: starting in it
+        // would leave the index off
+        Engine incremental(lanes, fastConfig(false, ALWAYS));
+        Engine full(lanes, fastConfig(false, NEVER));
+        incremental.config().dynamicPhases = full.config().dynamicPhases = dynamic;
+        const std::size_t n = lanes.size();
+
+        std::mt19937_64 rng(approaches * 31 + dynamic * 7 + fractional);
+        auto both = [&](auto&& fn) { fn(incremental); fn(full); };
+        auto coin = [&](unsigned oneIn) { return rng() % oneIn == 0; };
+
+        // Integer weights tie often; fractional weights exercise rounding
+        const double alphas[] = {1.0, 0.95, 1.05, 0.5};
+        const double betas[]  = {2.0, 1.9, 2.1};
+
+        bool identical = true;
+        for (std::size_t step = 0; step < selections * 3 && identical; ++step) {
+            if (coin(3)) {
+                std::vector<engine::LaneDelta> deltas(1 + rng() % 4);
+                for (auto& d : deltas) d = {static_cast<uint32_t>(rng() % n), static_cast<int32_t>(rng() % 11) - 4};
+                both([&](Engine& e) { e.applyDeltas(deltas); });
+            }
+            if (coin(40)) {
+                std::vector<uint32_t> queues(n);
+                for (auto& q : queues) q = static_cast<uint32_t>(rng() % 12);
+                both([&](Engine& e) { e.updateQueues(queues); });
+            }
+            if (coin(20)) {
+                const std::size_t lane = rng() % n;
+                const engine::LaneInput input{static_cast<uint32_t>(rng() % 9),
+                                              fractional ? (rng() % 7) * 0.3 : double(rng() % 3),
+                                              model::PriorityReason::NONE};
+                both([&](Engine& e) { e.laneInputs().publish(lane, input); });
+            }
+            if (coin(60)) {
+                const std::size_t lane = rng() % n;
+                const auto wait = static_cast<uint32_t>(rng() % 20);
+                both([&](Engine& e) { e.lanes()[lane].waitCounter = wait; });
+            }
+            if (coin(150)) {
+                const std::size_t lane = rng() % n;
+                const auto reason = coin(2) ? model::PriorityReason::EMERGENCY : model::PriorityReason::NONE;
+                both([&](Engine& e) { e.lanes()[lane].priorityReason = reason; });
+            }
+            if (fractional && coin(200)) {
+                const double alpha = alphas[rng() % 4];
+                const double beta = betas[rng() % 3];
+                both([&](Engine& e) { e.config().alpha = alpha; e.config().beta = beta; });
+            }
+            identical = sameDecision(incremental.step(), full.step());
+        }
+
+        std::cout << "  " << std::setw(5) << n << " lanes"
+                  << (dynamic ? " dynamic" : "        ")
+                  << (fractional ? " fractional" : " integer   ")
+                  << " | " << (identical ? "identical" : "MISMATCH") << "\n";
+        return identical;
+    }
+
+    /// Random overlapping plan: each phase takes a random lane subset.
+    std::vector<std::vector<std::size_t>> randomPlan(std::size_t lanes, std::size_t phases,
+                                                     std::size_t maxSize, std::mt19937_64& rng) {
+        std::vector<std::vector<std::size_t>> plan(phases);
+        for (auto& phase : plan) {
+            const std::size_t size = 1 + rng() % maxSize;
+            for (std::size_t k = 0; k < size; ++k) phase.push_back(rng() % lanes);
+            std::sort(phase.begin(), phase.end());
+            phase.erase(std::unique(phase.begin(), phase.end()), phase.end());
+        }
+        return plan;
+    }
+
+    /// Reference model: lane columns and the full lane-order rescore.
+    struct FullRescore {
+        std::vector<uint32_t> queue, wait;
+        std::vector<double>   boost;
+        std::vector<double>   laneScore;
+
+        explicit FullRescore(std::size_t lanes) : queue(lanes), wait(lanes), boost(lanes), laneScore(lanes) {}
+
+        std::size_t best(const std::vector<std::vector<std::size_t>>& plan, double alpha, double beta) {
+            engine::scoreLanes(queue.data(), wait.data(), boost.data(), queue.size(), alpha, beta, laneScore.data());
+            std::size_t bestIdx = 0;
+            double bestScore = -1.0;
+            for (std::size_t p = 0; p < plan.size(); ++p) {
+                double s = 0.0;
+                for (std::size_t lane : plan[p]) s += laneScore[lane];
+                if (s > bestScore) {
+                    bestScore = s;
+                    bestIdx = p;
+                }
+            }
+            return bestIdx;
+        }
+    };
+
+    /// One selection round on both: a few lane changes, then fairness for
+    /// the chosen phase.
+    struct Workload {
+        std::size_t lanes;
+        std::size_t changesPerRound;
+        bool        fractional;
+
+        template <typename Fn>
+        void changes(std::mt19937_64& rng, Fn&& set) const {
+            for (std::size_t c = 0; c < changesPerRound; ++c) {
+                const std::size_t lane = rng() % lanes;
+                set(lane, static_cast<uint32_t>(rng() % 30), fractional ? (rng() % 5) * 0.7 : double(rng() % 2));
+            }
+        }
+    };
+
+    bool indexDifferential(std::size_t lanes, std::size_t phases, std::size_t maxSize, bool fractional,
+                           std::size_t selections) {
+        std::mt19937_64 rng(lanes * 131 + phases + fractional);
+        const auto plan = randomPlan(lanes, phases, maxSize, rng);
+        engine::PhaseScoreIndex index;
+        index.build(plan, lanes);
+        FullRescore full(lanes);
+        const Workload workload{lanes, 1 + lanes / 16, fractional};
+
+        const double alpha = fractional ? 0.95 : 1.0;
+        const double beta  = fractional ? 2.1 : 2.0;
+        bool identical = true;
+        for (std::size_t round = 0; round < selections && identical; ++round) {
+            workload.changes(rng, [&](std::size_t lane, uint32_t queue, double boost) {
+                full.queue[lane] = queue;
+                full.boost[lane] = boost;
+                index.setLane(lane, queue, full.wait[lane], boost);
+            });
+            const std::size_t expected = full.best(plan, alpha, beta);
+            const std::size_t got = index.best(alpha, beta);
+            identical = got == expected;
+
+            // Fairness for the chosen phase
+            index.nextEpoch();
+            for (auto& w : full.wait) ++w;
+            for (std::size_t lane : plan[expected]) {
+                full.wait[lane] = 0;
+                index.resetWait(lane);
+            }
+        }
+
+        std::cout << "  " << std::setw(5) << lanes << " lanes " << std::setw(6) << phases << " phases"
+                  << (fractional ? " fractional" : " integer   ")
+                  << " | " << (identical ? "identical" : "MISMATCH") << "\n";
+        return identical;
+    }
+
+    template <typename Op>
+    double nsPerOp(std::size_t ops, Op&& op) {
+        const auto start = Clock::now();
+        for (std::size_t i = 0; i < ops; ++i) op();
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(ops);
+    }
+
+    void timeEngine(uint16_t approaches, bool dynamic, std::size_t selections) {
+        const auto lanes = createLanes(approaches);
+        const std::size_t n = lanes.size();
+        double ns[2];
+        for (int mode = 0; mode < 2; ++mode) {
+            engine::DynamicTrafficEngine e(lanes, fastConfig(false, mode == 0 ? NEVER : ALWAYS));
+            e.config().dynamicPhases = dynamic;  // Keep the index on in dynamic mode too
+            std::size_t cycle = 0;
+            // One cycle = three steps, one of which selects; one arrival per step
+            ns[mode] = nsPerOp(selections, [&] {
+                for (int s = 0; s < 3; ++s) {
+                    const engine::LaneDelta arrival{static_cast<uint32_t>((cycle++ * 7919) % n), 1};
+                    e.applyDeltas({&arrival, 1});
+                    auto decision = e.step();
+                    asm volatile("" : : "m"(decision) : "memory");
+                }
+            });
+        }
+        std::cout << "  engine  " << std::setw(5) << n << " lanes " << std::setw(6) << n / 2 << " phases"
+                  << (dynamic ? " dynamic   " : "           ") << "| full " << std::setw(10) << std::fixed << std::setprecision(1) << ns[0] << " ns"
+                  << " | incremental " << std::setw(10) << ns[1] << " ns"
+                  << " | " << std::setprecision(2) << ns[0] / ns[1] << "x\n";
+    }
+
+    void timeIndex(std::size_t lanes, std::size_t phases, std::size_t maxSize, std::size_t selections) {
+        std::mt19937_64 rng(7);
+        const auto plan = randomPlan(lanes, phases, maxSize, rng);
+        const Workload workload{lanes, 4, false};
+        double ns[2];
+
+        FullRescore full(lanes);
+        std::mt19937_64 fullRng(11);
+        ns[0] = nsPerOp(selections, [&] {
+            workload.changes(fullRng, [&](std::size_t lane, uint32_t queue, double boost) {
+                full.queue[lane] = queue;
+                full.boost[lane] = boost;
+            });
+            const std::size_t chosen = full.best(plan, 1.0, 2.0);
+            for (auto& w : full.wait) ++w;
+            for (std::size_t lane : plan[chosen]) full.wait[lane] = 0;
+        });
+
+        engine::PhaseScoreIndex index;
+        index.build(plan, lanes);
+        std::vector<uint32_t> wait(lanes, 0);  // Only read when a lane changes
+        std::mt19937_64 indexRng(11);
+        std::size_t round = 0;
+        std::vector<std::size_t> greenRound(lanes, 0);
+        ns[1] = nsPerOp(selections, [&] {
+            workload.changes(indexRng, [&](std::size_t lane, uint32_t queue, double boost) {
+                index.setLane(lane, queue, static_cast<uint32_t>(round - greenRound[lane]), boost);
+            });
+            const std::size_t chosen = index.best(1.0, 2.0);
+            ++round;
+            index.nextEpoch();
+            for (std::size_t lane : plan[chosen]) {
+                greenRound[lane] = round;
+                index.resetWait(lane);
+            }
+        });
+
+        std::size_t memberships = 0;
+        for (const auto& phase : plan) memberships += phase.size();
+        std::cout << "  index   " << std::setw(5) << lanes << " lanes " << std::setw(6) << phases << " phases"
+                  << " (" << std::setw(4) << memberships / lanes << "/lane)"
+                  << " | full " << std::setw(10) << std::fixed << std::setprecision(1) << ns[0] << " ns"
+                  << " | incremental " << std::setw(10) << ns[1] << " ns"
+                  << " | " << std::setprecision(2) << ns[0] / ns[1] << "x\n";
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t selections = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    const bool checkOnly = argc > 2 && std::string(argv[2]) == "--check";
+    bool ok = true;
+
+    std::cout << "Engine differential (" << selections << " selections each)\n";
+    for (bool fractional : {false, true}) {
+        for (bool dynamic : {false, true}) {
+            ok &= engineDifferential<engine::TrafficEngine>(4, dynamic, fractional, selections);
+            ok &= engineDifferential<engine::TrafficEngine>(32, dynamic, fractional, selections);
+            ok &= engineDifferential<engine::TrafficEngine256>(96, dynamic, fractional, selections);
+        }
+        ok &= engineDifferential<engine::DynamicTrafficEngine>(512, false, fractional, selections);
+    }
+
+    std::cout << "Index differential, overlapping plans\n";
+    for (bool fractional : {false, true}) {
+        ok &= indexDifferential(16, 40, 6, fractional, selections);
+        ok &= indexDifferential(64, 500, 12, fractional, selections);
+        ok &= indexDifferential(256, 4000, 24, fractional, selections);
+    }
+
+    if (checkOnly) return ok ? 0 : 1;
+
+    std::cout << "Selection cost (engine: 3 steps per selection; index: 4 lane changes per selection)\n";
+    for (bool dynamic : {false, true}) {
+        for (uint16_t approaches : {16, 64, 256, 1024}) timeEngine(approaches, dynamic, selections);
+    }
+    // A full rescore costs one pass over every phase membership; the index
+    // costs phases-per-lane tree updates for each changed or green lane. It
+    // only wins when that is a small part of the plan: at 512 lanes even
+    // 16 phases per lane loses, at 4000+ lanes it wins several times over
+    for (std::size_t phases : {1000, 8000, 64000}) timeIndex(512, phases, 16, selections);
+    for (std::size_t phases : {8000, 64000}) timeIndex(phases / 2, phases, 16, selections);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,211 @@
+/// Load test for tip_server: keeps N keep-alive connections each with one
+/// /update in flight (closed loop) against an in-process server, or against
+/// a running tip_server when a port is given. Reports updates per second and
+/// latency percentiles, and fails on any non-200 response.
+///
+/// Usage: tip_server_bench [connections=16] [seconds=5] [intersections=256] [port=in-process]
+
+#include "server/HttpServer.hpp"
+#include "server/TrafficService.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace tip;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+    struct ClientConnection {
+        int               fd = -1;
+        std::size_t       intersection = 0;
+        std::string       in;
+        Clock::time_point sentAt;
+    };
+
+    std::string makeRequest(std::size_t intersection, std::mt19937& rng) {
+        std::string body = "[";
+        for (int lane = 1; lane <= 4; ++lane) {
+            if (lane > 1) body += ',';
+            body += R"({"lane_id":"Lane_)" + std::to_string(lane) + R"(","normal":)" + std::to_string(rng() % 20) +
+                    R"(,"emergency":)" + (rng() % 100 == 0 ? "1" : "0") + "}";
+        }
+        body += "]";
+        return "POST /update?intersection=I-" + std::to_string(intersection) + " HTTP/1.1\r\n"
+               "Host: localhost\r\nContent-Type: application/json\r\nContent-Length: " +
+               std::to_string(body.size()) + "\r\n\r\n" + body;
+    }
+
+    void sendAll(int fd, const std::string& data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            const ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n > 0) sent += static_cast<std::size_t>(n);
+            else if (n < 0 && (errno == EAGAIN || errno == EINTR)) std::this_thread::yield();
+            else throw std::runtime_error(std::string("send: ") + std::strerror(errno));
+        }
+    }
+
+    /// Status of the first complete response in buffer, consuming it; nullopt if incomplete.
+    std::optional<int> takeResponse(std::string& buffer) {
+        const std::size_t headerEnd = buffer.find("\r\n\r\n");
+        if (headerEnd == std::string::npos) return std::nullopt;
+        const std::size_t lengthAt = buffer.find("Content-Length: ");
+        std::size_t length = 0;
+        if (lengthAt < headerEnd) {
+            std::from_chars(buffer.data() + lengthAt + 16, buffer.data() + headerEnd, length);
+        }
+        if (buffer.size() < headerEnd + 4 + length) return std::nullopt;
+        int status = 0;
+        std::from_chars(buffer.data() + 9, buffer.data() + 12, status);
+        buffer.erase(0, headerEnd + 4 + length);
+        return status;
+    }
+
+    double percentile(std::vector<uint32_t>& samples, double p) {
+        if (samples.empty()) return 0.0;
+        auto nth = samples.begin() + static_cast<std::ptrdiff_t>(p * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), nth, samples.end());
+        return *nth;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t connections   = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 16;
+    const double      seconds       = argc > 2 ? std::strtod(argv[2], nullptr) : 5.0;
+    const std::size_t intersections = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 256;
+    const auto        externalPort  = static_cast<uint16_t>(argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 0);
+
+    try {
+        // In-process server unless a port was given
+        std::unique_ptr<server::TrafficService> service;
+        std::unique_ptr<server::HttpServer> httpServer;
+        std::thread serverThread;
+        uint16_t port = externalPort;
+        if (port == 0) {
+            service = std::make_unique<server::TrafficService>();
+            httpServer = std::make_unique<server::HttpServer>(0, [&](auto requests, auto responses) {
+                service->handle(requests, responses);
+            });
+            port = httpServer->port();
+            serverThread = std::thread([&] { httpServer->run(); });
+        }
+
+        std::cout << "tip_server load: " << connections << " connections, " << intersections
+                  << " intersections, " << seconds << " s, port " << port
+                  << (externalPort ? "" : " (in-process)") << "\n";
+
+        const int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        std::vector<ClientConnection> clients(connections);
+        std::vector<std::vector<std::string>> requests(intersections);
+        std::mt19937 rng(42);
+        for (std::size_t i = 0; i < intersections; ++i) {
+            for (int v = 0; v < 16; ++v) requests[i].push_back(makeRequest(i, rng));
+        }
+
+        for (std::size_t c = 0; c < connections; ++c) {
+            auto& client = clients[c];
+            client.fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            if (::connect(client.fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+                throw std::runtime_error(std::string("connect: ") + std::strerror(errno));
+            }
+            const int one = 1;
+            ::setsockopt(client.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            client.intersection = c % intersections;
+
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u64 = c;
+            ::epoll_ctl(epollFd, EPOLL_CTL_ADD, client.fd, &ev);
+        }
+
+        // Warm up for a fifth of the run, then measure
+        const auto start = Clock::now();
+        const auto measureFrom = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds / 5));
+        const auto stopAt = measureFrom + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+
+        std::vector<uint32_t> latencies;
+        latencies.reserve(static_cast<std::size_t>(seconds * 200000));
+        uint64_t errors = 0, counter = 0;
+        for (auto& client : clients) {
+            client.sentAt = Clock::now();
+            sendAll(client.fd, requests[client.intersection][counter++ % 16]);
+        }
+
+        epoll_event events[256];
+        char buffer[65536];
+        while (Clock::now() < stopAt) {
+            const int ready = ::epoll_wait(epollFd, events, 256, 100);
+            for (int e = 0; e < ready; ++e) {
+                auto& client = clients[events[e].data.u64];
+                const ssize_t n = ::recv(client.fd, buffer, sizeof(buffer), 0);
+                if (n <= 0) throw std::runtime_error("server closed a connection");
+                client.in.append(buffer, static_cast<std::size_t>(n));
+
+                while (auto status = takeResponse(client.in)) {
+                    const auto now = Clock::now();
+                    if (*status != 200) ++errors;
+                    if (now >= measureFrom) {
+                        latencies.push_back(static_cast<uint32_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(now - client.sentAt).count()));
+                    }
+                    client.sentAt = now;
+                    sendAll(client.fd, requests[client.intersection][counter++ % 16]);
+                }
+            }
+        }
+        const double elapsed = std::chrono::duration<double>(Clock::now() - measureFrom).count();
+
+        for (auto& client : clients) ::close(client.fd);
+        ::close(epollFd);
+        if (httpServer) {
+            httpServer->stop();
+            serverThread.join();
+        }
+
+        const double rate = static_cast<double>(latencies.size()) / elapsed;
+        std::cout << std::fixed << std::setprecision(0)
+                  << "  updates/s  " << rate << "\n"
+                  << std::setprecision(1)
+                  << "  latency    p50=" << percentile(latencies, 0.50) / 1000.0
+                  << " us  p99=" << percentile(latencies, 0.99) / 1000.0
+                  << " us  p99.9=" << percentile(latencies, 0.999) / 1000.0 << " us\n";
+        if (service) {
+            std::cout << "  engine steps " << service->stepCount() << " for " << counter
+                      << " updates (coalesced batches)\n";
+        }
+        if (errors > 0) {
+            std::cout << "  " << errors << " non-200 responses\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+#!/bin/sh
+# Regenerate bench/baseline.json, the reference tip_bench compares against.
+#
+# Timings only compare on the machine that produced them: run this on the
+# controller-class host used for regression checks, then commit the result.
+# Check a build against it with
+#   <build>/tip_bench --baseline=bench/baseline.json [--threshold=0.10]
+#
+# Usage: bench/update_baseline.sh [build-dir=build-bench]
+set -e
+root=$(cd "$(dirname "$0")/.." && pwd)
+build=${1:-"$root/build-bench"}
+
+# Default options (instrumentation off), optimized, like a deployed build
+cmake -S "$root" -B "$build" -DCMAKE_BUILD_TYPE=Release
+cmake --build "$build" --target tip_bench
+# Longer batches than the default keep run-to-run noise under the threshold
+"$build/tip_bench" --min-time-ms=1000 --out="$root/bench/baseline.json"
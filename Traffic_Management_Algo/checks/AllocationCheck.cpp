@@ -0,0 +1,184 @@
+/// Checks that the steady-state decision paths never touch the heap.
+///
+/// Replaces the global operator new with a counting one, warms each path up
+/// (so dynamic phase slots, scratch buffers and worker pools reach their
+/// final size), then counts allocations over many more steps:
+///
+///   - TrafficEngine::step() with planned and dynamic phases, fed changing queues
+///   - FleetEngine::stepAll()
+///   - CorridorCoordinator::tick() serially and on a worker pool
+///   - EventScheduler::tick() and decision()
+///   - rl::BatchEnvironment::step() serially and on a worker pool, with
+///     planned and dynamic phases and episodes short enough to reset often
+///
+/// Usage: tip_alloc_check
+///
+/// Exits with status 1 if any path allocates after warm-up.
+
+#include "coordination/CorridorCoordinator.hpp"
+#include "coordination/EventScheduler.hpp"
+#include "engine/FleetEngine.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+#include "rl/BatchEnvironment.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    std::atomic<uint64_t> allocations{0};
+
+    void* countedAlloc(std::size_t n, std::size_t align) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        n = n == 0 ? 1 : n;
+        void* p = align <= alignof(std::max_align_t)
+                ? std::malloc(n)
+                : std::aligned_alloc(align, (n + align - 1) / align * align);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+}
+
+void* operator new(std::size_t n) { return countedAlloc(n, alignof(std::max_align_t)); }
+void* operator new[](std::size_t n) { return countedAlloc(n, alignof(std::max_align_t)); }
+void* operator new(std::size_t n, std::align_val_t a) { return countedAlloc(n, static_cast<std::size_t>(a)); }
+void* operator new[](std::size_t n, std::align_val_t a) { return countedAlloc(n, static_cast<std::size_t>(a)); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace tip;
+
+namespace {
+
+    /// N-way intersection with crossing centerlines, so phases really conflict.
+    std::vector<model::Lane> createIntersection(uint16_t approaches) {
+        std::vector<model::Lane> lanes;
+        for (uint16_t a = 0; a < approaches; ++a) {
+            model::Direction dir(a, approaches);
+            const double angle = a * 2.0 * std::numbers::pi / approaches;
+            const double c = std::cos(angle), s = std::sin(angle);
+            const model::Point entry{10.0 * c + s, 10.0 * s - c};
+            const model::Point exit{-10.0 * c + s, -10.0 * s - c};
+            const model::Point leftExit{10.0 * std::cos(angle + 1.77), 10.0 * std::sin(angle + 1.77)};
+            lanes.push_back({lanes.size(), dir, model::MovementType::THROUGH, {entry, exit}});
+            lanes.push_back({lanes.size(), dir, model::MovementType::LEFT_PROTECTED,
+                             {{entry.x * 0.9, entry.y * 0.9}, {0.0, 0.0}, leftExit}});
+        }
+        return lanes;
+    }
+
+    engine::EngineConfig shortCycles(bool dynamic) {
+        engine::EngineConfig config;
+        config.minGreen = 2;
+        config.maxGreen = 6;
+        config.yellowTime = config.allRedTime = 1;
+        config.dynamicPhases = dynamic;
+        return config;
+    }
+
+    bool report(const std::string& path, uint64_t count) {
+        std::cout << "  " << path << std::string(path.size() < 44 ? 44 - path.size() : 0, ' ')
+                  << "| " << count << " allocations\n";
+        return count == 0;
+    }
+
+    /// Drives queues from a fixed buffer so the engine keeps switching phases.
+    uint64_t engineSteps(engine::TrafficEngine& engine, std::mt19937_64& rng, std::size_t steps) {
+        std::vector<uint32_t> queues(engine.lanes().size());
+        const uint64_t before = allocations.load();
+        for (std::size_t s = 0; s < steps; ++s) {
+            for (auto& q : queues) q = static_cast<uint32_t>(rng() % 30);
+            engine.updateQueues(queues);
+            (void)engine.step();
+        }
+        return allocations.load() - before;
+    }
+
+    bool checkEngine(bool dynamic) {
+        engine::TrafficEngine engine(createIntersection(6), shortCycles(dynamic));
+        std::mt19937_64 rng(dynamic ? 11 : 7);
+        (void)engineSteps(engine, rng, 20000);
+        return report(dynamic ? "TrafficEngine::step (dynamic)" : "TrafficEngine::step", engineSteps(engine, rng, 100000));
+    }
+
+    bool checkFleet() {
+        engine::FleetEngine fleet;
+        for (uint16_t i = 0; i < 200; ++i) fleet.addIntersection(createIntersection(3 + i % 4), shortCycles(false));
+        for (int t = 0; t < 100; ++t) fleet.stepAll();
+        const uint64_t before = allocations.load();
+        for (int t = 0; t < 2000; ++t) fleet.stepAll();
+        return report("FleetEngine::stepAll", allocations.load() - before);
+    }
+
+    bool checkCorridor(std::size_t threads) {
+        coordination::CorridorCoordinator corridor;
+        for (uint16_t i = 0; i < 200; ++i) {
+            corridor.addIntersection(std::make_shared<engine::TrafficEngine>(createIntersection(3 + i % 4), shortCycles(false)),
+                                     static_cast<int32_t>(i % 30));
+        }
+        corridor.setThreadCount(threads);
+        for (uint32_t t = 0; t < 100; ++t) corridor.tick(t);
+        const uint64_t before = allocations.load();
+        for (uint32_t t = 100; t < 2100; ++t) corridor.tick(t);
+        return report("CorridorCoordinator::tick (" + std::to_string(corridor.threadCount()) + " threads)",
+                      allocations.load() - before);
+    }
+
+    bool checkScheduler() {
+        coordination::EventScheduler scheduler;
+        for (uint16_t i = 0; i < 200; ++i) {
+            scheduler.addIntersection(std::make_shared<engine::TrafficEngine>(createIntersection(3 + i % 4), shortCycles(false)),
+                                      static_cast<int32_t>(i % 30));
+        }
+        for (int t = 0; t < 20000; ++t) (void)scheduler.tick();
+        const uint64_t before = allocations.load();
+        for (std::size_t t = 0; t < 2000; ++t) {
+            (void)scheduler.tick();
+            (void)scheduler.decision(t % 200);
+        }
+        return report("EventScheduler::tick", allocations.load() - before);
+    }
+
+    bool checkBatch(bool dynamic, std::size_t threads) {
+        rl::BatchConfig batchConfig;
+        batchConfig.episodeTicks = 300;  // Resets every 30 steps
+        batchConfig.threads = threads;
+        rl::BatchEnvironment env(createIntersection(4), shortCycles(dynamic), 64, batchConfig);
+        for (int t = 0; t < 200; ++t) env.step();
+        const uint64_t before = allocations.load();
+        for (int t = 0; t < 2000; ++t) env.step();
+        return report(std::string("BatchEnvironment::step (") + (dynamic ? "dynamic, " : "") +
+                      std::to_string(env.threadCount()) + " threads)", allocations.load() - before);
+    }
+
+}
+
+int main() {
+    std::cout << "Steady-state allocation check\n";
+    bool ok = checkEngine(false);
+    ok &= checkEngine(true);
+    ok &= checkFleet();
+    ok &= checkCorridor(1);
+    ok &= checkCorridor(2);
+    ok &= checkScheduler();
+    for (bool dynamic : {false, true}) {
+        ok &= checkBatch(dynamic, 1);
+        ok &= checkBatch(dynamic, 2);
+    }
+    return ok ? 0 : 1;
+}
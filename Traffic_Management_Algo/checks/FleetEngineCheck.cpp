@@ -0,0 +1,138 @@
+/// Checks FleetEngine::stepAll() against one TrafficEngine per intersection.
+///
+/// Every intersection is built twice from the same lanes and configuration,
+/// once in the fleet and once as its own TrafficEngine. Both receive the same
+/// random queues, BLE boosts, emergencies, wait-counter writes and α/β
+/// retuning, and every decision, signal state and wait counter must match
+/// bit for bit.
+///
+/// Usage: tip_fleet_check [steps=3000]
+///
+/// Exits with status 1 on any mismatch.
+
+#include "engine/FleetEngine.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace tip;
+
+namespace {
+
+    /// N-way intersection; with paths, crossing centerlines conflict.
+    std::vector<model::Lane> createIntersection(uint16_t approaches, bool paths) {
+        std::vector<model::Lane> lanes;
+        for (uint16_t a = 0; a < approaches; ++a) {
+            model::Direction dir(a, approaches);
+            std::vector<model::Point> through, left;
+            if (paths) {
+                const double angle = a * 2.0 * std::numbers::pi / approaches;
+                const double c = std::cos(angle), s = std::sin(angle);
+                through = {{10.0 * c + s, 10.0 * s - c}, {-10.0 * c + s, -10.0 * s - c}};
+                left    = {{9.0 * c + s, 9.0 * s - c}, {0.0, 0.0},
+                           {10.0 * std::cos(angle + 1.77), 10.0 * std::sin(angle + 1.77)}};
+            }
+            lanes.push_back({lanes.size(), dir, model::MovementType::THROUGH,        through});
+            lanes.push_back({lanes.size(), dir, model::MovementType::LEFT_PROTECTED, left});
+        }
+        return lanes;
+    }
+
+    bool sameDecision(const model::Decision& a, const model::Decision& b) {
+        return a.selectedPhaseIndex == b.selectedPhaseIndex
+            && a.phaseNameId == b.phaseNameId
+            && a.signalState == b.signalState
+            && std::bit_cast<uint64_t>(a.phaseScore) == std::bit_cast<uint64_t>(b.phaseScore)
+            && a.greenDuration == b.greenDuration
+            && a.activePriority == b.activePriority;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t steps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 3000;
+
+    std::mt19937_64 rng(23);
+    engine::FleetEngine fleet;
+    std::vector<std::unique_ptr<engine::TrafficEngine>> engines;
+    for (uint16_t i = 0; i < 96; ++i) {
+        engine::EngineConfig config;
+        config.minGreen = 1 + static_cast<uint32_t>(rng() % 6);
+        config.maxGreen = config.minGreen + static_cast<uint32_t>(rng() % 20);
+        config.yellowTime = static_cast<uint32_t>(rng() % 3);
+        config.allRedTime = static_cast<uint32_t>(rng() % 2);
+        config.greenPerVehicle = 0.5 + static_cast<double>(rng() % 4) * 0.75;
+        const auto lanes = createIntersection(static_cast<uint16_t>(3 + i % 6), i % 2 == 0);
+        fleet.addIntersection(lanes, config);
+        engines.push_back(std::make_unique<engine::TrafficEngine>(lanes, config));
+    }
+
+    const double alphas[] = {1.0, 0.95, 1.05, 0.5};
+    const double betas[]  = {2.0, 1.9, 2.1, 0.0};
+    auto coin = [&](unsigned oneIn) { return rng() % oneIn == 0; };
+
+    std::cout << "FleetEngine check: " << fleet.size() << " intersections, " << steps << " steps\n";
+    std::vector<uint32_t> queues;
+    for (std::size_t s = 0; s < steps; ++s) {
+        for (std::size_t i = 0; i < fleet.size(); ++i) {
+            auto& e = *engines[i];
+            const std::size_t n = fleet.laneCount(i);
+            if (coin(3)) {
+                queues.resize(n);
+                for (auto& q : queues) q = static_cast<uint32_t>(rng() % 30);
+                e.updateQueues(queues);
+                std::copy(queues.begin(), queues.end(), fleet.queueLengths(i).begin());
+            }
+            if (coin(10)) {
+                const std::size_t lane = rng() % n;
+                const double boost = static_cast<double>(rng() % 9) * 0.4;
+                e.lanes()[lane].bleBoost = fleet.bleBoosts(i)[lane] = boost;
+            }
+            if (coin(60)) {
+                const std::size_t lane = rng() % n;
+                const auto reason = coin(2) ? model::PriorityReason::EMERGENCY : model::PriorityReason::NONE;
+                e.lanes()[lane].priorityReason = fleet.priorities(i)[lane] = reason;
+            }
+            if (coin(200)) {
+                const std::size_t lane = rng() % n;
+                const auto wait = static_cast<uint32_t>(rng() % 40);
+                e.lanes()[lane].waitCounter = fleet.waitCounters(i)[lane] = wait;
+            }
+            if (coin(300)) {
+                const double alpha = alphas[rng() % 4];
+                const double beta = betas[rng() % 4];
+                e.config().alpha = fleet.config(i).alpha = alpha;
+                e.config().beta = fleet.config(i).beta = beta;
+            }
+        }
+
+        const auto& decisions = fleet.stepAll();
+        for (std::size_t i = 0; i < fleet.size(); ++i) {
+            const auto decision = engines[i]->step();
+            bool same = sameDecision(decisions[i], decision) && fleet.currentSignal(i) == engines[i]->currentSignal();
+            const auto& lanes = std::as_const(*engines[i]).lanes();
+            for (std::size_t l = 0; l < lanes.size() && same; ++l) {
+                same = fleet.waitCounters(i)[l] == lanes[l].waitCounter;
+            }
+            if (!same) {
+                std::cerr << "intersection " << i << " diverges at step " << s << ": fleet "
+                          << decisions[i].summary() << " vs engine " << decision.summary() << "\n";
+                std::cout << "  stepAll vs TrafficEngine::step | MISMATCH\n";
+                return 1;
+            }
+        }
+    }
+    std::cout << "  stepAll vs TrafficEngine::step | identical\n";
+    return 0;
+}
@@ -0,0 +1,182 @@
+/// Stress check for LaneStateBuffer: sensor threads publish while the engine
+/// thread reads, and every snapshot the reader sees must be consistent.
+///
+///   1. Block writers only: each publish(span) writes one generation to every
+///      lane, so after applyTo() all lanes must hold the same generation.
+///   2. Per-lane and block writers mixed: every publication keeps
+///      queueLength == 2 * bleBoost and priority derived from queueLength,
+///      so a torn lane shows up as a broken relation.
+///   3. Writers publish into TrafficEngine::laneInputs() while the main
+///      thread runs step(); the engine's lanes must keep the same relation.
+///
+/// Meant to be run under ThreadSanitizer (configure with -DTIP_TSAN=ON),
+/// which also reports any data race the relations cannot see.
+///
+/// Usage: tip_lane_stress_check [rounds=20000]   (snapshots applied per part)
+///
+/// Exits with status 1 on any inconsistent snapshot.
+
+#include "engine/LaneStateBuffer.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace tip;
+
+namespace {
+
+    constexpr uint16_t APPROACHES = 8;
+    constexpr std::size_t WRITERS = 3;
+
+    std::vector<model::Lane> createLanes() {
+        std::vector<model::Lane> lanes;
+        for (uint16_t a = 0; a < APPROACHES; ++a) {
+            model::Direction dir(a, APPROACHES);
+            lanes.push_back({lanes.size(), dir, model::MovementType::THROUGH,        {}});
+            lanes.push_back({lanes.size(), dir, model::MovementType::LEFT_PROTECTED, {}});
+        }
+        return lanes;
+    }
+
+    /// Input whose fields all follow from value, so a torn copy is detectable.
+    /// Values wrap well below 2^31 so queueLength never overflows.
+    engine::LaneInput inputFor(uint32_t value) {
+        value &= 0xFFFFF;
+        return {value * 2, static_cast<double>(value),
+                value % 3 == 0 ? model::PriorityReason::EMERGENCY : model::PriorityReason::NONE};
+    }
+
+    bool consistent(const model::Lane& lane) {
+        return lane.queueLength == static_cast<uint32_t>(lane.bleBoost) * 2
+            && lane.bleBoost == static_cast<double>(lane.queueLength / 2)
+            && (lane.priorityReason == model::PriorityReason::EMERGENCY) == ((lane.queueLength / 2) % 3 == 0);
+    }
+
+    /// Calls writer(w, v) for v = 1, 2, ... on WRITERS threads until reader()
+    /// returns. Writers yield now and then so the reader gets scheduled
+    /// often even when there are fewer cores than threads.
+    template <typename Writer, typename Reader>
+    void race(Writer writer, Reader reader) {
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (std::size_t w = 0; w < WRITERS; ++w) {
+            threads.emplace_back([&, w] {
+                for (uint32_t v = 1; !stop.load(std::memory_order_relaxed); ++v) {
+                    writer(w, v);
+                    if (v % 64 == 0) std::this_thread::yield();
+                }
+            });
+        }
+        reader();
+        stop.store(true, std::memory_order_relaxed);
+        for (auto& t : threads) t.join();
+    }
+
+    bool checkBlockWrites(std::size_t rounds) {
+        const auto laneCount = static_cast<std::size_t>(APPROACHES) * 2;
+        engine::LaneStateBuffer buffer(laneCount);
+        std::vector<model::Lane> lanes = createLanes();
+        bool ok = true;
+
+        std::vector<std::vector<engine::LaneInput>> blocks(WRITERS, std::vector<engine::LaneInput>(laneCount));
+        race([&](std::size_t w, uint32_t v) {
+            std::fill(blocks[w].begin(), blocks[w].end(), inputFor(v * WRITERS + w));
+            buffer.publish(blocks[w]);
+        }, [&] {
+            for (std::size_t r = 0; r < rounds && ok; ++r) {
+                while (!buffer.applyTo(lanes)) std::this_thread::yield();
+                for (const auto& lane : lanes) {
+                    if (lane.queueLength != lanes.front().queueLength || !consistent(lane)) {
+                        std::cerr << "block publication torn at round " << r << "\n";
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        });
+        return ok;
+    }
+
+    bool checkMixedWrites(std::size_t rounds) {
+        const auto laneCount = static_cast<std::size_t>(APPROACHES) * 2;
+        engine::LaneStateBuffer buffer(laneCount);
+        std::vector<model::Lane> lanes = createLanes();
+        for (auto& lane : lanes) {
+            lane.priorityReason = model::PriorityReason::EMERGENCY;  // Consistent with value 0
+        }
+        bool ok = true;
+
+        std::vector<engine::LaneInput> block(laneCount);
+        race([&](std::size_t w, uint32_t v) {
+            if (w == 0 && v % 16 == 0) {
+                std::fill(block.begin(), block.end(), inputFor(v));
+                buffer.publish(block);
+            } else {
+                buffer.publish((v * 7 + w) % laneCount, inputFor(v));
+            }
+        }, [&] {
+            for (std::size_t r = 0; r < rounds && ok; ++r) {
+                while (!buffer.applyTo(lanes)) std::this_thread::yield();
+                for (std::size_t i : buffer.lastApplied()) {
+                    if (!consistent(lanes[i])) {
+                        std::cerr << "lane " << i << " torn at round " << r << "\n";
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        });
+        return ok;
+    }
+
+    bool checkEngine(std::size_t rounds) {
+        engine::EngineConfig config;
+        config.minGreen = 1;
+        config.maxGreen = 4;
+        config.yellowTime = config.allRedTime = 1;
+        engine::TrafficEngine engine(createLanes(), config);
+        for (auto& lane : engine.lanes()) {
+            lane.priorityReason = model::PriorityReason::EMERGENCY;
+        }
+        auto& inputs = engine.laneInputs();
+        bool ok = true;
+
+        race([&](std::size_t w, uint32_t v) {
+            inputs.publish((v * 5 + w) % inputs.size(), inputFor(v));
+        }, [&] {
+            for (std::size_t r = 0; r < rounds && ok; ++r) {
+                (void)engine.step();
+                for (const auto& lane : std::as_const(engine).lanes()) {
+                    if (!consistent(lane)) {
+                        std::cerr << "engine lane " << lane.id << " torn at step " << r << "\n";
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        });
+        return ok;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+
+    std::cout << "LaneStateBuffer stress check: " << WRITERS << " writers, " << rounds << " reader rounds\n";
+    const bool block = checkBlockWrites(rounds);
+    std::cout << "  block publications    | " << (block ? "consistent" : "TORN") << "\n";
+    const bool mixed = checkMixedWrites(rounds);
+    std::cout << "  mixed publications    | " << (mixed ? "consistent" : "TORN") << "\n";
+    const bool stepping = checkEngine(rounds);
+    std::cout << "  engine step snapshots | " << (stepping ? "consistent" : "TORN") << "\n";
+    return block && mixed && stepping ? 0 : 1;
+}
@@ -0,0 +1,156 @@
+/// Checks every scoring-kernel variant the CPU supports against the scalar
+/// kernel and Lane::score(), bit for bit.
+///
+///   1. Kernel differential: random columns (including queue and wait values
+///      at and above 2^31, where the signed-convert bias matters) of every
+///      length from 0 to 67 at unaligned offsets, under several α/β pairs.
+///   2. Engine differential: the same engine run under each forced ISA must
+///      produce identical decision traces through selectBestPhase().
+///
+/// Usage: tip_scoring_check [cases=2000]
+///
+/// Exits with status 1 on any mismatch.
+
+#include "engine/ScoringKernel.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace tip;
+
+namespace {
+
+    constexpr engine::ScoringIsa ALL_ISAS[] = {
+        engine::ScoringIsa::SCALAR, engine::ScoringIsa::SSE42, engine::ScoringIsa::AVX2,
+    };
+
+    uint32_t drawCount(std::mt19937_64& rng) {
+        switch (rng() % 4) {
+            case 0:  return static_cast<uint32_t>(rng() % 64);
+            case 1:  return static_cast<uint32_t>(rng());                 // Full range
+            case 2:  return 0x80000000U + static_cast<uint32_t>(rng() % 4);  // Around the bias
+            default: return UINT32_MAX - static_cast<uint32_t>(rng() % 4);
+        }
+    }
+
+    bool checkKernels(std::size_t cases) {
+        std::mt19937_64 rng(7);
+        constexpr std::size_t MAX_LEN = 67;
+        constexpr std::size_t PAD = 3;  // Start at offsets 0..3 to hit unaligned loads
+        std::vector<uint32_t> queue(MAX_LEN + PAD), wait(MAX_LEN + PAD);
+        std::vector<double> boost(MAX_LEN + PAD), expected(MAX_LEN + PAD), actual(MAX_LEN + PAD);
+        const double weights[][2] = {{1.0, 2.0}, {0.0, 0.0}, {0.37, 11.5}, {1e-3, 1e6}};
+
+        bool ok = true;
+        for (std::size_t c = 0; c < cases; ++c) {
+            const std::size_t len = c % (MAX_LEN + 1);
+            const std::size_t off = (c / (MAX_LEN + 1)) % (PAD + 1);
+            const auto [alpha, beta] = weights[c % 4];
+            for (std::size_t i = 0; i < MAX_LEN + PAD; ++i) {
+                queue[i] = drawCount(rng);
+                wait[i]  = drawCount(rng);
+                boost[i] = std::uniform_real_distribution<double>(-5.0, 50.0)(rng);
+            }
+            engine::scoreLanes(engine::ScoringIsa::SCALAR, queue.data() + off, wait.data() + off,
+                               boost.data() + off, len, alpha, beta, expected.data());
+            for (std::size_t i = 0; i < len; ++i) {
+                model::Lane lane{i, model::Direction(0, 4), model::MovementType::THROUGH, {},
+                                 queue[off + i], wait[off + i], boost[off + i]};
+                if (std::bit_cast<uint64_t>(lane.score(alpha, beta)) != std::bit_cast<uint64_t>(expected[i])) {
+                    std::cerr << "scalar kernel differs from Lane::score at case " << c << " lane " << i << "\n";
+                    ok = false;
+                }
+            }
+            for (const auto isa : ALL_ISAS) {
+                if (isa > engine::detectScoringIsa()) continue;
+                engine::scoreLanes(isa, queue.data() + off, wait.data() + off, boost.data() + off,
+                                   len, alpha, beta, actual.data());
+                for (std::size_t i = 0; i < len; ++i) {
+                    if (std::bit_cast<uint64_t>(actual[i]) != std::bit_cast<uint64_t>(expected[i])) {
+                        std::cerr << engine::to_string(isa) << " differs at case " << c << " lane " << i
+                                  << ": " << actual[i] << " vs " << expected[i] << "\n";
+                        ok = false;
+                    }
+                }
+            }
+        }
+        return ok;
+    }
+
+    std::vector<model::Lane> createLanes(uint16_t approaches) {
+        std::vector<model::Lane> lanes;
+        for (uint16_t a = 0; a < approaches; ++a) {
+            model::Direction dir(a, approaches);
+            lanes.push_back({lanes.size(), dir, model::MovementType::THROUGH,        {}});
+            lanes.push_back({lanes.size(), dir, model::MovementType::LEFT_PROTECTED, {}});
+        }
+        return lanes;
+    }
+
+    /// Decision trace of an engine driven by seeded random queues and boosts.
+    std::vector<model::Decision> engineTrace(uint16_t approaches, std::size_t steps) {
+        engine::EngineConfig config;
+        config.minGreen = config.maxGreen = 0;
+        config.yellowTime = config.allRedTime = 0;
+        config.beta = 0.75;
+        engine::TrafficEngine engine(createLanes(approaches), config);
+
+        std::mt19937_64 rng(approaches);
+        std::vector<uint32_t> queues(engine.lanes().size());
+        std::vector<model::Decision> trace;
+        trace.reserve(steps);
+        for (std::size_t s = 0; s < steps; ++s) {
+            for (auto& q : queues) q = static_cast<uint32_t>(rng() % 40);
+            engine.updateQueues(queues);
+            engine.lanes()[rng() % queues.size()].bleBoost = static_cast<double>(rng() % 100) / 8.0;
+            trace.push_back(engine.step());
+        }
+        return trace;
+    }
+
+    bool checkEngines(std::size_t steps) {
+        bool ok = true;
+        for (const uint16_t approaches : {3, 4, 8, 16, 32}) {
+            engine::setScoringIsa(engine::ScoringIsa::SCALAR);
+            const auto reference = engineTrace(approaches, steps);
+            for (const auto isa : ALL_ISAS) {
+                if (isa == engine::ScoringIsa::SCALAR || isa > engine::detectScoringIsa()) continue;
+                engine::setScoringIsa(isa);
+                const auto trace = engineTrace(approaches, steps);
+                for (std::size_t s = 0; s < steps; ++s) {
+                    const auto& a = trace[s];
+                    const auto& b = reference[s];
+                    if (a.selectedPhaseIndex != b.selectedPhaseIndex || a.signalState != b.signalState ||
+                        std::bit_cast<uint64_t>(a.phaseScore) != std::bit_cast<uint64_t>(b.phaseScore) ||
+                        a.greenDuration != b.greenDuration) {
+                        std::cerr << engine::to_string(isa) << " engine with " << approaches
+                                  << " approaches diverges at step " << s << "\n";
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+        }
+        engine::setScoringIsa(engine::detectScoringIsa());
+        return ok;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const std::size_t cases = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+
+    std::cout << "Scoring kernel check: detected " << engine::to_string(engine::detectScoringIsa()) << "\n";
+    const bool kernels = checkKernels(cases);
+    std::cout << "  kernels vs scalar and Lane::score | " << cases << " cases | "
+              << (kernels ? "identical" : "MISMATCH") << "\n";
+    const bool engines = checkEngines(cases / 4 + 1);
+    std::cout << "  engine decisions per ISA          | " << (engines ? "identical" : "MISMATCH") << "\n";
+    return kernels && engines ? 0 : 1;
+}
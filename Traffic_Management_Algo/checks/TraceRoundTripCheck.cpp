@@ -0,0 +1,202 @@
+/// Checks that decision traces read back exactly as they were written, and
+/// that corrupt chunk headers are rejected instead of sizing buffers.
+///
+///   1. Round trip: engines of different widths (one in dynamic phase mode)
+///      record every step through TraceWriter in small chunks; TraceReader
+///      must return every record, field for field, and range queries must
+///      return exactly the records inside the range.
+///   2. Corrupt headers: a DECISIONS chunk whose record or lane count cannot
+///      fit its payload must make the reader throw std::runtime_error.
+///
+/// Usage: tip_trace_check [ticks=2000]
+///
+/// Exits with status 1 on any mismatch.
+
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+#include "trace/TraceReader.hpp"
+#include "trace/TraceWriter.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+using namespace tip;
+
+namespace {
+
+    /// N-way intersection with crossing centerlines, so phases really conflict.
+    std::vector<model::Lane> createIntersection(uint16_t approaches) {
+        std::vector<model::Lane> lanes;
+        for (uint16_t a = 0; a < approaches; ++a) {
+            model::Direction dir(a, approaches);
+            const double angle = a * 2.0 * std::numbers::pi / approaches;
+            const double c = std::cos(angle), s = std::sin(angle);
+            const model::Point entry{10.0 * c + s, 10.0 * s - c};
+            const model::Point exit{-10.0 * c + s, -10.0 * s - c};
+            const model::Point leftExit{10.0 * std::cos(angle + 1.77), 10.0 * std::sin(angle + 1.77)};
+            lanes.push_back({lanes.size(), dir, model::MovementType::THROUGH, {entry, exit}});
+            lanes.push_back({lanes.size(), dir, model::MovementType::LEFT_PROTECTED,
+                             {{entry.x * 0.9, entry.y * 0.9}, {0.0, 0.0}, leftExit}});
+        }
+        return lanes;
+    }
+
+    struct Expected {
+        uint64_t                 tick;
+        model::Decision          decision;
+        std::vector<model::Lane> lanes;
+    };
+
+    bool sameRecord(const trace::TraceRecord& got, const Expected& want) {
+        const auto& a = got.decision;
+        const auto& b = want.decision;
+        bool same = got.tick == want.tick
+                 && a.selectedPhaseIndex == b.selectedPhaseIndex
+                 && a.phaseName() == b.phaseName()
+                 && a.signalState == b.signalState
+                 && std::bit_cast<uint64_t>(a.phaseScore) == std::bit_cast<uint64_t>(b.phaseScore)
+                 && a.greenDuration == b.greenDuration
+                 && a.activePriority == b.activePriority
+                 && got.lanes.size() == want.lanes.size();
+        for (std::size_t l = 0; l < got.lanes.size() && same; ++l) {
+            const auto& s = got.lanes[l];
+            const auto& lane = want.lanes[l];
+            same = s.queueLength == lane.queueLength && s.waitCounter == lane.waitCounter
+                && std::bit_cast<uint64_t>(s.bleBoost) == std::bit_cast<uint64_t>(lane.bleBoost)
+                && s.priorityReason == lane.priorityReason;
+        }
+        return same;
+    }
+
+    /// Write a trace of three engines; returns what each engine recorded.
+    std::vector<std::vector<Expected>> writeTrace(const std::string& path, uint64_t ticks) {
+        const uint16_t widths[] = {3, 4, 8};
+        std::vector<std::unique_ptr<engine::TrafficEngine>> engines;
+        for (std::size_t e = 0; e < std::size(widths); ++e) {
+            engine::EngineConfig config;
+            config.minGreen = 2;
+            config.maxGreen = 9;
+            config.yellowTime = config.allRedTime = 1;
+            config.dynamicPhases = e == 2;
+            engines.push_back(std::make_unique<engine::TrafficEngine>(createIntersection(widths[e]), config));
+        }
+
+        std::vector<std::vector<Expected>> expected(engines.size());
+        trace::TraceWriter writer(path, 97);  // Odd chunk size: records straddle chunk ends
+        std::mt19937_64 rng(19);
+        for (uint64_t t = 0; t < ticks; ++t) {
+            for (std::size_t e = 0; e < engines.size(); ++e) {
+                auto& engine = *engines[e];
+                auto& lanes = engine.lanes();
+                for (auto& lane : lanes) {
+                    // Large jumps and wraps exercise the zigzag deltas
+                    lane.queueLength = rng() % 50 == 0 ? static_cast<uint32_t>(rng()) : static_cast<uint32_t>(rng() % 30);
+                    lane.bleBoost = rng() % 7 == 0 ? static_cast<double>(rng() % 100) / 8.0 : 0.0;
+                    lane.priorityReason = rng() % 400 == 0 ? model::PriorityReason::EMERGENCY
+                                                           : model::PriorityReason::NONE;
+                }
+                const auto decision = engine.step();
+                const auto& recorded = std::as_const(engine).lanes();
+                writer.recorder(static_cast<uint32_t>(e), recorded.size()).record(t * 3 + e, decision, recorded);
+                expected[e].push_back({t * 3 + e, decision, recorded});
+            }
+        }
+        writer.flush();
+        return expected;
+    }
+
+    bool checkRoundTrip(const std::string& path, uint64_t ticks) {
+        const auto expected = writeTrace(path, ticks);
+        trace::TraceReader reader(path);
+
+        std::size_t total = 0;
+        for (const auto& records : expected) total += records.size();
+        bool ok = reader.recordCount() == total && reader.firstTick() == expected.front().front().tick
+               && reader.lastTick() == expected.back().back().tick;
+
+        std::vector<std::size_t> next(expected.size(), 0);
+        reader.forEachInRange(0, UINT64_MAX, [&](const trace::TraceRecord& record) {
+            if (!ok) return;
+            auto& n = next[record.engineId];
+            ok = n < expected[record.engineId].size() && sameRecord(record, expected[record.engineId][n]);
+            if (!ok) std::cerr << "engine " << record.engineId << " record " << n << " differs\n";
+            ++n;
+        });
+        for (std::size_t e = 0; e < expected.size(); ++e) ok = ok && next[e] == expected[e].size();
+
+        // A range query returns exactly the records inside it
+        const uint64_t from = ticks, to = ticks * 2;
+        std::size_t inRange = 0;
+        reader.forEachInRange(from, to, [&](const trace::TraceRecord& record) {
+            ok = ok && record.tick >= from && record.tick <= to;
+            ++inRange;
+        });
+        ok = ok && inRange == to - from + 1;
+
+        std::cout << "  round trip  | " << total << " records | " << (ok ? "identical" : "MISMATCH") << "\n";
+        return ok;
+    }
+
+    /// Overwrite the first DECISIONS chunk header's counts and expect rejection.
+    bool checkCorruptHeader(const std::string& path, const std::string& corruptPath,
+                            uint32_t count, uint32_t laneCount) {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        for (std::size_t pos = sizeof(trace::FileHeader); pos + sizeof(trace::ChunkHeader) <= bytes.size();) {
+            trace::ChunkHeader header;
+            std::memcpy(&header, bytes.data() + pos, sizeof(header));
+            if (header.kind == trace::ChunkKind::DECISIONS) {
+                header.count = count;
+                header.laneCount = laneCount;
+                std::memcpy(bytes.data() + pos, &header, sizeof(header));
+                break;
+            }
+            pos += sizeof(header) + header.payloadBytes;
+        }
+        std::ofstream(corruptPath, std::ios::binary).write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+        bool rejected = false;
+        try {
+            trace::TraceReader reader(corruptPath);
+            reader.forEachInRange(0, UINT64_MAX, [](const trace::TraceRecord&) {});
+        } catch (const std::runtime_error&) {
+            rejected = true;
+        }
+        std::cout << "  count=" << count << " laneCount=" << laneCount << " | "
+                  << (rejected ? "rejected" : "ACCEPTED") << "\n";
+        return rejected;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    const uint64_t ticks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000;
+    const auto dir = std::filesystem::temp_directory_path();
+    const std::string stem = "tip_trace_check_" + std::to_string(::getpid());
+    const std::string path = (dir / (stem + ".trace")).string();
+    const std::string corruptPath = (dir / (stem + "_corrupt.trace")).string();
+
+    std::cout << "Trace check: " << ticks << " ticks, 3 engines\n";
+    bool ok = checkRoundTrip(path, ticks);
+    ok &= checkCorruptHeader(path, corruptPath, 0x10000, 0x10000000);
+    ok &= checkCorruptHeader(path, corruptPath, 0xFFFFFFFF, 1);
+    std::filesystem::remove(path);
+    std::filesystem::remove(corruptPath);
+    return ok ? 0 : 1;
+}
@@ -1,12 +1,14 @@
 #pragma once
 #include "BLEEvent.hpp"
 #include "BLERegistry.hpp"
+#include "DeviceTable.hpp"
 #include "../model/Direction.hpp"
+#include "../concurrency/MpscQueue.hpp"
 
 #include <chrono>
-#include <unordered_map>
+#include <memory>
+#include <span>
 #include <vector>
-#include <deque>
 
 namespace tip::ble {
 
@@ -14,9 +16,19 @@ namespace tip::ble {
     struct BLEConfig {
         std::chrono::seconds cooldownWindow{30};   ///< Min time between activations per device
         std::size_t          maxActivationsPerHour = 10; ///< Rate cap per device
+        std::size_t          queueCapacity = 4096;  ///< Events buffered between drainQueue() calls
     };
 
     /// Processes BLE events and computes per-direction boost values.
+    ///
+    /// Device IDs are interned to dense indices. Each device keeps its last
+    /// maxActivationsPerHour activation times in a fixed ring, so cooldown and
+    /// rate checks are O(1) and accepted events allocate nothing after a
+    /// device's first activation.
+    ///
+    /// Receiver threads hand events over with enqueue() (lock-free). Every
+    /// other member is for the engine thread only, which typically calls
+    /// drainQueue() once per cycle.
     class BLEPriorityManager {
     public:
         explicit BLEPriorityManager(BLEConfig config, BLERegistry registry);
@@ -24,6 +36,16 @@ namespace tip::ble {
         /// Process a BLE event. Returns true if the event was accepted.
         bool processEvent(const BLEEvent& event);
 
+        /// Process a batch in timestamp order (ties keep batch order).
+        /// Returns the number of events accepted.
+        std::size_t processEvents(std::span<const BLEEvent> events);
+
+        /// Queue an event from any thread. Returns false if the queue is full.
+        bool enqueue(BLEEvent event);
+
+        /// Process every queued event as one batch. Returns the number accepted.
+        std::size_t drainQueue();
+
         /// Get aggregated BLE boost for a direction.
         [[nodiscard]] double getBoost(const model::Direction& dir) const;
 
@@ -34,20 +56,34 @@ namespace tip::ble {
         BLEConfig  config_;
         BLERegistry registry_;
 
-        /// Per-device: last activation time
-        std::unordered_map<std::string, std::chrono::steady_clock::time_point> lastActivation_;
+        std::unique_ptr<concurrency::MpscQueue<BLEEvent>> queue_;
+        std::vector<BLEEvent>        drained_;    ///< Scratch for drainQueue()
+        std::vector<const BLEEvent*> batchOrder_; ///< Scratch for processEvents()
+
+        /// Per-device activation state, indexed by DeviceIndex
+        struct DeviceState {
+            std::chrono::steady_clock::time_point lastActivation{};
+            uint32_t ringHead  = 0;     ///< Next ring slot to write (oldest entry once full)
+            uint32_t ringCount = 0;     ///< Activations held in the ring
+            bool     activated = false; ///< Has been accepted at least once
+        };
+
+        DeviceTable              devices_;
+        std::vector<DeviceState> deviceState_;
 
-        /// Per-device: activation timestamps within the last hour
-        std::unordered_map<std::string, std::deque<std::chrono::steady_clock::time_point>> activationHistory_;
+        /// Activation rings, maxActivationsPerHour slots per device, back to back.
+        /// Accepted activations of a device are never earlier than its previous
+        /// one (cooldown), so each ring is in time order.
+        std::vector<std::chrono::steady_clock::time_point> activationRing_;
 
         /// Accumulated boost per approach index
-        std::unordered_map<uint16_t, double> directionBoosts_;
+        std::vector<double> directionBoosts_;
 
-        [[nodiscard]] bool checkCooldown(const std::string& deviceId,
+        [[nodiscard]] bool checkCooldown(DeviceIndex device,
                                          std::chrono::steady_clock::time_point now) const;
-        [[nodiscard]] bool checkRateLimit(const std::string& deviceId,
+        [[nodiscard]] bool checkRateLimit(DeviceIndex device,
                                           std::chrono::steady_clock::time_point now) const;
-        void recordActivation(const std::string& deviceId,
+        void recordActivation(DeviceIndex device,
                               std::chrono::steady_clock::time_point now);
     };
 
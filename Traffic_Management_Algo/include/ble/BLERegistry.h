@@ -1,26 +1,54 @@
 #pragma once
+#include "MappedRegistry.hpp"
+
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 
 namespace tip::ble {
 
     /// Maintains a whitelist of authorized BLE device IDs.
+    ///
+    /// Large whitelists come from an immutable MappedRegistry file; authorize()
+    /// and revoke() record changes in a small mutable overlay on top of it.
+    /// Devices are identified by deviceIdHash(), so lookups never allocate.
+    /// Copies share the mapped file.
     class BLERegistry {
     public:
-        void authorize(const std::string& deviceId) {
-            authorized_.insert(deviceId);
+        BLERegistry() = default;
+
+        /// Use base as the authorized set before overlay changes.
+        explicit BLERegistry(std::shared_ptr<const MappedRegistry> base)
+            : base_(std::move(base)) {}
+
+        void authorize(std::string_view deviceId) {
+            const uint64_t hash = deviceIdHash(deviceId);
+            revoked_.erase(hash);
+            if (!base_ || !base_->contains(hash)) {
+                authorized_.insert(hash);
+            }
         }
 
-        void revoke(const std::string& deviceId) {
-            authorized_.erase(deviceId);
+        void revoke(std::string_view deviceId) {
+            const uint64_t hash = deviceIdHash(deviceId);
+            authorized_.erase(hash);
+            if (base_ && base_->contains(hash)) {
+                revoked_.insert(hash);
+            }
         }
 
-        [[nodiscard]] bool isAuthorized(const std::string& deviceId) const {
-            return authorized_.contains(deviceId);
+        [[nodiscard]] bool isAuthorized(std::string_view deviceId) const {
+            const uint64_t hash = deviceIdHash(deviceId);
+            if (authorized_.contains(hash)) return true;
+            return base_ && !revoked_.contains(hash) && base_->contains(hash);
         }
 
     private:
-        std::unordered_set<std::string> authorized_;
+        std::shared_ptr<const MappedRegistry> base_;
+        std::unordered_set<uint64_t>          authorized_; ///< Added on top of base_
+        std::unordered_set<uint64_t>          revoked_;    ///< Removed from base_
     };
 
 }
@@ -0,0 +1,48 @@
+#pragma once
+/// Interns BLE device ID strings to dense integers.
+///
+/// Flat open-addressing table (linear probing, power-of-two capacity, load
+/// factor at most 1/2). Lookups hash the string in place and never allocate;
+/// only the first sighting of a device stores its ID.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tip::ble {
+
+    using DeviceIndex = uint32_t;
+
+    class DeviceTable {
+    public:
+        /// Dense index of deviceId, if it has been interned.
+        [[nodiscard]] std::optional<DeviceIndex> find(std::string_view deviceId) const noexcept;
+
+        /// Dense index of deviceId, adding it on first use. Indices are 0, 1, 2, ...
+        DeviceIndex intern(std::string_view deviceId);
+
+        /// Device ID for an interned index.
+        [[nodiscard]] const std::string& name(DeviceIndex index) const { return names_.at(index); }
+
+        /// Number of interned devices.
+        [[nodiscard]] std::size_t size() const noexcept { return names_.size(); }
+
+    private:
+        struct Slot {
+            uint64_t    hash  = 0;
+            DeviceIndex index = EMPTY;
+        };
+        static constexpr DeviceIndex EMPTY = UINT32_MAX;
+
+        std::vector<Slot>        slots_;
+        std::vector<std::string> names_;
+
+        /// Slot holding deviceId, or the empty slot where it would go.
+        [[nodiscard]] std::size_t probe(std::string_view deviceId, uint64_t hash) const noexcept;
+        void grow();
+    };
+
+}
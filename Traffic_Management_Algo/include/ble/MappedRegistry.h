@@ -0,0 +1,81 @@
+#pragma once
+/// Immutable, memory-mapped whitelist of BLE device IDs.
+///
+/// The file stores 64-bit device ID hashes, never the IDs themselves:
+///   - Header: magic, format version, counts and section offsets
+///   - Blocked Bloom filter: one 64-byte block per lookup, rejects most
+///     unknown devices without touching the table
+///   - Directory: start offset of each bucket of hashes sharing their top
+///     dirBits bits
+///   - Hashes: sorted, unique
+/// open() validates the header and maps the file; nothing is parsed or copied,
+/// so startup cost does not depend on the number of devices. Lookups are
+/// allocation-free and safe from any thread.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tip::ble {
+
+    /// Stable 64-bit hash of a device ID (FNV-1a with a final avalanche mix).
+    /// Stored in registry files, so it must never change for a format version.
+    [[nodiscard]] constexpr uint64_t deviceIdHash(std::string_view deviceId) noexcept {
+        uint64_t h = 0xcbf29ce484222325ULL;
+        for (char c : deviceId) {
+            h ^= static_cast<uint8_t>(c);
+            h *= 0x100000001b3ULL;
+        }
+        h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+        h ^= h >> 31;
+        return h;
+    }
+
+    class MappedRegistry {
+    public:
+        static constexpr uint32_t FORMAT_VERSION = 1;
+
+        /// Write a registry file for deviceIds (duplicates are fine).
+        /// @throws std::runtime_error if the file cannot be written.
+        static void write(const std::string& path, std::span<const std::string> deviceIds);
+
+        /// Write a registry file from precomputed deviceIdHash() values.
+        static void write(const std::string& path, std::vector<uint64_t> hashes);
+
+        /// Map a registry file read-only.
+        /// @throws std::runtime_error if the file is missing, truncated, or of another format.
+        [[nodiscard]] static std::shared_ptr<const MappedRegistry> open(const std::string& path);
+
+        ~MappedRegistry();
+        MappedRegistry(const MappedRegistry&) = delete;
+        MappedRegistry& operator=(const MappedRegistry&) = delete;
+
+        /// Whether the file lists a device with this deviceIdHash().
+        [[nodiscard]] bool contains(uint64_t hash) const noexcept;
+
+        [[nodiscard]] bool contains(std::string_view deviceId) const noexcept {
+            return contains(deviceIdHash(deviceId));
+        }
+
+        /// Number of distinct devices in the file.
+        [[nodiscard]] std::size_t size() const noexcept { return hashes_.size(); }
+
+    private:
+        MappedRegistry() = default;
+
+        void*                     mapping_ = nullptr;
+        std::size_t               mappingSize_ = 0;
+        std::span<const uint64_t> bloom_;     ///< 8 words per block
+        std::span<const uint32_t> directory_; ///< 2^dirBits + 1 bucket offsets
+        std::span<const uint64_t> hashes_;
+        uint32_t                  dirBits_ = 0;
+
+        [[nodiscard]] bool mayContain(uint64_t hash) const noexcept;
+    };
+
+}
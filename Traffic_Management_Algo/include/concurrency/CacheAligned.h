@@ -0,0 +1,32 @@
+#pragma once
+/// Cache-line constants and allocation helpers shared by the concurrency primitives.
+
+#include <cstddef>
+#include <new>
+
+namespace tip::concurrency {
+
+    /// Cache line size used for padding shared state.
+    inline constexpr std::size_t CACHE_LINE = 64;
+
+    /// Allocator that places the first element on a cache-line boundary.
+    template <typename T>
+    struct CacheAlignedAllocator {
+        using value_type = T;
+
+        CacheAlignedAllocator() noexcept = default;
+        template <typename U>
+        CacheAlignedAllocator(const CacheAlignedAllocator<U>&) noexcept {}
+
+        [[nodiscard]] T* allocate(std::size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{CACHE_LINE}));
+        }
+        void deallocate(T* p, std::size_t) noexcept {
+            ::operator delete(p, std::align_val_t{CACHE_LINE});
+        }
+
+        template <typename U>
+        bool operator==(const CacheAlignedAllocator<U>&) const noexcept { return true; }
+    };
+
+}
@@ -0,0 +1,109 @@
+#pragma once
+/// Bounded lock-free multi-producer / single-consumer queue.
+///
+/// Ring of cells, each with a sequence number (Vyukov's bounded queue):
+///   - Producers claim a slot with one CAS on the tail, write the value, then
+///     publish it by bumping the cell's sequence
+///   - The single consumer reads cells in order and hands them back by
+///     advancing their sequence one lap ahead
+/// Producers never block each other beyond the CAS and never wait on the
+/// consumer; a full queue makes tryPush() fail instead.
+
+#include "CacheAligned.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace tip::concurrency {
+
+    template <typename T>
+    class MpscQueue {
+    public:
+        /// Create a queue holding at least capacity elements (rounded up to a power of two).
+        /// @throws std::invalid_argument if capacity is zero.
+        explicit MpscQueue(std::size_t capacity)
+            : mask_(std::bit_ceil(capacity) - 1)
+            , cells_(std::make_unique<Cell[]>(mask_ + 1))
+        {
+            if (capacity == 0) {
+                throw std::invalid_argument("MpscQueue: capacity must be positive");
+            }
+            for (std::size_t i = 0; i <= mask_; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /// Number of elements the queue can hold.
+        [[nodiscard]] std::size_t capacity() const noexcept { return mask_ + 1; }
+
+        /// Enqueue from any thread. Returns false (leaving value intact) if full.
+        bool tryPush(T&& value) {
+            std::size_t pos;
+            Cell* cell = claim(pos);
+            if (!cell) return false;
+            cell->value = std::move(value);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool tryPush(const T& value) {
+            T copy(value);
+            return tryPush(std::move(copy));
+        }
+
+        /// Consumer only: move up to maxCount published elements into out.
+        /// Returns the number appended.
+        std::size_t drain(std::vector<T>& out, std::size_t maxCount = SIZE_MAX) {
+            std::size_t count = 0;
+            while (count < maxCount) {
+                Cell& cell = cells_[head_ & mask_];
+                if (cell.sequence.load(std::memory_order_acquire) != head_ + 1) break;
+                out.push_back(std::move(cell.value));
+                cell.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+                ++head_;
+                ++count;
+            }
+            return count;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence{0};
+            T                        value{};
+        };
+
+        const std::size_t       mask_;
+        std::unique_ptr<Cell[]> cells_;
+
+        alignas(CACHE_LINE) std::atomic<std::size_t> tail_{0}; ///< Next position to claim (producers)
+        alignas(CACHE_LINE) std::size_t              head_ = 0; ///< Next position to read (consumer)
+
+        /// Claim the cell for the next tail position, or nullptr if the queue is full.
+        Cell* claim(std::size_t& pos) noexcept {
+            pos = tail_.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells_[pos & mask_];
+                const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        return &cell;
+                    }
+                } else if (diff < 0) {
+                    return nullptr; // Consumer has not freed this cell yet
+                } else {
+                    pos = tail_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+    };
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+/// Fixed-size fork/join pool with per-worker work stealing.
+///
+/// parallelFor() splits an index range into chunks and deals them out as one
+/// contiguous block per worker. Each worker pops chunks from the front of its
+/// own block and, once empty, steals single chunks from the back of others.
+/// Each block is a packed (begin, end) pair in one atomic word, so both pop
+/// and steal are a single CAS with no locks on the hot path.
+///
+/// The calling thread participates as worker 0 and parallelFor() returns only
+/// after every chunk has run, so callers can treat it like a plain loop.
+
+#include "CacheAligned.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace tip::concurrency {
+
+    /// Work-stealing pool for data-parallel loops.
+    class WorkStealingPool {
+    public:
+        /// Body invoked for each chunk as [begin, end).
+        using RangeFn = std::function<void(std::size_t begin, std::size_t end)>;
+
+        /// Create a pool with threadCount workers (including the caller).
+        /// A count of 0 selects std::thread::hardware_concurrency().
+        explicit WorkStealingPool(std::size_t threadCount);
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        /// Run fn over [0, count) in chunks of `grain` indices; blocks until done.
+        /// Chunk boundaries are always multiples of grain.
+        /// Rethrows the first exception raised by any chunk.
+        void parallelFor(std::size_t count, std::size_t grain, const RangeFn& fn);
+
+        /// Number of workers, including the calling thread.
+        [[nodiscard]] std::size_t threadCount() const noexcept { return blocks_.size(); }
+
+    private:
+        /// One worker's remaining chunks, packed as (begin << 32) | end.
+        struct alignas(CACHE_LINE) Block {
+            std::atomic<uint64_t> range{0};
+        };
+
+        std::vector<Block>       blocks_;
+        std::vector<std::thread> threads_;
+
+        std::mutex              mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        uint64_t                generation_ = 0;    ///< Bumped once per parallelFor
+        std::size_t             busy_       = 0;    ///< Workers still in the current job
+        bool                    stopping_   = false;
+
+        // Current job (valid while busy_ > 0)
+        const RangeFn*     fn_         = nullptr;
+        std::size_t        count_      = 0;
+        std::size_t        grain_      = 1;
+        std::exception_ptr error_;
+
+        void workerLoop(std::size_t self);
+        void runChunks(std::size_t self);
+        [[nodiscard]] bool popOwn(std::size_t self, uint32_t& chunk) noexcept;
+        [[nodiscard]] bool steal(std::size_t self, uint32_t& chunk) noexcept;
+    };
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "../engine/TrafficEngine.hpp"
+#include "../concurrency/WorkStealingPool.hpp"
 
 #include <vector>
 #include <memory>
@@ -13,28 +14,59 @@ namespace tip::coordination {
         int32_t offsetSeconds = 0; ///< Offset from corridor master clock (seconds)
     };
 
+    /// Decision storage for a corridor. Cache-line aligned so parallel ticks
+    /// can hand out line-aligned chunks without false sharing.
+    using DecisionBuffer = std::vector<model::Decision, concurrency::CacheAlignedAllocator<model::Decision>>;
+
     /// Coordinates multiple intersections along a corridor
     /// using offset-based green wave synchronization.
     class CorridorCoordinator {
     public:
+        /// Set the number of threads used by tick(). 1 (default) ticks serially
+        /// on the caller's thread; 0 selects std::thread::hardware_concurrency().
+        /// Parallel ticks require every intersection to own a distinct engine.
+        void setThreadCount(std::size_t threads);
+
+        /// Number of threads used by tick().
+        [[nodiscard]] std::size_t threadCount() const noexcept {
+            return pool_ ? pool_->threadCount() : 1;
+        }
+
         /// Add an intersection to the corridor with its offset.
         void addIntersection(std::shared_ptr<engine::TrafficEngine> engine,
                              int32_t offsetSeconds);
 
         /// Run one global tick. Each intersection steps if its offset aligns.
+        /// Results are identical in serial and parallel mode.
         void tick(uint32_t globalTime);
 
         /// Get all decisions from the latest tick.
-        [[nodiscard]] const std::vector<model::Decision>& lastDecisions() const noexcept {
+        [[nodiscard]] const DecisionBuffer& lastDecisions() const noexcept {
             return decisions_;
         }
 
         /// Number of intersections.
         [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
 
+        /// Intersection i in insertion order.
+        /// @throws std::out_of_range if i >= size().
+        [[nodiscard]] const IntersectionEntry& intersection(std::size_t i) const {
+            return entries_.at(i);
+        }
+
+        /// Change intersection i's offset; takes effect from the next tick.
+        /// @throws std::out_of_range if i >= size().
+        void setOffset(std::size_t i, int32_t offsetSeconds) {
+            entries_.at(i).offsetSeconds = offsetSeconds;
+        }
+
     private:
         std::vector<IntersectionEntry> entries_;
-        std::vector<model::Decision>   decisions_;
+        DecisionBuffer                 decisions_;
+        std::unique_ptr<concurrency::WorkStealingPool> pool_; ///< Null in serial mode
+
+        /// Step intersections [begin, end) into decisions_.
+        void tickRange(uint32_t globalTime, std::size_t begin, std::size_t end);
     };
 
 }
@@ -0,0 +1,60 @@
+#pragma once
+/// Event-driven alternative to CorridorCoordinator::tick().
+///
+/// Engines spend most ticks counting down a signal state. Instead of stepping
+/// every engine every second, each engine is filed in a TimingWheel at the
+/// tick of its next state change and only stepped then; the countdown ticks
+/// in between are skipped with TrafficEngine::advance(). Per-tick cost scales
+/// with the number of state changes, not with the number of intersections.
+///
+/// Decisions are identical to ticking a CorridorCoordinator with the same
+/// engines and offsets.
+
+#include "TimingWheel.hpp"
+#include "../engine/TrafficEngine.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace tip::coordination {
+
+    class EventScheduler {
+    public:
+        /// Add an intersection that starts stepping at global tick offsetSeconds
+        /// (or at the next processed tick if that has already passed).
+        void addIntersection(std::shared_ptr<engine::TrafficEngine> engine,
+                             int32_t offsetSeconds);
+
+        /// Next global tick tick() will process.
+        [[nodiscard]] uint32_t now() const noexcept { return static_cast<uint32_t>(wheel_.now()); }
+
+        /// Process global tick now(). Returns the intersections whose engine
+        /// changed state on it, in ascending order.
+        std::span<const std::size_t> tick();
+
+        /// Decision intersection i reported on the last processed tick,
+        /// as CorridorCoordinator::lastDecisions()[i] would hold it.
+        /// Brings the engine's countdown up to date.
+        [[nodiscard]] model::Decision decision(std::size_t i);
+
+        /// Number of intersections.
+        [[nodiscard]] std::size_t size() const noexcept { return entries_.size(); }
+
+    private:
+        struct Entry {
+            std::shared_ptr<engine::TrafficEngine> engine;
+            bool            active       = false; ///< Has stepped at least once
+            uint32_t        syncedTo     = 0;     ///< Last tick the engine state reflects
+            uint32_t        transitionAt = 0;     ///< Tick of the latest state change
+            model::Decision transition;           ///< Decision returned at transitionAt
+        };
+
+        std::vector<Entry>       entries_;
+        TimingWheel              wheel_;
+        std::vector<uint32_t>    due_;
+        std::vector<std::size_t> changed_;
+    };
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+/// Searches CorridorCoordinator offsets that let arterial platoons progress.
+///
+/// A candidate offset vector is scored by simulating the corridor on fresh
+/// copies of its engines (same lanes and configuration):
+///   - Arterial traffic enters at either end with the given directional
+///     demand, crosses each link after its travel time and, on arrival,
+///     passes a green lane with an empty queue or stops and queues
+///   - Every other lane receives side-street demand
+///   - Green lanes discharge at saturation flow, as in sim::Simulator
+/// Arrivals are fluid (fractional credit), so a score is deterministic.
+/// The objective counts stops and rewards arterial vehicles that reach the
+/// far end, so progression along the arterial is scored directly rather
+/// than only through the stops it avoids.
+///
+/// Offsets delay each engine's start (CorridorCoordinator holds ALL_RED
+/// until then) and are never negative. The search starts from the better of
+/// all-zero offsets and the ideal one-way wave (cumulative travel time in
+/// the heavier direction), then runs coordinate descent over the offset
+/// differences between neighbours: for each intersection in turn, shifts
+/// of it and every intersection downstream of it (in the heavier
+/// direction) by up to searchRadius are scored in parallel and the best is
+/// kept. Sweeps repeat until one makes no improvement. The result is the
+/// same for any thread count.
+
+#include "CorridorCoordinator.hpp"
+#include "../concurrency/WorkStealingPool.hpp"
+#include "../engine/EngineConfig.hpp"
+#include "../model/Lane.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace tip::coordination {
+
+    /// Lanes of one intersection that carry the arterial.
+    struct ArterialLanes {
+        std::size_t forward;  ///< Lane fed by intersection i-1 (traffic towards higher indices)
+        std::size_t reverse;  ///< Lane fed by intersection i+1
+    };
+
+    /// The corridor as seen by the optimizer. Intersection i connects to
+    /// i+1 by a link travelled in linkTravelSeconds[i] both ways.
+    struct GreenWaveProblem {
+        std::vector<uint32_t>      linkTravelSeconds; ///< One per link, size() - 1 entries
+        std::vector<ArterialLanes> arterial;          ///< One per intersection
+        double forwardDemand = 0.10;  ///< Vehicles/s entering at intersection 0
+        double reverseDemand = 0.06;  ///< Vehicles/s entering at the last intersection
+        double sideDemand    = 0.02;  ///< Vehicles/s on every non-arterial lane
+    };
+
+    struct GreenWaveConfig {
+        uint32_t horizonSeconds = 0;    ///< Simulated seconds per evaluation; 0 = derived from the corridor
+        uint32_t offsetStep     = 4;    ///< Candidate offset resolution (seconds)
+        uint32_t searchRadius   = 32;   ///< Largest shift tried per move, either way (seconds)
+        uint32_t maxSweeps      = 3;    ///< Coordinate-descent passes at most
+        double   saturationFlow = 0.5;  ///< Departures per green second per lane
+        double   delayWeight    = 0.0;  ///< Objective weight per vehicle-second queued
+        double   progressionWeight = 50.0; ///< Objective reward per arterial vehicle reaching the far end
+        std::size_t threads     = 0;    ///< Evaluation threads; 0 = hardware threads
+    };
+
+    /// Score of one offset vector over the horizon.
+    struct GreenWaveScore {
+        uint64_t stops           = 0;  ///< Vehicles that had to queue, summed over intersections
+        uint64_t arterialStops   = 0;  ///< Of which on arterial lanes
+        uint64_t arterialThrough = 0;  ///< Arterial vehicles that reached the far end
+        uint64_t queuedVehicleSeconds = 0;
+        /// stops + delayWeight · queuedVehicleSeconds - progressionWeight · arterialThrough
+        double   objective       = 0.0;
+    };
+
+    struct GreenWaveResult {
+        std::vector<int32_t> offsets;
+        GreenWaveScore       score;
+        GreenWaveScore       zeroOffsets;   ///< All intersections start together
+        GreenWaveScore       idealWave;     ///< Cumulative travel time, heavier direction
+        std::size_t          evaluations = 0;
+        uint32_t             sweeps      = 0;
+    };
+
+    class GreenWaveOptimizer {
+    public:
+        /// Capture the corridor's engines (lanes and configuration).
+        /// @throws std::invalid_argument if the problem does not match the corridor.
+        GreenWaveOptimizer(const CorridorCoordinator& corridor, GreenWaveProblem problem,
+                           GreenWaveConfig config = {});
+
+        /// Score one offset vector. Safe to call from several threads.
+        /// @throws std::invalid_argument if offsets.size() differs from the corridor size.
+        [[nodiscard]] GreenWaveScore evaluate(const std::vector<int32_t>& offsets) const;
+
+        /// Run the search.
+        [[nodiscard]] GreenWaveResult optimize();
+
+        /// Simulated seconds per evaluation: the configured horizon, or when
+        /// that is 0, long enough for a platoon to cross the corridor.
+        [[nodiscard]] uint32_t horizonSeconds() const noexcept { return config_.horizonSeconds; }
+
+        /// Write offsets into the corridor.
+        static void apply(CorridorCoordinator& corridor, const GreenWaveResult& result);
+
+    private:
+        GreenWaveProblem problem_;
+        GreenWaveConfig  config_;
+        std::vector<std::vector<model::Lane>> lanes_;
+        std::vector<engine::EngineConfig>     engineConfigs_;
+        std::unique_ptr<concurrency::WorkStealingPool> pool_; ///< Null when single-threaded
+
+        [[nodiscard]] std::vector<int32_t> idealWaveOffsets() const;
+    };
+
+}
@@ -0,0 +1,190 @@
+#pragma once
+/// Road network of engines connected by links with travel-time delay.
+///
+/// Intersections are graph nodes; a link carries vehicles discharged from
+/// one lane of an intersection to a lane of another after its travel time.
+/// Each tick, for every intersection:
+///   1. Vehicles whose link delay has elapsed join the downstream lane
+///   2. The engine steps (ALL_RED hold before its offset, as in
+///      CorridorCoordinator)
+///   3. Lanes of a GREEN phase discharge at saturation flow onto their
+///      outgoing link or port, or leave the network if the lane has neither
+///
+/// A port is a link whose far end lies in another network (e.g. another
+/// process's shard); vehicles released onto it are reported by portFlows()
+/// and delivered by the caller.
+///
+/// The graph is split into one partition per thread (contiguous blocks of a
+/// breadth-first order, so neighbours mostly share a partition). Links inside
+/// a partition are written directly; vehicles on boundary links are queued
+/// per partition and handed over after the tick. Every link is at least one
+/// second long, so nothing crosses a partition within a tick and results are
+/// identical for any thread count.
+
+#include "CorridorCoordinator.hpp"
+#include "../engine/EngineState.hpp"
+#include "../engine/LaneDelta.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tip::coordination {
+
+    struct NetworkConfig {
+        double saturationFlow = 0.5;  ///< Departures per green second per lane
+    };
+
+    /// Cumulative counters over all ticks.
+    struct NetworkStats {
+        uint64_t ticks      = 0;
+        uint64_t departures = 0;   ///< Vehicles discharged on green
+        uint64_t exits      = 0;   ///< Of which on lanes without an outgoing link or port
+        uint64_t handedOff  = 0;   ///< Of which onto ports
+        uint64_t delivered  = 0;   ///< Vehicles that reached the end of a link
+        uint64_t queuedVehicleSeconds = 0; ///< Sum of all queues over all ticks
+    };
+
+    /// Restorable state of a NetworkCoordinator (see saveState()).
+    struct NetworkState {
+        std::vector<engine::EngineState> engines;   ///< Per node
+        std::vector<uint32_t>            inTransit; ///< Delay lines in link order, travelSeconds + 1 slots each
+        std::vector<double>              credit;    ///< Discharge credit per lane, nodes in order
+        NetworkStats                     stats;
+    };
+
+    class NetworkCoordinator {
+    public:
+        /// @throws std::invalid_argument if saturationFlow is negative.
+        explicit NetworkCoordinator(NetworkConfig config = {});
+
+        /// Add an intersection; returns its node index.
+        std::size_t addIntersection(std::shared_ptr<engine::TrafficEngine> engine,
+                                    int32_t offsetSeconds);
+
+        /// Connect fromLane of fromNode to toLane of toNode; returns the link index.
+        /// A lane has at most one outgoing link.
+        /// @throws std::out_of_range if a node or lane does not exist.
+        /// @throws std::invalid_argument if travelSeconds is 0 or fromLane is already linked.
+        std::size_t addLink(std::size_t fromNode, std::size_t fromLane,
+                            std::size_t toNode, std::size_t toLane,
+                            uint32_t travelSeconds);
+
+        /// Mark fromLane of fromNode as leaving this network; returns the port
+        /// index. Shares the one-outgoing-connection limit with addLink().
+        /// @throws std::out_of_range if the node or lane does not exist.
+        /// @throws std::invalid_argument if fromLane is already linked.
+        std::size_t addPort(std::size_t fromNode, std::size_t fromLane);
+
+        /// Vehicles released onto each port during the latest tick.
+        [[nodiscard]] std::span<const uint32_t> portFlows() const noexcept { return portFlows_; }
+
+        /// Set the number of threads (and partitions) used by tick(). 1 (default)
+        /// ticks serially; 0 selects std::thread::hardware_concurrency().
+        void setThreadCount(std::size_t threads);
+
+        [[nodiscard]] std::size_t threadCount() const noexcept {
+            return pool_ ? pool_->threadCount() : 1;
+        }
+
+        /// Run one global tick. Delay lines advance one second per call.
+        void tick(uint32_t globalTime);
+
+        /// Decisions from the latest tick, one per node.
+        [[nodiscard]] const DecisionBuffer& lastDecisions() const noexcept { return decisions_; }
+
+        [[nodiscard]] const NetworkStats& stats() const noexcept { return stats_; }
+
+        /// Vehicles currently travelling on link (or on every link).
+        /// @throws std::out_of_range if link does not exist.
+        [[nodiscard]] uint64_t inTransit(std::size_t link) const;
+        [[nodiscard]] uint64_t inTransit() const;
+
+        /// Copy the running state (engines, vehicles in transit, counters) into
+        /// state, reusing its storage.
+        void saveState(NetworkState& state) const;
+
+        /// Resume from a state saved by a network with the same topology.
+        /// @throws std::invalid_argument if the state does not fit this network.
+        void restoreState(const NetworkState& state);
+
+        /// Links whose ends lie in different partitions (after the first tick
+        /// since the last topology or thread-count change).
+        [[nodiscard]] std::size_t boundaryLinkCount() const noexcept { return boundaryLinks_; }
+
+        [[nodiscard]] std::size_t size() const noexcept { return nodes_.size(); }
+        [[nodiscard]] std::size_t linkCount() const noexcept { return links_.size(); }
+
+    private:
+        static constexpr uint32_t NO_LINK  = UINT32_MAX;
+        static constexpr uint32_t PORT_BIT = 1U << 31;  ///< outLink_ entry names a port
+
+        struct Node {
+            std::shared_ptr<engine::TrafficEngine> engine;
+            int32_t     offsetSeconds = 0;
+            std::size_t laneBase      = 0;  ///< First entry in outLink_
+        };
+
+        struct Link {
+            std::size_t fromNode, fromLane, toNode, toLane;
+            uint32_t    travelSeconds;
+            bool        placed     = false; ///< Delay line allocated by buildLayout()
+            uint32_t    partition  = 0;     ///< Owner of the delay line (the downstream partition)
+            std::size_t ringOffset = 0;     ///< First slot in that partition's rings
+        };
+
+        /// One thread's share of the network. Allocated separately so
+        /// partitions never share cache lines.
+        struct Partition {
+            uint32_t              index = 0;
+            std::vector<uint32_t> nodes;
+            std::vector<std::size_t> creditBase;  ///< Per node, into credit
+            std::vector<double>   credit;         ///< Discharge credit per lane
+            std::vector<uint32_t> rings;          ///< Delay lines of incoming links, travelSeconds + 1 slots each
+            std::vector<engine::LaneDelta> deltas;
+            std::vector<std::pair<uint32_t, uint32_t>> outbox; ///< (link, vehicles) for boundary links
+            std::vector<std::pair<uint32_t, uint32_t>> ported; ///< (port, vehicles)
+            NetworkStats stats;
+        };
+
+        NetworkConfig     config_;
+        std::vector<Node> nodes_;
+        std::vector<Link> links_;
+        std::vector<uint32_t> outLink_;   ///< Per node lane: outgoing link, PORT_BIT | port, or NO_LINK
+        std::vector<uint32_t> portFlows_; ///< Per port
+        std::vector<uint32_t> inStart_;   ///< CSR node → incoming links
+        std::vector<uint32_t> inLinks_;
+        std::vector<std::unique_ptr<Partition>> partitions_;
+        std::size_t       boundaryLinks_ = 0;
+        bool              layoutValid_ = false;
+        DecisionBuffer    decisions_;
+        NetworkStats      stats_;
+        std::unique_ptr<concurrency::WorkStealingPool> pool_; ///< Null in serial mode
+
+        /// Split nodes into partitions and lay out delay lines, keeping
+        /// vehicles already in transit.
+        void buildLayout();
+
+        void tickPartition(Partition& part, uint32_t globalTime);
+
+        /// outLink_ entry for fromLane of fromNode, checked to be free.
+        [[nodiscard]] uint32_t& freeOutLink(std::size_t fromNode, std::size_t fromLane);
+
+        /// Put vehicles released at the current tick on link.
+        void enqueue(const Link& link, uint32_t vehicles) noexcept {
+            const std::size_t slots = std::size_t{link.travelSeconds} + 1;
+            ring(link)[(stats_.ticks + link.travelSeconds) % slots] += vehicles;
+        }
+
+        [[nodiscard]] uint32_t* ring(const Link& link) noexcept {
+            return partitions_[link.partition]->rings.data() + link.ringOffset;
+        }
+        [[nodiscard]] const uint32_t* ring(const Link& link) const noexcept {
+            return partitions_[link.partition]->rings.data() + link.ringOffset;
+        }
+    };
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+/// Hierarchical timing wheel keyed by absolute tick.
+///
+/// LEVELS wheels of SLOTS slots each. An id due at tick t is filed on the
+/// level of the highest SLOT_BITS-bit digit in which t differs from now(),
+/// in the slot given by that digit of t. When the lower digits of now() roll
+/// over to zero, the matching slot one level up is cascaded back down, so each
+/// id is touched at most once per level before it fires. schedule() and the
+/// per-tick cost are O(1) in the number of pending ids.
+///
+/// Slots are intrusive singly linked lists threaded through a per-id array,
+/// so once every id has been scheduled once, nothing allocates.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tip::coordination {
+
+    class TimingWheel {
+    public:
+        static constexpr unsigned    SLOT_BITS = 8;
+        static constexpr std::size_t SLOTS     = std::size_t{1} << SLOT_BITS;
+        static constexpr unsigned    LEVELS    = 64 / SLOT_BITS;
+
+        /// Create an empty wheel whose first processed tick is startTick.
+        explicit TimingWheel(uint64_t startTick = 0) noexcept : now_(startTick) {}
+
+        /// Next tick advance() will process.
+        [[nodiscard]] uint64_t now() const noexcept { return now_; }
+
+        /// Number of scheduled ids not yet fired.
+        [[nodiscard]] std::size_t pending() const noexcept { return pending_; }
+
+        /// Schedule id to fire at dueTick. Ticks already passed fire on the next advance().
+        /// An id may be pending at most once.
+        void schedule(uint32_t id, uint64_t dueTick);
+
+        /// Process tick now() and append the ids due on it to due (in no particular order).
+        void advance(std::vector<uint32_t>& due);
+
+    private:
+        static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+
+        std::array<std::array<uint32_t, SLOTS>, LEVELS> head_ = emptyWheels();
+        std::vector<uint64_t> dueTick_;  ///< Indexed by id, kept for cascading
+        std::vector<uint32_t> next_;     ///< Indexed by id; next id in the same slot
+        uint64_t    now_;
+        std::size_t pending_ = 0;
+
+        void file(uint32_t id, uint64_t dueTick);
+
+        [[nodiscard]] static constexpr std::array<std::array<uint32_t, SLOTS>, LEVELS> emptyWheels() noexcept {
+            std::array<std::array<uint32_t, SLOTS>, LEVELS> wheels{};
+            for (auto& level : wheels) level.fill(NIL);
+            return wheels;
+        }
+    };
+
+}
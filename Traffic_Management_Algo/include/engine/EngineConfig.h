@@ -12,6 +12,10 @@ namespace tip::engine {
         uint32_t yellowTime = 4;     ///< Yellow clearance (seconds)
         uint32_t allRedTime = 2;     ///< All-red clearance (seconds)
         double   greenPerVehicle = 2.0; ///< Seconds of green per queued vehicle
+        bool     dynamicPhases = false; ///< Pick the max-score conflict-free lane set instead of planned phases
+        uint32_t dynamicPhaseSlots = 32; ///< Lane sets dynamic mode keeps in the plan, least recently used replaced first; read at construction
+        uint32_t dynamicSearchNodeBudget = 20000; ///< Branch-and-bound nodes the dynamic phase search may visit
+        uint32_t incrementalScoringMinPhases = 256; ///< Plans this large select through PhaseScoreIndex (0 = always) unless dynamicPhases is set; read at construction
     };
 
 }
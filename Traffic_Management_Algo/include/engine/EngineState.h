@@ -0,0 +1,37 @@
+#pragma once
+#include "../model/PriorityReason.hpp"
+#include "../model/SignalPhase.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tip::engine {
+
+    /// Per-lane inputs that change while an engine runs.
+    struct LaneState {
+        uint32_t              queueLength    = 0;
+        uint32_t              waitCounter    = 0;
+        double                bleBoost       = 0.0;
+        model::PriorityReason priorityReason = model::PriorityReason::NONE;
+    };
+
+    /// Everything an engine needs to resume where another instance with the
+    /// same lanes and configuration left off (see saveState()).
+    struct EngineState {
+        std::vector<LaneState> lanes;
+        model::SignalPhase     signal        = model::SignalPhase::ALL_RED;
+        uint64_t               phaseIndex    = 0;
+        uint32_t               remainingTime = 0;
+        uint32_t               stateSteps    = 1;
+        /// Lane sets in the plan's dynamic slots, in slot order.
+        std::vector<std::vector<std::size_t>> dynamicPhases;
+        /// Last-use stamp of each dynamic slot (LRU order), parallel to dynamicPhases.
+        std::vector<uint64_t> dynamicPhaseUses;
+        /// Dynamic search's reused answer: the dominant lanes it is keyed on
+        /// and the lane set it returns (dominant lanes empty when none).
+        std::vector<std::size_t> searchDominant;
+        std::vector<std::size_t> searchResult;
+    };
+
+}
@@ -0,0 +1,124 @@
+#pragma once
+/// Batch engine for many intersections sharing one struct-of-arrays store.
+///
+/// Responsibilities:
+///   - Contiguous lane columns (Q_i, W_i, B_i, priority) for every intersection
+///   - Flattened phase plans (one LaneMask per phase) built once per intersection
+///   - One stepAll() pass producing every Decision in intersection order
+///
+/// Decisions are identical to running TrafficEngine::step() on each
+/// intersection built from the same lanes and configuration.
+
+#include "EngineConfig.hpp"
+#include "PhaseBuilder.hpp"
+#include "ScoringKernel.hpp"
+#include "../model/Lane.hpp"
+#include "../model/LaneMask.hpp"
+#include "../model/Decision.hpp"
+#include "../model/SignalPhase.hpp"
+#include "../model/PriorityReason.hpp"
+
+#include <vector>
+#include <string>
+#include <span>
+#include <cstdint>
+#include <cstddef>
+
+namespace tip::engine {
+
+/// Steps thousands of intersections from one cache-friendly lane store.
+class FleetEngine {
+public:
+    /// Add an intersection. Returns its index in the fleet.
+    /// @throws std::runtime_error if lanes is empty or no phases can be built.
+    std::size_t addIntersection(const std::vector<model::Lane>& lanes, EngineConfig config);
+
+    /// Run one decision cycle for every intersection.
+    /// Returns the decisions, indexed by intersection.
+    const std::vector<model::Decision>& stepAll();
+
+    /// Decisions from the latest stepAll().
+    [[nodiscard]] const std::vector<model::Decision>& lastDecisions() const noexcept {
+        return decisions_;
+    }
+
+    /// Number of intersections.
+    [[nodiscard]] std::size_t size() const noexcept { return phaseBegin_.size(); }
+
+    /// Number of lanes at an intersection.
+    [[nodiscard]] std::size_t laneCount(std::size_t intersection) const noexcept {
+        return laneBegin_[intersection + 1] - laneBegin_[intersection];
+    }
+
+    /// Lane columns for external updates (queue, wait, BLE boost, priority).
+    [[nodiscard]] std::span<uint32_t> queueLengths(std::size_t intersection) noexcept {
+        return laneSpan(queueLength_, intersection);
+    }
+    [[nodiscard]] std::span<uint32_t> waitCounters(std::size_t intersection) noexcept {
+        return laneSpan(waitCounter_, intersection);
+    }
+    [[nodiscard]] std::span<double> bleBoosts(std::size_t intersection) noexcept {
+        return laneSpan(bleBoost_, intersection);
+    }
+    [[nodiscard]] std::span<model::PriorityReason> priorities(std::size_t intersection) noexcept {
+        return laneSpan(priority_, intersection);
+    }
+
+    /// Access per-intersection config for RL parameter tuning.
+    [[nodiscard]] EngineConfig& config(std::size_t intersection) noexcept {
+        return configs_[intersection];
+    }
+
+    /// Get current signal state of an intersection.
+    [[nodiscard]] model::SignalPhase currentSignal(std::size_t intersection) const noexcept {
+        return signal_[intersection];
+    }
+
+private:
+    // --- Lane columns (indexed by global lane position) ---
+    std::vector<uint32_t>              queueLength_;
+    std::vector<uint32_t>              waitCounter_;
+    std::vector<double>                bleBoost_;
+    std::vector<model::PriorityReason> priority_;
+
+    // --- Phase plans ---
+    std::vector<model::LaneMask> phaseMask_;  ///< Lanes of each phase, relative to its intersection
+    std::vector<model::PhaseNameId> phaseNames_;
+
+    // --- Intersection columns ---
+    std::vector<uint32_t>           laneBegin_{0};  ///< size()+1 offsets into lane columns
+    std::vector<uint32_t>           phaseBegin_;    ///< Offset of first phase
+    std::vector<uint32_t>           phaseCount_;
+    std::vector<EngineConfig>       configs_;
+    std::vector<model::SignalPhase> signal_;
+    std::vector<uint32_t>           currentPhase_;  ///< Phase index local to the intersection
+    std::vector<uint32_t>           remaining_;     ///< Ticks remaining in current signal state
+
+    std::vector<model::Decision> decisions_;
+    std::vector<double>          laneScores_;     ///< Scratch for the widest intersection
+
+    template <typename T>
+    [[nodiscard]] std::span<T> laneSpan(std::vector<T>& column, std::size_t intersection) noexcept {
+        return {column.data() + laneBegin_[intersection], laneCount(intersection)};
+    }
+
+    /// Advance one intersection and write its decision.
+    void stepOne(std::size_t i, model::Decision& decision);
+
+    /// Select the next phase at ALL_RED expiry, mirroring TrafficEngine.
+    [[nodiscard]] uint32_t selectPhase(std::size_t i, model::PriorityReason& priority);
+
+    /// Mask of intersection i's lanes whose active priority equals reason.
+    [[nodiscard]] model::LaneMask priorityMask(std::size_t i, model::PriorityReason reason) const noexcept;
+
+    /// Compute score for a phase mask of intersection i.
+    [[nodiscard]] double scorePhase(std::size_t i, model::LaneMask phase) const noexcept;
+
+    /// Compute green duration for a phase mask of intersection i.
+    [[nodiscard]] uint32_t computeGreenDuration(std::size_t i, model::LaneMask phase) const;
+
+    /// Update starvation counters after phase selection.
+    void updateFairness(std::size_t i, model::LaneMask phase) noexcept;
+};
+
+}
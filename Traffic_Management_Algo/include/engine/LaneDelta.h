@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+
+namespace tip::engine {
+
+    /// Signed change to one lane's queue (arrivals minus departures).
+    struct LaneDelta {
+        uint32_t lane       = 0;  ///< Lane index
+        int32_t  queueDelta = 0;  ///< Added to queueLength, clamped to [0, UINT32_MAX]
+    };
+
+}
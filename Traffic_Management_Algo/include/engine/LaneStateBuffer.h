@@ -0,0 +1,91 @@
+#pragma once
+/// Lock-free ingestion of per-lane sensor inputs for one engine.
+///
+/// Sensor threads publish queue length, BLE boost and priority for a lane (or
+/// for every lane at once) into a seqlock-protected block. The engine thread
+/// takes one consistent snapshot at the start of step() and copies the lanes
+/// that changed into its Lane objects:
+///   - Writers: one CAS on the sequence word makes it odd, relaxed atomic
+///     stores, then a release store makes it even again
+///   - Reader: copy between two reads of the sequence word and retry if it
+///     moved; after repeated retries it briefly takes the write side itself,
+///     so a steady stream of writers cannot starve step()
+///   - Per-lane versions mean only published lanes are touched, so lanes()
+///     edits made on the engine thread are kept for unpublished lanes
+/// When nothing was published the reader does a single atomic load.
+
+#include "../model/Lane.hpp"
+#include "../model/PriorityReason.hpp"
+#include "../concurrency/CacheAligned.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace tip::engine {
+
+    /// Sensor-owned fields of a lane.
+    struct LaneInput {
+        uint32_t              queueLength    = 0;
+        double                bleBoost       = 0.0;
+        model::PriorityReason priorityReason = model::PriorityReason::NONE;
+    };
+
+    class LaneStateBuffer {
+    public:
+        /// Buffer for laneCount lanes, all unpublished.
+        explicit LaneStateBuffer(std::size_t laneCount);
+
+        [[nodiscard]] std::size_t size() const noexcept { return laneCount_; }
+
+        /// Publish one lane. Safe from any thread.
+        /// @throws std::out_of_range if lane >= size().
+        void publish(std::size_t lane, const LaneInput& input);
+
+        /// Publish every lane at once; the reader sees all of them or none.
+        /// Safe from any thread.
+        /// @throws std::invalid_argument if inputs.size() != size().
+        void publish(std::span<const LaneInput> inputs);
+
+        /// Engine thread only: copy lanes published since the last call into
+        /// lanes. Returns true if anything was applied.
+        bool applyTo(std::vector<model::Lane>& lanes);
+
+        /// Engine thread only: lanes copied by the last applyTo() that returned true.
+        [[nodiscard]] std::span<const std::size_t> lastApplied() const noexcept { return lastApplied_; }
+
+        /// Number of publications so far (any thread).
+        [[nodiscard]] uint64_t publications() const noexcept {
+            return seq_.load(std::memory_order_acquire) / 2;
+        }
+
+    private:
+        struct Slot {
+            std::atomic<uint32_t> queueLength{0};
+            std::atomic<uint64_t> bleBoostBits{0};
+            std::atomic<uint8_t>  priorityReason{0};
+            std::atomic<uint32_t> version{0};    ///< Bumped on every publish of this lane
+        };
+
+        std::size_t             laneCount_;
+        std::unique_ptr<Slot[]> slots_;
+
+        alignas(concurrency::CACHE_LINE) std::atomic<uint64_t> seq_{0}; ///< Odd while a write is in progress
+
+        // Reader-only state
+        alignas(concurrency::CACHE_LINE) uint64_t lastSeq_ = 0;
+        std::vector<uint32_t>  applied_;  ///< Last applied version per lane
+        std::vector<LaneInput> snapshot_;
+        std::vector<uint32_t>  snapshotVersion_;
+        std::vector<std::size_t> lastApplied_;
+
+        /// Make seq_ odd; returns the even value it had.
+        uint64_t lockWrite() noexcept;
+        void store(std::size_t lane, const LaneInput& input) noexcept;
+        void copySnapshot() noexcept;
+    };
+
+}
@@ -0,0 +1,89 @@
+#pragma once
+/// Finds the maximum-score conflict-free lane set for dynamic phase mode.
+///
+/// This is a maximum-weight independent set over the conflict graph, solved
+/// with bitmask branch-and-bound:
+///   - Lanes with positive score are ranked by score (highest first)
+///   - Branch: take the best remaining lane (dropping its conflicts) or skip it
+///   - Bound: current score + sum of remaining candidate scores
+///   - Anytime: a feasible seed is the incumbent; the search stops after a
+///     fixed number of nodes, so the answer depends only on its inputs and a
+///     restored engine replays the same decisions
+///
+/// The result is reused while the dominant lanes (the top-k lanes by score,
+/// with k = lanes in the previous answer) are unchanged.
+
+#include "../model/ConflictMatrix.hpp"
+#include "../model/LaneMask.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace tip::engine {
+
+    /// Stateful max-weight lane-set search (one instance per engine).
+    template <typename Mask>
+    class MaxWeightSearch {
+    public:
+        /// Return the best conflict-free mask found within nodeBudget search nodes.
+        /// @param seed A feasible mask used as the initial incumbent (e.g., best planned phase).
+        /// The cached answer is reused only while it still scores at least the seed.
+        [[nodiscard]] Mask solve(const model::BasicConflictMatrix<Mask>& conflicts,
+                                 std::span<const double> laneScores,
+                                 const Mask& seed,
+                                 uint64_t nodeBudget);
+
+        /// Whether the last solve() reused the cached answer.
+        [[nodiscard]] bool lastWasCached() const noexcept { return lastCached_; }
+
+        /// Whether the last solve() ran out of nodes before proving optimality.
+        [[nodiscard]] bool lastOutOfBudget() const noexcept { return outOfBudget_; }
+
+        /// Forget the cached answer.
+        void invalidate() noexcept { hasCache_ = false; }
+
+        /// Whether an answer is cached. It changes later answers, so an
+        /// engine's saved state carries cachedDominant() and cachedResult().
+        [[nodiscard]] bool hasCache() const noexcept { return hasCache_; }
+        [[nodiscard]] const Mask& cachedDominant() const noexcept { return cachedDominant_; }
+        [[nodiscard]] const Mask& cachedResult() const noexcept { return cachedResult_; }
+
+        /// Reinstate an answer saved from cachedDominant() and cachedResult().
+        void restoreCache(const Mask& dominant, const Mask& result) {
+            cachedDominant_ = dominant;
+            cachedResult_   = result;
+            hasCache_       = model::anyLane(dominant);
+        }
+
+    private:
+        // Search state, in rank space (bit r = r-th highest scoring lane)
+        std::vector<std::size_t> order_;
+        std::vector<Mask>        rankConflicts_;
+        std::vector<double>      rankScores_;
+        Mask            bestRanked_{};
+        double          bestScore_   = 0.0;
+        bool            seedIsBest_  = true;
+        uint64_t        nodes_       = 0;
+        uint64_t        nodeBudget_  = 0;
+        bool            outOfBudget_ = false;
+
+        // Reuse cache
+        bool            hasCache_       = false;
+        bool            lastCached_     = false;
+        Mask            cachedDominant_{};
+        Mask            cachedResult_{};
+
+        void branch(const Mask& candidates, const Mask& current, double score);
+
+        /// Top-k lanes by score (ties broken by lane index).
+        [[nodiscard]] Mask dominantLanes(std::size_t count, std::size_t k) const;
+    };
+
+    extern template class MaxWeightSearch<model::LaneMask>;
+    extern template class MaxWeightSearch<model::LaneBitset<128>>;
+    extern template class MaxWeightSearch<model::LaneBitset<256>>;
+    extern template class MaxWeightSearch<model::DynamicLaneBitset>;
+
+}
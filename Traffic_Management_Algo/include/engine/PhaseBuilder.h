@@ -21,9 +21,11 @@ namespace tip::engine {
     public:
         /// Generate the phase plan from an arbitrary lane set.
         /// Validates that no phase contains conflicting lanes.
-        [[nodiscard]] static std::vector<model::Phase> build(
+        /// Instantiated for every mask width declared in ConflictMatrix.h.
+        template <typename Mask>
+        [[nodiscard]] static std::vector<model::BasicPhase<Mask>> build(
             const std::vector<model::Lane>& lanes,
-            const model::ConflictMatrix& conflicts);
+            const model::BasicConflictMatrix<Mask>& conflicts);
 
     private:
         /// Collect lane indices matching a set of approach indices and a movement type.
@@ -33,9 +35,10 @@ namespace tip::engine {
             model::MovementType movement);
 
         /// Verify no internal conflicts within a phase.
+        template <typename Mask>
         static void validatePhase(
-            const model::Phase& phase,
-            const model::ConflictMatrix& conflicts);
+            const model::BasicPhase<Mask>& phase,
+            const model::BasicConflictMatrix<Mask>& conflicts);
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+/// Fixed-capacity hash map from phase lane mask to phase index.
+///
+/// Open addressing with linear probing and backward-shift deletion, so
+/// lookups, inserts and erases never allocate once the table is sized and
+/// never leave tombstones behind. Used by dynamic phase mode to find the
+/// planned phase or dynamic slot holding a lane set without scanning the plan.
+
+#include "../model/LaneMask.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace tip::engine {
+
+    template <typename Mask>
+    class PhaseMaskTable {
+    public:
+        /// Returned by find() for a mask not in the table.
+        static constexpr std::size_t NOT_FOUND = std::numeric_limits<std::size_t>::max();
+
+        /// Size the table for up to maxEntries masks; clears it.
+        void reset(std::size_t maxEntries);
+
+        /// Index stored for mask, or NOT_FOUND.
+        [[nodiscard]] std::size_t find(const Mask& mask) const noexcept;
+
+        /// Map mask to index unless the mask is already present (the first
+        /// index inserted for a mask wins). The table must have room.
+        void insert(const Mask& mask, std::size_t index);
+
+        /// Remove mask if it maps to index.
+        void erase(const Mask& mask, std::size_t index) noexcept;
+
+        [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+    private:
+        struct Entry {
+            uint64_t    hash  = 0;
+            std::size_t index = NOT_FOUND;  ///< NOT_FOUND marks an empty bucket
+            Mask        mask{};
+        };
+
+        std::vector<Entry> buckets_;
+        std::size_t        bucketMask_ = 0;
+        std::size_t        size_       = 0;
+
+        [[nodiscard]] static uint64_t hashOf(const Mask& mask) noexcept;
+        [[nodiscard]] std::size_t slotOf(const Mask& mask, uint64_t hash) const noexcept;
+    };
+
+    extern template class PhaseMaskTable<model::LaneMask>;
+    extern template class PhaseMaskTable<model::LaneBitset<128>>;
+    extern template class PhaseMaskTable<model::LaneBitset<256>>;
+    extern template class PhaseMaskTable<model::DynamicLaneBitset>;
+
+}
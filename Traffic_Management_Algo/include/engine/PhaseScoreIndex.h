@@ -0,0 +1,116 @@
+#pragma once
+/// Incrementally maintained argmax over phase scores S_p = Σ_{i∈p} S_i.
+///
+/// Rescoring every phase at each selection costs O(Σ|p|). The index keeps
+/// per-phase sums up to date as lanes change and answers the argmax from
+/// tournament trees, so a selection costs O(changed lanes · phases per lane
+/// · log phases):
+///   - A lane→phase reverse index finds the phases a changed lane touches
+///   - Wait counters are stored as epochs, W_i = E - g_i. Advancing the
+///     epoch raises every non-green lane's wait without touching it; only
+///     lanes reset on green change g_i
+///   - The epoch term α·|p|·E is the same for every phase of one size, so
+///     phases are grouped by size and each group keeps a tournament tree
+///     keyed on Σ(Q + β·B - α·g); the answer is the best group root
+///   - Keys are taken relative to a base epoch that is moved forward now
+///     and then, so the epoch term stays small and exact in a double
+///   - Phases within a small tolerance of the best are rescored exactly in
+///     lane order, so the choice (lowest index on ties) is bit-identical to
+///     a full rescore
+/// A change of α or β rebuilds every key.
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace tip::engine {
+
+    class PhaseScoreIndex {
+    public:
+        /// Index phases over laneCount lanes; every lane starts at zero.
+        /// Phase is any type with a laneIndices member (e.g. model::BasicPhase).
+        template <typename Phase>
+        void build(std::span<const Phase> phases, std::size_t laneCount) {
+            std::vector<std::vector<std::size_t>> lanes;
+            lanes.reserve(phases.size());
+            for (const auto& phase : phases) lanes.push_back(phase.laneIndices);
+            build(lanes, laneCount);
+        }
+
+        void build(const std::vector<std::vector<std::size_t>>& phaseLanes, std::size_t laneCount);
+
+        [[nodiscard]] std::size_t phaseCount() const noexcept { return phaseCount_; }
+
+        /// Record a lane's current inputs.
+        void setLane(std::size_t lane, uint32_t queue, uint32_t wait, double boost);
+
+        /// Start the next fairness round: every lane's wait grows by one
+        /// except those passed to resetWait() afterwards.
+        void nextEpoch();
+
+        /// Lane got green in the current round: its wait is zero.
+        void resetWait(std::size_t lane);
+
+        /// Index of the highest-scoring phase under S_i = Q_i + α·W_i + β·B_i,
+        /// lowest index on ties; 0 if no phase scores above -1 (matching the
+        /// full rescore's initial bound).
+        [[nodiscard]] std::size_t best(double alpha, double beta);
+
+    private:
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        std::size_t phaseCount_ = 0;
+
+        // Phase → lanes and lane → phases, CSR; phase lanes in ascending order
+        std::vector<uint32_t> phaseLaneStart_;
+        std::vector<uint32_t> phaseLanes_;
+        std::vector<uint32_t> lanePhaseStart_;
+        std::vector<uint32_t> lanePhases_;
+
+        // Lane inputs; wait is epoch_ - waitEpoch_
+        std::vector<uint32_t> queue_;
+        std::vector<int64_t>  waitEpoch_;
+        std::vector<double>   boost_;
+        int64_t               epoch_ = 0;
+        int64_t               base_  = 0; ///< Keys are relative to this epoch to keep them small
+
+        // Per-phase sums; the integer ones are updated in place, the boost
+        // sum is re-added from the lanes when a boost changes (no drift)
+        std::vector<int64_t>  queueSum_;
+        std::vector<int64_t>  waitEpochSum_;
+        std::vector<double>   boostSum_;
+        std::vector<uint8_t>  boostStale_;
+        std::vector<double>   key_;  ///< Σ Q + β·Σ B + α·Σ (base - g)
+
+        // Size groups, each a tournament tree over its phases (leaves in
+        // phase order, internal nodes hold the winning phase)
+        struct Group {
+            uint32_t              size = 0;   ///< Lanes per phase
+            uint32_t              leaves = 0; ///< Power of two ≥ phase count
+            std::vector<uint32_t> tree;       ///< 2·leaves nodes, root at 1
+        };
+        std::vector<Group>    groups_;
+        std::vector<uint32_t> groupOf_;
+        std::vector<uint32_t> leafOf_;
+
+        // Phases whose keys need recomputing before the next query
+        std::vector<uint32_t> pending_;
+        std::vector<uint8_t>  isPending_;
+
+        double alpha_ = 0.0;
+        double beta_  = 0.0;
+        bool   keysValid_ = false;
+
+        std::vector<uint32_t> candidates_; ///< Scratch for best()
+
+        void touchLane(std::size_t lane, int64_t queueDelta, int64_t waitEpochDelta, bool boostChanged);
+        void recompute(uint32_t phase);
+        void updateKey(uint32_t phase);
+        void updateLeaf(uint32_t phase);
+        [[nodiscard]] bool better(uint32_t a, uint32_t b) const noexcept;
+        void collect(const Group& group, uint32_t node, double threshold);
+        [[nodiscard]] double exactScore(uint32_t phase, double alpha, double beta) const;
+    };
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+/// Vectorized lane scoring: S_i = Q_i + α·W_i + β·B_i over contiguous columns.
+///
+/// The kernel is compiled for AVX2, SSE4.2 and plain scalar code in one
+/// translation unit and the best variant is picked at runtime from CPUID.
+/// Every variant evaluates the same expression in the same order without
+/// fused multiply-add, so results are bit-identical to Lane::score().
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace tip::engine {
+
+    /// Instruction set used by the scoring kernel.
+    enum class ScoringIsa : uint8_t {
+        SCALAR = 0,
+        SSE42  = 1,
+        AVX2   = 2
+    };
+
+    [[nodiscard]] std::string to_string(ScoringIsa isa);
+
+    /// Best instruction set supported by the running CPU.
+    [[nodiscard]] ScoringIsa detectScoringIsa() noexcept;
+
+    /// Instruction set currently used by scoreLanes(); defaults to detectScoringIsa().
+    [[nodiscard]] ScoringIsa activeScoringIsa() noexcept;
+
+    /// Override the dispatched instruction set (e.g. to compare variants).
+    /// Requests above detectScoringIsa() are clamped to it.
+    void setScoringIsa(ScoringIsa isa) noexcept;
+
+    /// Compute out[i] = queue[i] + alpha·wait[i] + beta·boost[i] for i in [0, count).
+    void scoreLanes(const uint32_t* queue, const uint32_t* wait, const double* boost,
+                    std::size_t count, double alpha, double beta, double* out) noexcept;
+
+    /// Same as scoreLanes() but with an explicit instruction set.
+    /// The caller must ensure the CPU supports it.
+    void scoreLanes(ScoringIsa isa,
+                    const uint32_t* queue, const uint32_t* wait, const double* boost,
+                    std::size_t count, double alpha, double beta, double* out) noexcept;
+
+}
@@ -1,13 +1,26 @@
 #pragma once
 /// Responsibilities:
-///   - Adaptive phase scoring: S_i = Q_i + α·W_i + β·B_i
+///   - Adaptive phase scoring: S_i = Q_i + α·W_i + β·B_i, incremental for
+///     large plans (PhaseScoreIndex)
+///   - Optional dynamic phases: max-score conflict-free lane set per cycle
 ///   - Emergency override detection
 ///   - Signal state machine (GREEN → YELLOW → ALL_RED → GREEN)
 ///   - Green duration computation (proportional, bounded)
 ///   - Starvation fairness updates
+///
+/// Parameterized on the lane mask width like ConflictMatrix. TrafficEngine is
+/// the 64-lane engine; wider junctions use TrafficEngineFor<MaxLanes> or
+/// DynamicTrafficEngine.
 
 #include "EngineConfig.hpp"
+#include "EngineState.hpp"
+#include "LaneDelta.hpp"
 #include "PhaseBuilder.hpp"
+#include "ScoringKernel.hpp"
+#include "MaxWeightSearch.hpp"
+#include "PhaseMaskTable.hpp"
+#include "PhaseScoreIndex.hpp"
+#include "LaneStateBuffer.hpp"
 #include "../model/Lane.hpp"
 #include "../model/Phase.hpp"
 #include "../model/ConflictMatrix.hpp"
@@ -17,22 +30,79 @@
 #include <vector>
 #include <optional>
 #include <memory>
+#include <span>
+#include <string>
 
 namespace tip::engine {
 
 /// The main traffic control engine for a single intersection.
-class TrafficEngine {
+template <typename Mask>
+class BasicTrafficEngine {
 public:
+    using Phase          = model::BasicPhase<Mask>;
+    using ConflictMatrix = model::BasicConflictMatrix<Mask>;
+
     /// Construct engine with lanes and configuration.
-    TrafficEngine(std::vector<model::Lane> lanes, EngineConfig config);
+    BasicTrafficEngine(std::vector<model::Lane> lanes, EngineConfig config);
 
     /// Run one decision cycle. Returns the decision for this step.
     [[nodiscard]] model::Decision step();
 
+    /// Number of step() calls until the state machine next changes state:
+    /// the first ticksUntilTransition() - 1 calls only count down.
+    [[nodiscard]] uint32_t ticksUntilTransition() const noexcept { return remainingTime_ + 1; }
+
+    /// Skip ticks countdown-only steps in O(1). Equivalent to calling step()
+    /// ticks times and discarding the decisions.
+    /// @throws std::out_of_range if ticks reaches the next state change.
+    void advance(uint32_t ticks);
+
+    /// Decision a countdown step() in the current state reports.
+    [[nodiscard]] model::Decision currentDecision() const;
+
+    /// Copy the running state into state, reusing its storage.
+    void saveState(EngineState& state) const;
+
+    /// Resume from a state saved by an engine with the same lanes and
+    /// configuration; later steps match the saving engine's. Every lane
+    /// becomes dirty.
+    /// @throws std::invalid_argument if the state does not fit this engine.
+    void restoreState(const EngineState& state);
+
     /// Access lanes for external updates (queue, priority, BLE boost).
-    [[nodiscard]] std::vector<model::Lane>& lanes() noexcept { return lanes_; }
+    /// Not synchronized with step(); other threads publish through laneInputs().
+    /// Writes through this reference are not tracked, so every lane is marked
+    /// dirty; prefer updateQueues() / applyDeltas() for queue updates.
+    [[nodiscard]] std::vector<model::Lane>& lanes() {
+        markAllLanesDirty();
+        return lanes_;
+    }
     [[nodiscard]] const std::vector<model::Lane>& lanes() const noexcept { return lanes_; }
 
+    /// Set every lane's queue length; lanes whose value changed become dirty.
+    /// @throws std::invalid_argument if queues.size() != lane count.
+    void updateQueues(std::span<const uint32_t> queues);
+
+    /// Add queue deltas in order; lanes whose value changed become dirty.
+    /// @throws std::out_of_range if any delta names a missing lane (nothing is applied).
+    void applyDeltas(std::span<const LaneDelta> deltas);
+
+    /// Lanes whose inputs (queue, wait, boost, priority) changed since the
+    /// last clearDirtyLanes(), through any of the update paths above or
+    /// laneInputs(). The engine's own fairness updates are not included.
+    [[nodiscard]] const Mask& dirtyLanes() const noexcept { return dirty_; }
+    void clearDirtyLanes() noexcept { dirty_ = Mask{}; }
+
+    /// Mark every lane dirty, e.g. after writing lane memory directly.
+    void markAllLanesDirty() {
+        dirty_ = allLanes_;
+        columnsDirty_ = allLanes_;
+    }
+
+    /// Lock-free input surface for sensor threads. Published lanes are copied
+    /// into lanes() from one consistent snapshot at the start of each step().
+    [[nodiscard]] LaneStateBuffer& laneInputs() noexcept { return *laneInputs_; }
+
     /// Access config for RL parameter tuning.
     [[nodiscard]] EngineConfig& config() noexcept { return config_; }
 
@@ -40,35 +110,114 @@ public:
     [[nodiscard]] model::SignalPhase currentSignal() const noexcept { return currentSignal_; }
 
     /// Read-only access to the conflict matrix.
-    [[nodiscard]] const model::ConflictMatrix& conflictMatrix() const noexcept { return conflicts_; }
+    [[nodiscard]] const ConflictMatrix& conflictMatrix() const noexcept { return conflicts_; }
+
+    /// Get the phase plan. In dynamic phase mode, lane sets chosen by the
+    /// search fill up to dynamicPhaseSlots slots after the planned phases;
+    /// once all are taken, the least recently selected slot is overwritten,
+    /// so a dynamic index names its lane set only until the slot is reused.
+    [[nodiscard]] const std::vector<Phase>& phases() const noexcept { return phases_; }
+
+    /// Display name of phase index: the planned name, or "DYN-a+b+..." over
+    /// the lanes a dynamic slot currently holds (decisions for dynamic slots
+    /// carry DYNAMIC_PHASE_NAME). Allocates; meant for display, not step().
+    /// @throws std::out_of_range if index is outside the plan.
+    [[nodiscard]] std::string phaseName(std::size_t index) const;
 
-    /// Get the phase plan.
-    [[nodiscard]] const std::vector<model::Phase>& phases() const noexcept { return phases_; }
+    /// Number of phases produced by PhaseBuilder (the fixed plan).
+    [[nodiscard]] std::size_t plannedPhaseCount() const noexcept { return plannedPhaseCount_; }
 
 private:
     std::vector<model::Lane>  lanes_;
     EngineConfig              config_;
-    model::ConflictMatrix     conflicts_;
-    std::vector<model::Phase> phases_;
+    ConflictMatrix            conflicts_;
+    std::vector<Phase>        phases_;
+    std::size_t               plannedPhaseCount_;
+    MaxWeightSearch<Mask>     dynamicSearch_;
+    std::size_t               dynamicSlots_;      ///< config_.dynamicPhaseSlots at construction (at least 1)
+    std::vector<uint64_t>     dynamicLastUse_;    ///< Per dynamic slot, for LRU replacement
+    std::vector<Phase>        spareSlots_;        ///< Allocated slots not in phases_ (dynamic mode), reused before allocating
+    uint64_t                  dynamicClock_ = 0;  ///< Last stamp handed out
+    PhaseMaskTable<Mask>      phaseLookup_;       ///< Planned and dynamic masks → phase index
+    bool                      lookupReady_ = false; ///< phaseLookup_ matches phases_
+    PhaseScoreIndex           scoreIndex_;
+    bool                      incremental_;  ///< Planned selection goes through scoreIndex_
+    std::unique_ptr<LaneStateBuffer> laneInputs_;
+    Mask                      allLanes_{};
+    Mask                      dirty_{};        ///< Reported by dirtyLanes()
+    Mask                      columnsDirty_{}; ///< Lanes to re-gather into the scoring columns
 
     model::SignalPhase currentSignal_    = model::SignalPhase::ALL_RED;
     std::size_t        currentPhaseIdx_  = 0;
     uint32_t           remainingTime_    = 0; ///< Ticks remaining in current signal state
+    uint32_t           stateSteps_       = 1; ///< Steps the current state lasts, for the step counter
+
+    /// Lane input columns and scores for the vectorized selection pass.
+    /// Columns persist between selections; only dirty lanes are re-gathered.
+    std::vector<uint32_t> queueScratch_;
+    std::vector<uint32_t> waitScratch_;
+    std::vector<double>   boostScratch_;
+    std::vector<double>   laneScores_;
+
+    void markDirty(std::size_t lane) {
+        model::setLane(dirty_, lane);
+        model::setLane(columnsDirty_, lane);
+    }
+
+    /// Mask of lanes whose active priority equals reason.
+    [[nodiscard]] Mask priorityMask(model::PriorityReason reason) const;
+
+    /// Leave the expired signal state and return the step's decision. Kept out
+    /// of step() so countdown steps carry none of its code or instrumentation.
+    [[nodiscard]] model::Decision changeState();
 
     /// Check for emergency override across all lanes.
     [[nodiscard]] std::optional<std::size_t> findEmergencyPhase() const;
 
-    /// Score all phases and return the best index.
-    [[nodiscard]] std::size_t selectBestPhase() const;
+    /// Re-gather the input columns for dirty lanes (and feed scoreIndex_).
+    void refreshColumns();
+
+    /// Score every lane into laneScores_ in one pass with the SIMD kernel.
+    void computeLaneScores();
+
+    /// Score all planned phases and return the best index.
+    [[nodiscard]] std::size_t selectBestPhase();
+
+    /// Search the max-score conflict-free lane set and return its phase index.
+    [[nodiscard]] std::size_t selectDynamicPhase();
+
+    /// Put mask in a free or the least recently used dynamic slot; returns its phase index.
+    [[nodiscard]] std::size_t storeDynamicPhase(const Mask& mask);
+
+    /// Write a lane set into dynamic slot (appending it if slot is the next one).
+    void writeDynamicSlot(std::size_t slot, const Mask& mask);
+
+    /// Index every planned and dynamic phase mask.
+    void buildPhaseLookup();
 
     /// Compute score for a single phase.
-    [[nodiscard]] double scorePhase(const model::Phase& phase) const;
+    [[nodiscard]] double scorePhase(const Phase& phase) const;
 
     /// Compute green duration for selected phase.
-    [[nodiscard]] uint32_t computeGreenDuration(const model::Phase& phase) const;
+    [[nodiscard]] uint32_t computeGreenDuration(const Phase& phase) const;
 
     /// Update starvation counters after phase selection.
     void updateFairness(std::size_t selectedPhaseIdx);
 };
 
+extern template class BasicTrafficEngine<model::LaneMask>;
+extern template class BasicTrafficEngine<model::LaneBitset<128>>;
+extern template class BasicTrafficEngine<model::LaneBitset<256>>;
+extern template class BasicTrafficEngine<model::DynamicLaneBitset>;
+
+/// 64-lane single-word engine.
+using TrafficEngine        = BasicTrafficEngine<model::LaneMask>;
+using TrafficEngine128     = BasicTrafficEngine<model::LaneBitset<128>>;
+using TrafficEngine256     = BasicTrafficEngine<model::LaneBitset<256>>;
+using DynamicTrafficEngine = BasicTrafficEngine<model::DynamicLaneBitset>;
+
+/// Narrowest engine for a topology with at most MaxLanes lanes.
+template <std::size_t MaxLanes>
+using TrafficEngineFor = BasicTrafficEngine<model::LaneMaskFor<MaxLanes>>;
+
 }
\ No newline at end of file
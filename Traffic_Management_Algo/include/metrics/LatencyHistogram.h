@@ -0,0 +1,63 @@
+#pragma once
+/// Log-linear latency histogram in the style of HdrHistogram.
+///
+/// Values below 64 ns get exact buckets; above that each power of two is
+/// split into 32 buckets, so any recorded value is reported within ~3%.
+/// Values beyond 2^40 ns (about 18 minutes) land in the last bucket.
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace tip::metrics {
+
+    namespace histogram {
+        inline constexpr unsigned    SUB_BITS    = 5;                         ///< 32 buckets per power of two
+        inline constexpr uint64_t    SUB_COUNT   = uint64_t{1} << SUB_BITS;
+        inline constexpr unsigned    MAX_BITS    = 40;                        ///< Largest distinct value: 2^40 ns
+        inline constexpr std::size_t BUCKETS     = 2 * SUB_COUNT + (MAX_BITS - SUB_BITS - 1) * SUB_COUNT;
+
+        /// Bucket holding value.
+        [[nodiscard]] constexpr std::size_t bucketOf(uint64_t value) noexcept {
+            if (value < 2 * SUB_COUNT) return static_cast<std::size_t>(value);
+            const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - SUB_BITS - 1;
+            const std::size_t bucket = 2 * SUB_COUNT + (shift - 1) * SUB_COUNT + ((value >> shift) - SUB_COUNT);
+            return bucket < BUCKETS ? bucket : BUCKETS - 1;
+        }
+
+        /// Smallest value mapping to bucket.
+        [[nodiscard]] constexpr uint64_t lowerBound(std::size_t bucket) noexcept {
+            if (bucket < 2 * SUB_COUNT) return bucket;
+            const uint64_t shift = (bucket - 2 * SUB_COUNT) / SUB_COUNT + 1;
+            return (SUB_COUNT + (bucket - 2 * SUB_COUNT) % SUB_COUNT) << shift;
+        }
+
+        static_assert(bucketOf(lowerBound(BUCKETS - 1)) == BUCKETS - 1);
+        static_assert(bucketOf(lowerBound(200)) == 200 && bucketOf(lowerBound(201) - 1) == 200);
+    }
+
+    /// Histogram written by one thread and read concurrently by snapshots.
+    /// Updates are plain load/store pairs on relaxed atomics (no RMW), which
+    /// is exact because each histogram has a single writer.
+    class LatencyHistogram {
+    public:
+        void record(uint64_t nanos) noexcept {
+            bump(buckets_[histogram::bucketOf(nanos)], 1);
+            bump(sum_, nanos);
+        }
+
+        [[nodiscard]] uint64_t bucket(std::size_t i) const noexcept { return buckets_[i].load(std::memory_order_relaxed); }
+        [[nodiscard]] uint64_t sum() const noexcept { return sum_.load(std::memory_order_relaxed); }
+
+    private:
+        std::array<std::atomic<uint64_t>, histogram::BUCKETS> buckets_{};
+        std::atomic<uint64_t> sum_{0};
+
+        static void bump(std::atomic<uint64_t>& cell, uint64_t n) noexcept {
+            cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    };
+
+}
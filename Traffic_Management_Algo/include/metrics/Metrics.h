@@ -0,0 +1,180 @@
+#pragma once
+/// Hot-path counters and latency timers.
+///
+/// Each thread writes its own block of counters and histograms, so recording
+/// never contends; snapshot() sums every block while writers keep running.
+/// Counters are exact. Timers sample one call in TIMER_SAMPLE_PERIOD per
+/// thread, which keeps clock reads off most calls.
+///
+/// An instrumented function starts with TIP_METRICS_SCOPE(), which looks up
+/// the thread's block once; its TIP_COUNT / TIP_TIME sites then work on that
+/// reference, so each costs a load and a store (a decrement and a branch for
+/// an unsampled timer) with no further thread-local access.
+///
+/// Instrumentation is off by default (CMake option TIP_INSTRUMENTATION): with
+/// TIP_INSTRUMENTATION=0 the call sites compile out and snapshot() reports zeros.
+
+#include "LatencyHistogram.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#ifndef TIP_INSTRUMENTATION
+#define TIP_INSTRUMENTATION 0
+#endif
+
+namespace tip::metrics {
+
+    enum class Counter : uint8_t {
+        STEPS,                     ///< Engine steps incl. advance()d ticks, added when each signal state ends
+        PHASE_SWITCHES,            ///< Greens that serve a different phase than the previous green
+        EMERGENCY_OVERRIDES,       ///< Greens forced by an emergency lane
+        BLE_ACCEPTED,
+        BLE_REJECTED_UNAUTHORIZED,
+        BLE_REJECTED_COOLDOWN,
+        BLE_REJECTED_RATE_LIMIT,
+        CORRIDOR_TICKS,
+        COUNT
+    };
+
+    enum class Timer : uint8_t {
+        STATE_CHANGE,     ///< Engine steps that change signal state; countdown steps are not timed
+        PHASE_SELECTION,  ///< Planned or dynamic phase selection
+        BLE_PROCESS,      ///< BLEPriorityManager::processEvent
+        CORRIDOR_TICK,    ///< CorridorCoordinator::tick
+        COUNT
+    };
+
+    inline constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(Counter::COUNT);
+    inline constexpr std::size_t TIMER_COUNT   = static_cast<std::size_t>(Timer::COUNT);
+
+    /// One timed call out of this many is recorded, per timer and thread.
+    inline constexpr uint32_t TIMER_SAMPLE_PERIOD = 256;
+
+    [[nodiscard]] std::string_view to_string(Counter counter) noexcept;
+    [[nodiscard]] std::string_view to_string(Timer timer) noexcept;
+
+    /// Merged view of one timer.
+    struct TimerSnapshot {
+        std::vector<uint64_t> buckets = std::vector<uint64_t>(histogram::BUCKETS);
+        uint64_t samples = 0;
+        uint64_t sumNanos = 0;
+
+        [[nodiscard]] double meanNanos() const noexcept {
+            return samples ? static_cast<double>(sumNanos) / static_cast<double>(samples) : 0.0;
+        }
+
+        /// Latency at quantile q in [0, 1] (bucket lower bound), or 0 without samples.
+        [[nodiscard]] uint64_t percentile(double q) const noexcept;
+    };
+
+    /// Sum over all threads at one point in time (not an atomic cut across threads).
+    struct Snapshot {
+        std::array<uint64_t, COUNTER_COUNT> counters{};
+        std::array<TimerSnapshot, TIMER_COUNT> timers;
+
+        [[nodiscard]] uint64_t operator[](Counter c) const noexcept { return counters[static_cast<std::size_t>(c)]; }
+        [[nodiscard]] const TimerSnapshot& operator[](Timer t) const noexcept { return timers[static_cast<std::size_t>(t)]; }
+    };
+
+    /// Merge every thread's metrics. Safe to call while threads record.
+    [[nodiscard]] Snapshot snapshot();
+
+    /// Whether call sites were compiled in.
+    [[nodiscard]] constexpr bool enabled() noexcept { return TIP_INSTRUMENTATION != 0; }
+
+    namespace detail {
+        /// Metrics written by one thread. Blocks outlive their threads so
+        /// snapshots keep the counts of exited workers.
+        struct ThreadBlock {
+            std::array<std::atomic<uint64_t>, COUNTER_COUNT> counters{};
+            std::array<LatencyHistogram, TIMER_COUNT>        timers;
+            std::array<uint32_t, TIMER_COUNT>                untilSample{}; ///< Calls left before the next sample
+        };
+
+        /// Register a block for the calling thread.
+        [[nodiscard]] ThreadBlock& attach();
+
+        inline thread_local ThreadBlock* current = nullptr;
+
+        [[nodiscard]] inline ThreadBlock& block() {
+            return current ? *current : attach();
+        }
+    }
+
+    /// The calling thread's metrics block, looked up once per instrumented
+    /// function (TIP_METRICS_SCOPE) instead of at every call site.
+    class Recorder {
+    public:
+        Recorder() : block_(detail::block()) {}
+
+        /// Add n to a counter. The counter has one writer, so a relaxed load
+        /// and store suffice; no read-modify-write.
+        void add(Counter counter, uint64_t n = 1) const noexcept {
+            auto& cell = block_.counters[static_cast<std::size_t>(counter)];
+            cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] detail::ThreadBlock& block() const noexcept { return block_; }
+
+    private:
+        detail::ThreadBlock& block_;
+    };
+
+    /// Add n to a counter of the calling thread (one-off sites outside a TIP_METRICS_SCOPE).
+    inline void add(Counter counter, uint64_t n = 1) {
+        Recorder().add(counter, n);
+    }
+
+    /// Times its scope when the timer's sampling countdown expires.
+    class ScopedTimer {
+    public:
+        ScopedTimer(const Recorder& recorder, Timer timer) {
+            auto& block = recorder.block();
+            auto& until = block.untilSample[static_cast<std::size_t>(timer)];
+            if (until-- == 0) [[unlikely]] {
+                start(block, timer);
+            }
+        }
+
+        ~ScopedTimer() {
+            if (histogram_) [[unlikely]] {
+                stop();
+            }
+        }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        LatencyHistogram* histogram_ = nullptr;
+        std::chrono::steady_clock::time_point start_;
+
+        // Out of line so unsampled calls stay a decrement and two branches
+        void start(detail::ThreadBlock& block, Timer timer);
+        void stop();
+    };
+
+}
+
+#define TIP_METRICS_CONCAT_(a, b) a##b
+#define TIP_METRICS_CONCAT(a, b) TIP_METRICS_CONCAT_(a, b)
+
+#if TIP_INSTRUMENTATION
+/// Look up the calling thread's metrics once for the TIP_COUNT / TIP_TIME
+/// sites that follow in the same function.
+#define TIP_METRICS_SCOPE() const ::tip::metrics::Recorder tipMetricsRecorder_
+/// Add n to counter (a tip::metrics::Counter enumerator name).
+#define TIP_COUNT(counter, n) tipMetricsRecorder_.add(::tip::metrics::Counter::counter, (n))
+/// Time the rest of the enclosing scope under timer (a tip::metrics::Timer enumerator name).
+#define TIP_TIME(timer) \
+    ::tip::metrics::ScopedTimer TIP_METRICS_CONCAT(tipScopedTimer_, __LINE__)(tipMetricsRecorder_, ::tip::metrics::Timer::timer)
+#else
+#define TIP_METRICS_SCOPE() static_cast<void>(0)
+#define TIP_COUNT(counter, n) static_cast<void>(0)
+#define TIP_TIME(timer) static_cast<void>(0)
+#endif
@@ -1,8 +1,19 @@
 #pragma once
 /// Thread-safe for concurrent reads after construction.
+///
+/// Parameterized on the lane mask width (see LaneMask.h). ConflictMatrix is
+/// the 64-lane single-word matrix; wider junctions pick a width at compile
+/// time with ConflictMatrixFor<MaxLanes>, or use DynamicConflictMatrix when
+/// the lane count is only known at runtime.
+///
+/// Construction runs a broad phase over per-lane bounding boxes, then an exact
+/// narrow phase on the surviving pairs using PolylineIndex. Passing a
+/// WorkStealingPool splits the indexing and narrow phase across its workers.
 
 #include "Lane.hpp"
+#include "LaneMask.hpp"
 #include "Geometry.hpp"
+#include "../concurrency/WorkStealingPool.hpp"
 
 #include <vector>
 #include <cstdint>
@@ -11,28 +22,32 @@
 
 namespace tip::model {
 
-    /// Bitmask type — supports up to 64 lanes.
-    using LaneMask = uint64_t;
-
     /// N×N bitmask conflict matrix; immutable after construction.
-    class ConflictMatrix {
+    template <typename Mask>
+    class BasicConflictMatrix {
     public:
+        using mask_type = Mask;
+
         /// Build the conflict matrix from lane path geometry.
-        /// @throws std::runtime_error if lane count exceeds 64.
-        explicit ConflictMatrix(const std::vector<Lane>& lanes);
+        /// @throws std::runtime_error if lane count exceeds the mask width.
+        explicit BasicConflictMatrix(const std::vector<Lane>& lanes);
+
+        /// Build the conflict matrix, running the narrow phase on pool.
+        /// @throws std::runtime_error if lane count exceeds the mask width.
+        BasicConflictMatrix(const std::vector<Lane>& lanes, concurrency::WorkStealingPool& pool);
 
         /// Query whether two lanes conflict.
         [[nodiscard]] bool conflicts(std::size_t i, std::size_t j) const noexcept {
             if (i >= n_ || j >= n_) return true;
-            return (mask_[i] >> j) & 1U;
+            return testLane(mask_[i], j);
         }
 
         /// Check whether a set of simultaneously active lanes is conflict-free.
-        [[nodiscard]] bool isFeasible(LaneMask activeMask) const noexcept;
+        [[nodiscard]] bool isFeasible(const Mask& activeMask) const noexcept;
 
         /// Get the conflict mask for a single lane.
-        [[nodiscard]] LaneMask conflictsOf(std::size_t i) const noexcept {
-            if (i >= n_) return ~LaneMask{0};
+        [[nodiscard]] const Mask& conflictsOf(std::size_t i) const noexcept {
+            if (i >= n_) return all_;
             return mask_[i];
         }
 
@@ -40,7 +55,25 @@ namespace tip::model {
 
     private:
         std::size_t n_;
-        std::vector<LaneMask> mask_;
+        std::vector<Mask> mask_;
+        Mask all_; ///< Returned for out-of-range lanes (conflicts with everything)
+
+        BasicConflictMatrix(const std::vector<Lane>& lanes, concurrency::WorkStealingPool* pool);
     };
 
-} -
\ No newline at end of file
+    extern template class BasicConflictMatrix<LaneMask>;
+    extern template class BasicConflictMatrix<LaneBitset<128>>;
+    extern template class BasicConflictMatrix<LaneBitset<256>>;
+    extern template class BasicConflictMatrix<DynamicLaneBitset>;
+
+    /// 64-lane single-word conflict matrix.
+    using ConflictMatrix        = BasicConflictMatrix<LaneMask>;
+    using ConflictMatrix128     = BasicConflictMatrix<LaneBitset<128>>;
+    using ConflictMatrix256     = BasicConflictMatrix<LaneBitset<256>>;
+    using DynamicConflictMatrix = BasicConflictMatrix<DynamicLaneBitset>;
+
+    /// Narrowest conflict matrix for a topology with at most MaxLanes lanes.
+    template <std::size_t MaxLanes>
+    using ConflictMatrixFor = BasicConflictMatrix<LaneMaskFor<MaxLanes>>;
+
+}
@@ -1,24 +1,31 @@
 #pragma once
 #include "Phase.hpp"
+#include "PhaseNames.hpp"
 #include "SignalPhase.hpp"
 #include "PriorityReason.hpp"
 
 #include <string>
+#include <string_view>
 #include <cstdint>
+#include <type_traits>
 
 namespace tip::model {
 
     /// Encapsulates the engine's decision for the current cycle.
+    /// Trivially copyable (32 bytes); the phase name is an interned id.
     struct Decision {
         std::size_t     selectedPhaseIndex = 0;      /// Index into the phase plan
-        std::string     phaseName;                    /// Human-readable phase name
-        SignalPhase     signalState = SignalPhase::GREEN;
         double          phaseScore  = 0.0;            /// Computed adaptive score
+        PhaseNameId     phaseNameId = NO_PHASE_NAME;  /// Interned phase name (see PhaseNames.h)
         uint32_t        greenDuration = 0;            /// Computed green time (seconds)
+        SignalPhase     signalState = SignalPhase::GREEN;
         PriorityReason  activePriority = PriorityReason::NONE;
 
+        /// Human-readable phase name.
+        [[nodiscard]] std::string_view phaseName() const { return phaseNameOf(phaseNameId); }
+
         [[nodiscard]] std::string summary() const {
-            return "Phase: " + phaseName
+            return "Phase: " + std::string(phaseName())
                  + " | Signal: " + to_string(signalState)
                  + " | Score: " + std::to_string(phaseScore)
                  + " | Green: " + std::to_string(greenDuration) + "s"
@@ -26,4 +33,6 @@ namespace tip::model {
         }
     };
 
+    static_assert(std::is_trivially_copyable_v<Decision>);
+
 }
\ No newline at end of file
@@ -1,9 +1,34 @@
 #pragma once
 #include "Point.hpp"
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace tip::model {
 
+    /// Axis-aligned bounding box. Default-constructed boxes are empty and
+    /// overlap nothing.
+    struct BoundingBox {
+        double minX =  std::numeric_limits<double>::infinity();
+        double minY =  std::numeric_limits<double>::infinity();
+        double maxX = -std::numeric_limits<double>::infinity();
+        double maxY = -std::numeric_limits<double>::infinity();
+
+        /// Grow to include point p.
+        void expand(const Point& p) noexcept {
+            minX = std::min(minX, p.x);
+            minY = std::min(minY, p.y);
+            maxX = std::max(maxX, p.x);
+            maxY = std::max(maxY, p.y);
+        }
+
+        /// Closed-interval overlap test; any shared point counts.
+        [[nodiscard]] bool overlaps(const BoundingBox& o) const noexcept {
+            return minX <= o.maxX && o.minX <= maxX
+                && minY <= o.maxY && o.minY <= maxY;
+        }
+    };
+
     /// Test whether segment (p1 -> p2) intersects segment (p3 -> p4).
     /// Uses the standard cross-product orientation method.
     /// Returns true for proper intersections (excludes shared endpoints).
@@ -0,0 +1,264 @@
+#pragma once
+/// Lane-set bitmasks of selectable width.
+///
+///   - LaneMask (uint64_t):   up to 64 lanes, single-word fast path
+///   - LaneBitset<128/256>:   fixed multi-word masks for known large topologies
+///   - DynamicLaneBitset:     unbounded fallback, grows on demand
+///
+/// Generic code uses the free functions below (setLane, testLane, intersects,
+/// andNot, forEachLane, ...) so one implementation serves every width, and the
+/// uint64_t overloads compile to the same single-word operations as before.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tip::model {
+
+    /// Bitmask type — supports up to 64 lanes.
+    using LaneMask = uint64_t;
+
+    inline constexpr std::size_t MAX_MASK_LANES = 64;
+
+    /// Lane count that selects DynamicLaneBitset in LaneMaskFor.
+    inline constexpr std::size_t DYNAMIC_LANES = std::numeric_limits<std::size_t>::max();
+
+    /// Returned by firstLane() for an empty mask.
+    inline constexpr std::size_t NO_LANE = std::numeric_limits<std::size_t>::max();
+
+    /// Single-lane mask for lane index i.
+    [[nodiscard]] constexpr LaneMask laneBit(std::size_t i) noexcept {
+        return LaneMask{1} << i;
+    }
+
+    /// Invoke fn(laneIndex) for every set bit, lowest index first.
+    template <typename Fn>
+    constexpr void forEachLane(LaneMask mask, Fn&& fn) {
+        while (mask) {
+            fn(static_cast<std::size_t>(std::countr_zero(mask)));
+            mask &= mask - 1; // clear lowest set bit
+        }
+    }
+
+    // --- Single-word operations ---
+
+    constexpr void setLane(LaneMask& m, std::size_t i) noexcept { m |= laneBit(i); }
+    [[nodiscard]] constexpr bool testLane(LaneMask m, std::size_t i) noexcept { return (m >> i) & 1U; }
+    [[nodiscard]] constexpr bool anyLane(LaneMask m) noexcept { return m != 0; }
+    [[nodiscard]] constexpr bool intersects(LaneMask a, LaneMask b) noexcept { return (a & b) != 0; }
+    [[nodiscard]] constexpr LaneMask andNot(LaneMask a, LaneMask b) noexcept { return a & ~b; }
+    [[nodiscard]] constexpr std::size_t laneCount(LaneMask m) noexcept {
+        return static_cast<std::size_t>(std::popcount(m));
+    }
+    [[nodiscard]] constexpr std::size_t firstLane(LaneMask m) noexcept {
+        return m ? static_cast<std::size_t>(std::countr_zero(m)) : NO_LANE;
+    }
+
+    /// Fixed-width multi-word lane mask.
+    template <std::size_t Bits>
+    class LaneBitset {
+        static_assert(Bits % 64 == 0 && Bits > 64, "LaneBitset width must be a multiple of 64 above 64");
+        static constexpr std::size_t WORDS = Bits / 64;
+
+    public:
+        static constexpr std::size_t capacity = Bits;
+
+        constexpr void set(std::size_t i) noexcept { w_[i >> 6] |= uint64_t{1} << (i & 63); }
+        [[nodiscard]] constexpr bool test(std::size_t i) const noexcept {
+            return i < Bits && ((w_[i >> 6] >> (i & 63)) & 1U);
+        }
+        [[nodiscard]] constexpr bool any() const noexcept {
+            return std::any_of(w_.begin(), w_.end(), [](uint64_t w) { return w != 0; });
+        }
+        [[nodiscard]] constexpr std::size_t count() const noexcept {
+            std::size_t n = 0;
+            for (auto w : w_) n += static_cast<std::size_t>(std::popcount(w));
+            return n;
+        }
+        [[nodiscard]] constexpr bool intersects(const LaneBitset& o) const noexcept {
+            for (std::size_t k = 0; k < WORDS; ++k) {
+                if (w_[k] & o.w_[k]) return true;
+            }
+            return false;
+        }
+        [[nodiscard]] constexpr LaneBitset andNot(const LaneBitset& o) const noexcept {
+            LaneBitset r;
+            for (std::size_t k = 0; k < WORDS; ++k) r.w_[k] = w_[k] & ~o.w_[k];
+            return r;
+        }
+        [[nodiscard]] constexpr std::size_t first() const noexcept {
+            for (std::size_t k = 0; k < WORDS; ++k) {
+                if (w_[k]) return k * 64 + static_cast<std::size_t>(std::countr_zero(w_[k]));
+            }
+            return NO_LANE;
+        }
+        template <typename Fn>
+        constexpr void forEach(Fn&& fn) const {
+            for (std::size_t k = 0; k < WORDS; ++k) {
+                for (uint64_t w = w_[k]; w; w &= w - 1) {
+                    fn(k * 64 + static_cast<std::size_t>(std::countr_zero(w)));
+                }
+            }
+        }
+
+        /// Mask with every bit set.
+        [[nodiscard]] static constexpr LaneBitset all() noexcept {
+            LaneBitset r;
+            r.w_.fill(~uint64_t{0});
+            return r;
+        }
+
+        constexpr LaneBitset& operator|=(const LaneBitset& o) noexcept {
+            for (std::size_t k = 0; k < WORDS; ++k) w_[k] |= o.w_[k];
+            return *this;
+        }
+        constexpr LaneBitset& operator&=(const LaneBitset& o) noexcept {
+            for (std::size_t k = 0; k < WORDS; ++k) w_[k] &= o.w_[k];
+            return *this;
+        }
+        [[nodiscard]] friend constexpr LaneBitset operator|(LaneBitset a, const LaneBitset& b) noexcept { return a |= b; }
+        [[nodiscard]] friend constexpr LaneBitset operator&(LaneBitset a, const LaneBitset& b) noexcept { return a &= b; }
+        [[nodiscard]] friend constexpr bool operator==(const LaneBitset&, const LaneBitset&) noexcept = default;
+
+    private:
+        std::array<uint64_t, WORDS> w_{};
+    };
+
+    /// Unbounded lane mask; grows when a lane beyond its size is set.
+    /// Missing words compare and combine as zero.
+    class DynamicLaneBitset {
+    public:
+        static constexpr std::size_t capacity = DYNAMIC_LANES;
+
+        DynamicLaneBitset() = default;
+
+        void set(std::size_t i) {
+            if ((i >> 6) >= w_.size()) w_.resize((i >> 6) + 1, 0);
+            w_[i >> 6] |= uint64_t{1} << (i & 63);
+        }
+        [[nodiscard]] bool test(std::size_t i) const noexcept {
+            return (i >> 6) < w_.size() && ((w_[i >> 6] >> (i & 63)) & 1U);
+        }
+        [[nodiscard]] bool any() const noexcept {
+            return std::any_of(w_.begin(), w_.end(), [](uint64_t w) { return w != 0; });
+        }
+        [[nodiscard]] std::size_t count() const noexcept {
+            std::size_t n = 0;
+            for (auto w : w_) n += static_cast<std::size_t>(std::popcount(w));
+            return n;
+        }
+        [[nodiscard]] bool intersects(const DynamicLaneBitset& o) const noexcept {
+            const std::size_t n = std::min(w_.size(), o.w_.size());
+            for (std::size_t k = 0; k < n; ++k) {
+                if (w_[k] & o.w_[k]) return true;
+            }
+            return false;
+        }
+        [[nodiscard]] DynamicLaneBitset andNot(const DynamicLaneBitset& o) const {
+            DynamicLaneBitset r = *this;
+            const std::size_t n = std::min(w_.size(), o.w_.size());
+            for (std::size_t k = 0; k < n; ++k) r.w_[k] &= ~o.w_[k];
+            return r;
+        }
+        [[nodiscard]] std::size_t first() const noexcept {
+            for (std::size_t k = 0; k < w_.size(); ++k) {
+                if (w_[k]) return k * 64 + static_cast<std::size_t>(std::countr_zero(w_[k]));
+            }
+            return NO_LANE;
+        }
+        template <typename Fn>
+        void forEach(Fn&& fn) const {
+            for (std::size_t k = 0; k < w_.size(); ++k) {
+                for (uint64_t w = w_[k]; w; w &= w - 1) {
+                    fn(k * 64 + static_cast<std::size_t>(std::countr_zero(w)));
+                }
+            }
+        }
+
+        /// Mask with lanes [0, n) set.
+        [[nodiscard]] static DynamicLaneBitset all(std::size_t n) {
+            DynamicLaneBitset r;
+            r.w_.assign((n + 63) / 64, ~uint64_t{0});
+            if (n % 64) r.w_.back() = (uint64_t{1} << (n % 64)) - 1;
+            return r;
+        }
+
+        DynamicLaneBitset& operator|=(const DynamicLaneBitset& o) {
+            if (o.w_.size() > w_.size()) w_.resize(o.w_.size(), 0);
+            for (std::size_t k = 0; k < o.w_.size(); ++k) w_[k] |= o.w_[k];
+            return *this;
+        }
+        DynamicLaneBitset& operator&=(const DynamicLaneBitset& o) noexcept {
+            for (std::size_t k = 0; k < w_.size(); ++k) w_[k] &= k < o.w_.size() ? o.w_[k] : 0;
+            return *this;
+        }
+        [[nodiscard]] friend DynamicLaneBitset operator|(DynamicLaneBitset a, const DynamicLaneBitset& b) { return a |= b; }
+        [[nodiscard]] friend DynamicLaneBitset operator&(DynamicLaneBitset a, const DynamicLaneBitset& b) { return a &= b; }
+        [[nodiscard]] friend bool operator==(const DynamicLaneBitset& a, const DynamicLaneBitset& b) noexcept {
+            const auto& lo = a.w_.size() <= b.w_.size() ? a.w_ : b.w_;
+            const auto& hi = a.w_.size() <= b.w_.size() ? b.w_ : a.w_;
+            return std::equal(lo.begin(), lo.end(), hi.begin())
+                && std::all_of(hi.begin() + static_cast<std::ptrdiff_t>(lo.size()), hi.end(),
+                               [](uint64_t w) { return w == 0; });
+        }
+
+    private:
+        std::vector<uint64_t> w_;
+    };
+
+    // --- Multi-word operations (same names as the single-word overloads) ---
+
+    template <typename Mask>
+    concept WideLaneMask = std::is_same_v<Mask, DynamicLaneBitset>
+                        || std::is_same_v<Mask, LaneBitset<Mask::capacity>>;
+
+    template <WideLaneMask Mask>
+    void setLane(Mask& m, std::size_t i) { m.set(i); }
+    template <WideLaneMask Mask>
+    [[nodiscard]] bool testLane(const Mask& m, std::size_t i) noexcept { return m.test(i); }
+    template <WideLaneMask Mask>
+    [[nodiscard]] bool anyLane(const Mask& m) noexcept { return m.any(); }
+    template <WideLaneMask Mask>
+    [[nodiscard]] bool intersects(const Mask& a, const Mask& b) noexcept { return a.intersects(b); }
+    template <WideLaneMask Mask>
+    [[nodiscard]] Mask andNot(const Mask& a, const Mask& b) { return a.andNot(b); }
+    template <WideLaneMask Mask>
+    [[nodiscard]] std::size_t laneCount(const Mask& m) noexcept { return m.count(); }
+    template <WideLaneMask Mask>
+    [[nodiscard]] std::size_t firstLane(const Mask& m) noexcept { return m.first(); }
+    template <WideLaneMask Mask, typename Fn>
+    void forEachLane(const Mask& m, Fn&& fn) { m.forEach(std::forward<Fn>(fn)); }
+
+    /// Width-specific constants for generic code.
+    template <typename Mask>
+    struct LaneMaskTraits {
+        static constexpr std::size_t capacity = Mask::capacity;
+        /// Mask treating every lane of an n-lane intersection as set.
+        [[nodiscard]] static Mask all(std::size_t n) {
+            if constexpr (std::is_same_v<Mask, DynamicLaneBitset>) return Mask::all(n);
+            else return Mask::all();
+        }
+    };
+
+    template <>
+    struct LaneMaskTraits<LaneMask> {
+        static constexpr std::size_t capacity = MAX_MASK_LANES;
+        [[nodiscard]] static constexpr LaneMask all(std::size_t) noexcept { return ~LaneMask{0}; }
+    };
+
+    /// Narrowest mask type that holds MaxLanes lanes, chosen at compile time.
+    /// DYNAMIC_LANES (or anything above 256) falls back to DynamicLaneBitset.
+    template <std::size_t MaxLanes>
+    using LaneMaskFor =
+        std::conditional_t<(MaxLanes <= 64),  LaneMask,
+        std::conditional_t<(MaxLanes <= 128), LaneBitset<128>,
+        std::conditional_t<(MaxLanes <= 256), LaneBitset<256>,
+                                              DynamicLaneBitset>>>;
+
+}
@@ -1,18 +1,37 @@
 #pragma once
+#include "LaneMask.hpp"
+#include "PhaseNames.hpp"
+
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <stdexcept>
 
 namespace tip::model {
 
     /// A structured phase representing a compatible group of lanes.
-    struct Phase {
+    template <typename Mask>
+    struct BasicPhase {
         std::string              name;       ///< Human-readable label (e.g., "NS-through")
+        PhaseNameId              nameId = NO_PHASE_NAME; ///< Interned name, carried by Decision
         std::vector<std::size_t> laneIndices; ///< Indices into the lane vector
+        Mask                     mask{};     ///< Same lanes as a bitmask (bit i = lane i)
 
-        Phase() = default;
-        Phase(std::string n, std::vector<std::size_t> idx)
-            : name(std::move(n)), laneIndices(std::move(idx)) {}
+        BasicPhase() = default;
+        BasicPhase(std::string n, std::vector<std::size_t> idx)
+            : name(std::move(n)), nameId(internPhaseName(name)), laneIndices(std::move(idx))
+        {
+            for (auto i : laneIndices) {
+                if (i >= LaneMaskTraits<Mask>::capacity) {
+                    throw std::out_of_range("Phase: lane index " + std::to_string(i) +
+                                            " exceeds LaneMask width");
+                }
+                setLane(mask, i);
+            }
+        }
     };
 
-}
\ No newline at end of file
+    /// Phase over the 64-lane single-word mask.
+    using Phase = BasicPhase<LaneMask>;
+
+}
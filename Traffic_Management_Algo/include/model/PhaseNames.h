@@ -0,0 +1,28 @@
+#pragma once
+/// Process-wide interned phase names.
+///
+/// Decisions carry a PhaseNameId instead of a string so the step/tick hot
+/// path never allocates; names are resolved only where they are displayed or
+/// serialized. Interning happens when phases are built and is thread-safe.
+/// Dynamic phases all share DYNAMIC_PHASE_NAME, so the table stays bounded
+/// by the planned phases; TrafficEngine::phaseName() spells out their lanes.
+/// Resolved names stay valid for the lifetime of the process.
+
+#include <cstdint>
+#include <string_view>
+
+namespace tip::model {
+
+    using PhaseNameId = uint32_t;
+
+    inline constexpr PhaseNameId NO_PHASE_NAME      = 0; ///< ""
+    inline constexpr PhaseNameId WAITING_PHASE_NAME = 1; ///< "WAITING" (intersection not yet active)
+    inline constexpr PhaseNameId DYNAMIC_PHASE_NAME = 2; ///< "DYN" (lane set chosen by the dynamic search)
+
+    /// Id for name, adding it to the table on first use.
+    [[nodiscard]] PhaseNameId internPhaseName(std::string_view name);
+
+    /// Name for id, or "" for ids that were never issued.
+    [[nodiscard]] std::string_view phaseNameOf(PhaseNameId id);
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+/// Spatial index over one lane centerline for fast pairwise conflict tests.
+///
+/// Segments are stored with their bounding boxes, sorted by minX. Two indexed
+/// polylines are tested with:
+///   - Broad phase: whole-polyline bounding boxes must overlap
+///   - Clipping: only segments overlapping the other polyline's box take part
+///   - Sweep-line over x: each segment is tested only against segments of the
+///     other polyline whose x-extent is still active
+/// The exact test is segmentsIntersect(), so results match polylinesIntersect().
+
+#include "Point.hpp"
+#include "Geometry.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace tip::model {
+
+    class PolylineIndex {
+    public:
+        PolylineIndex() = default;
+
+        /// Index a polyline. The path must outlive the index.
+        explicit PolylineIndex(const std::vector<Point>& path);
+
+        /// Bounding box of the whole polyline (empty for fewer than 2 points).
+        [[nodiscard]] const BoundingBox& bounds() const noexcept { return bounds_; }
+
+        /// Number of segments.
+        [[nodiscard]] std::size_t segmentCount() const noexcept { return segments_.size(); }
+
+        /// Same result as polylinesIntersect() on the two source paths.
+        [[nodiscard]] bool intersects(const PolylineIndex& other) const;
+
+    private:
+        struct Segment {
+            BoundingBox box;
+            std::size_t start; ///< Segment is path[start] → path[start + 1]
+        };
+
+        const std::vector<Point>* path_ = nullptr;
+        BoundingBox               bounds_;
+        std::vector<Segment>      segments_; ///< Sorted by box.minX
+
+        [[nodiscard]] bool segmentsHit(const Segment& a, const PolylineIndex& other,
+                                       const Segment& b) const noexcept;
+    };
+
+}
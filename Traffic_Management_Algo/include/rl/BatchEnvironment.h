@@ -0,0 +1,150 @@
+#pragma once
+/// Batched training environment: K copies of one intersection stepped in
+/// lockstep.
+///
+/// Every environment runs the Simulator's traffic model on its own engine:
+/// Poisson arrivals on each lane, one engine step, then saturation-flow
+/// discharge on green lanes. step() first applies one TuningAction per
+/// environment (read from the actions() buffer, clamped as RLAgent::apply
+/// does), then runs ticksPerStep ticks and writes observations, rewards and
+/// episode-end flags into preallocated buffers. Nothing is allocated per
+/// step or episode reset; engines in dynamic phase mode allocate only while
+/// their search scratch and dynamic slots warm up.
+///
+/// Buffers are row-major and cache-line aligned; they stay at the same
+/// address for the object's lifetime, so callers may keep views of them:
+///   observations  float [batch, lanes, FEATURE_COUNT]
+///   actions       float [batch, ACTION_SIZE]  (deltaAlpha, deltaBeta, deltaGreenPerVeh)
+///   rewards       float [batch]
+///   dones         uint8 [batch]
+///
+/// Each environment draws arrivals from its own generator seeded from
+/// (seed, index), so results are identical for any thread count.
+
+#include "../concurrency/CacheAligned.hpp"
+#include "../concurrency/WorkStealingPool.hpp"
+#include "../engine/EngineConfig.hpp"
+#include "../engine/EngineState.hpp"
+#include "../engine/LaneDelta.hpp"
+#include "../engine/TrafficEngine.hpp"
+#include "../model/Lane.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace tip::rl {
+
+    /// Per-lane observation features, innermost dimension of observations().
+    enum ObservationFeature : std::size_t {
+        FEATURE_QUEUE_LENGTH = 0,  ///< Vehicles queued
+        FEATURE_WAIT_COUNTER = 1,  ///< Cycles since the lane was served
+        FEATURE_BLE_BOOST    = 2,  ///< Accumulated BLE boost
+        FEATURE_GREEN        = 3,  ///< 1 if the lane has green, else 0
+        FEATURE_COUNT        = 4,
+    };
+
+    /// Floats per environment in actions(), in TuningAction field order.
+    inline constexpr std::size_t ACTION_SIZE = 3;
+
+    struct BatchConfig {
+        uint32_t    ticksPerStep   = 10;    ///< Simulated seconds per step()
+        uint32_t    episodeTicks   = 3600;  ///< Episode length; environments reset automatically after
+        double      arrivalRate    = 0.1;   ///< Mean arrivals per lane per second
+        double      saturationFlow = 0.5;   ///< Departures per green second per lane
+        uint32_t    laneCapacity   = 250;   ///< Vehicles a lane can store; further arrivals are blocked
+        uint64_t    seed           = 1;
+        std::size_t threads        = 1;     ///< 1 steps serially; 0 = hardware threads
+    };
+
+    class BatchEnvironment {
+    public:
+        template <typename T>
+        using AlignedVector = std::vector<T, concurrency::CacheAlignedAllocator<T>>;
+
+        /// Build batch engines over copies of lanes and config and reset them.
+        /// @throws std::invalid_argument on an empty batch, zero ticksPerStep or
+        ///         episodeTicks, or rates outside [0, 10] per second.
+        BatchEnvironment(std::vector<model::Lane> lanes, engine::EngineConfig config,
+                         std::size_t batch, BatchConfig batchConfig = {});
+        ~BatchEnvironment();
+
+        BatchEnvironment(const BatchEnvironment&) = delete;
+        BatchEnvironment& operator=(const BatchEnvironment&) = delete;
+
+        /// Restart every episode from the initial lanes and configuration and
+        /// write fresh observations. Rewards and dones are cleared; generators
+        /// carry on, so episodes after a reset see new arrivals.
+        void reset();
+
+        /// Apply actions() and advance every environment by ticksPerStep ticks.
+        /// An episode ends at the first step boundary at or past episodeTicks;
+        /// the environment is then reset in place, its done flag set and its
+        /// observation the first of the next episode. Rewards are minus the
+        /// mean queue per lane over the step's ticks.
+        /// @throws std::invalid_argument if an action is not finite.
+        void step();
+
+        /// Set the number of threads used by step() and reset().
+        void setThreadCount(std::size_t threads);
+
+        [[nodiscard]] std::size_t threadCount() const noexcept {
+            return pool_ ? pool_->threadCount() : 1;
+        }
+
+        [[nodiscard]] std::span<float> actions() noexcept { return actions_; }
+        [[nodiscard]] std::span<const float> observations() const noexcept { return observations_; }
+        [[nodiscard]] std::span<const float> rewards() const noexcept { return rewards_; }
+        [[nodiscard]] std::span<const uint8_t> dones() const noexcept { return dones_; }
+
+        [[nodiscard]] std::size_t batchSize() const noexcept { return envs_.size(); }
+        [[nodiscard]] std::size_t laneCount() const noexcept { return laneCount_; }
+        [[nodiscard]] const BatchConfig& config() const noexcept { return config_; }
+
+        /// Engine of environment k (e.g., to read its tuned configuration).
+        [[nodiscard]] const engine::TrafficEngine& engine(std::size_t k) const { return envs_.at(k)->engine; }
+
+        /// Episodes finished over all environments since construction.
+        [[nodiscard]] uint64_t episodes() const noexcept;
+
+    private:
+        /// One environment's engine and traffic state. Allocated separately
+        /// so workers never share a cache line.
+        struct alignas(concurrency::CACHE_LINE) Env {
+            engine::TrafficEngine          engine;
+            std::mt19937_64                rng;
+            std::vector<double>            credit;   ///< Fractional departures carried over on green
+            std::vector<engine::LaneDelta> deltas;   ///< Reserved to one per lane
+            uint32_t                       elapsed  = 0;  ///< Ticks into the episode
+            uint64_t                       episodes = 0;
+
+            Env(const std::vector<model::Lane>& lanes, const engine::EngineConfig& config, uint64_t seed);
+        };
+
+        BatchConfig                   config_;
+        engine::EngineConfig          initialConfig_;
+        engine::EngineState           initialState_;
+        std::size_t                   laneCount_   = 0;
+        double                        emptyChance_ = 1.0;  ///< exp(-arrivalRate), P(no arrival)
+        std::vector<std::unique_ptr<Env>> envs_;
+
+        AlignedVector<float>   observations_;
+        AlignedVector<float>   actions_;
+        AlignedVector<float>   rewards_;
+        AlignedVector<uint8_t> dones_;
+
+        std::unique_ptr<concurrency::WorkStealingPool> pool_;  ///< Null in serial mode
+        concurrency::WorkStealingPool::RangeFn stepRange_;      ///< Built once; no per-step std::function
+        concurrency::WorkStealingPool::RangeFn resetRange_;
+
+        void forEachEnv(const concurrency::WorkStealingPool::RangeFn& fn);
+        void stepEnv(std::size_t k);
+        void resetEnv(std::size_t k);
+        void observe(std::size_t k);
+        [[nodiscard]] uint32_t samplePoisson(std::mt19937_64& rng) const;
+    };
+
+}
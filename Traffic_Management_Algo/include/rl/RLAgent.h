@@ -32,6 +32,10 @@ namespace tip::rl {
         /// Observe current state from the engine.
         [[nodiscard]] StateObservation observe(const engine::TrafficEngine& engine) const;
 
+        /// Observe into state, reusing its vectors' capacity (no allocation
+        /// once they have grown to the lane count).
+        void observe(const engine::TrafficEngine& engine, StateObservation& state) const;
+
         /// Compute a tuning action (placeholder: rule-based heuristic).
         [[nodiscard]] TuningAction computeAction(const StateObservation& state) const;
 
@@ -0,0 +1,97 @@
+#pragma once
+/// Single-threaded HTTP/1.1 server on an epoll event loop.
+///
+/// Every loop iteration reads all ready connections, parses every complete
+/// request (keep-alive and pipelining supported), hands them to the handler
+/// as one batch, then writes the responses in per-connection request order.
+/// Batching lets the handler coalesce concurrent requests for the same key.
+///
+/// A connection is not read while it has unsent responses, so a client that
+/// pipelines without reading stalls itself instead of growing server buffers.
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tip::server {
+
+    /// A parsed request. Views stay valid for the duration of the handler call.
+    struct HttpRequest {
+        std::string_view method;
+        std::string_view path;   ///< Target without the query string
+        std::string_view query;  ///< Text after '?', or empty
+        std::string_view body;
+    };
+
+    struct HttpResponse {
+        int         status = 200;
+        std::string body;          ///< JSON
+        std::string_view extraHeaders; ///< Additional "Name: value\r\n" lines
+    };
+
+    /// Fill responses[i] for requests[i].
+    using BatchHandler = std::function<void(std::span<const HttpRequest> requests,
+                                            std::span<HttpResponse> responses)>;
+
+    class HttpServer {
+    public:
+        /// Bind to port on all interfaces (0 picks a free port).
+        /// @throws std::runtime_error if the socket cannot be set up.
+        HttpServer(uint16_t port, BatchHandler handler);
+        ~HttpServer();
+
+        HttpServer(const HttpServer&) = delete;
+        HttpServer& operator=(const HttpServer&) = delete;
+
+        /// Port actually bound.
+        [[nodiscard]] uint16_t port() const noexcept { return port_; }
+
+        /// Serve until stop() is called.
+        void run();
+
+        /// Make run() return. Safe to call from any thread or a signal handler.
+        void stop() noexcept;
+
+        /// Value of a query parameter (percent-decoded), or fallback.
+        [[nodiscard]] static std::string queryParam(std::string_view query, std::string_view name,
+                                                    std::string_view fallback = {});
+
+    private:
+        struct Connection;
+
+        /// Largest accepted request (headers plus body).
+        static constexpr std::size_t MAX_REQUEST_BYTES = 1 << 20;
+
+        /// Most response bytes queued on one connection; a batch that would
+        /// go past it drops the rest of its responses and closes the connection.
+        static constexpr std::size_t MAX_OUTPUT_BYTES = 4 << 20;
+
+        int          listenFd_ = -1;
+        int          epollFd_  = -1;
+        int          stopFd_   = -1;  ///< eventfd that wakes the loop on stop()
+        uint16_t     port_     = 0;
+        BatchHandler handler_;
+        std::vector<std::unique_ptr<Connection>> connections_; ///< Indexed by fd
+
+        // Per-iteration scratch
+        std::vector<HttpRequest>  requests_;
+        std::vector<HttpResponse> responses_;
+        std::vector<Connection*>  owners_;    ///< Connection of each request
+        std::vector<bool>         keepAlive_; ///< Whether each request's connection stays open
+        std::vector<Connection*>  active_;
+
+        void acceptAll();
+        void readAll(Connection& connection);
+        void parse(Connection& connection);
+        void flush(Connection& connection);
+        void watch(Connection& connection);
+        void close(Connection& connection);
+        static void appendResponse(std::string& out, const HttpResponse& response, bool keepAlive);
+    };
+
+}
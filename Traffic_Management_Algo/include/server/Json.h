@@ -0,0 +1,30 @@
+#pragma once
+/// Minimal JSON support for the server's wire format.
+///
+/// Only what /update and /status need: parsing an array of lane inputs
+/// (unknown fields are skipped) and escaping strings for output.
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace tip::server {
+
+    /// One element of an /update body: {"lane_id": str, "normal": int, "emergency": int}.
+    struct LaneInput {
+        std::string lane_id;
+        uint32_t    normal    = 0;
+        uint32_t    emergency = 0;
+    };
+
+    namespace json {
+        /// Parse an /update body into out (cleared first).
+        /// @throws std::invalid_argument with a client-facing message if the body is malformed.
+        void parseLaneInputs(std::string_view body, std::vector<LaneInput>& out);
+
+        /// Append value as a quoted JSON string.
+        void appendString(std::string& out, std::string_view value);
+    }
+
+}
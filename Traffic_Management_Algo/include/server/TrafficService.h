@@ -0,0 +1,92 @@
+#pragma once
+/// Serves the dashboard's /update and /status API on TrafficEngine.
+///
+/// Wire format (same shapes as the Python algo_api.py):
+///   POST /update?intersection=ID   body [{"lane_id", "normal", "emergency"}, ...]
+///        → {"status": "success", "output": {lane_id: {"state": [r, y, g], "wait", "green_time"?}}}
+///   GET  /status?intersection=ID
+///        → {lane_id: {"normal", "emergency", "wait", "state"}}, or {} for an unknown intersection
+/// The intersection parameter defaults to "default".
+///
+/// Each intersection ID owns one engine, rebuilt when its lane set changes.
+/// Every lane becomes its own approach, so the engine's phase plan decides
+/// which lanes may be green together. One update is one engine step.
+///
+/// Consecutive updates for the same intersection in one server batch are
+/// coalesced: their lane values are applied in arrival order, the engine
+/// steps once, and every request gets that step's output. Status requests
+/// in a batch see the batch's updates.
+
+#include "HttpServer.hpp"
+#include "Json.hpp"
+#include "../engine/TrafficEngine.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tip::server {
+
+    class TrafficService {
+    public:
+        /// Engine parameters follow algo_api.py: 3-12 s green, 2 s yellow,
+        /// 2.5 vehicles cleared per green second, no all-red.
+        TrafficService();
+        explicit TrafficService(engine::EngineConfig config) : config_(config) {}
+
+        /// HttpServer batch handler.
+        void handle(std::span<const HttpRequest> requests, std::span<HttpResponse> responses);
+
+        /// Number of intersections with an engine.
+        [[nodiscard]] std::size_t intersectionCount() const noexcept { return intersections_.size(); }
+
+        /// Engine steps run; lower than updates received when batches coalesce.
+        [[nodiscard]] uint64_t stepCount() const noexcept { return steps_; }
+
+    private:
+        struct Intersection {
+            std::vector<std::string>                     laneIds;   ///< Output order (first update's order)
+            std::unordered_map<std::string, std::size_t> laneIndex;
+            std::vector<uint32_t>                        emergency;
+            std::unique_ptr<engine::TrafficEngine>       engine;
+            model::Decision                              decision;
+            bool                                         stepped = false;
+        };
+
+        /// A parsed update waiting for its group's step.
+        struct PendingUpdate {
+            std::string            intersectionId;
+            std::size_t            request = 0;
+            std::vector<LaneInput> lanes;
+        };
+
+        engine::EngineConfig config_;
+        std::unordered_map<std::string, Intersection> intersections_;
+        uint64_t steps_ = 0;
+
+        // Per-batch scratch; pending_ entries are reused across batches
+        std::vector<PendingUpdate> pending_;
+        std::size_t                pendingCount_ = 0;
+        std::vector<std::size_t>   order_;
+        std::vector<std::size_t>   statusRequests_;
+
+        /// Whether inputs name exactly the intersection's lanes.
+        [[nodiscard]] static bool sameLanes(const Intersection& intersection, std::span<const LaneInput> inputs);
+
+        /// Replace the intersection's engine with one for the lanes in inputs.
+        /// @throws std::invalid_argument if the lane set is empty, duplicated, or over 64 lanes.
+        void rebuild(Intersection& intersection, std::span<const LaneInput> inputs) const;
+
+        /// Apply the group's lane values in order, step once, and answer every request in it.
+        void step(Intersection& intersection, std::span<const std::size_t> group,
+                  std::span<HttpResponse> responses);
+
+        void writeStatus(const std::string& id, std::string& body) const;
+
+        [[nodiscard]] static const char* laneState(const Intersection& intersection, std::size_t lane);
+    };
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+/// Runs a road network as shards in separate local processes.
+///
+/// Each shard is a forked process running a NetworkCoordinator over its
+/// nodes. Links between shards become ports: vehicles released onto one are
+/// sent through a lock-free ShmRing to the downstream shard, which adds them
+/// to the destination lane once the link's travel time has passed. Shards
+/// move in lockstep: a shard starts tick t only when every shard has
+/// finished tick t - 1 (a barrier on per-shard counters in shared memory).
+///
+/// Every checkpointInterval ticks a shard writes its full state (engines,
+/// vehicles in transit, ring cursors) into one of two shared-memory buffers,
+/// flips to it and then publishes its ring cursors. When a shard process
+/// dies, the supervisor forks a replacement that resumes from the last
+/// checkpoint and replays the ticks since; its peers only ever saw what was
+/// published with that checkpoint, so the run ends exactly as it would have
+/// without the failure. The interval is at most the shortest cross-shard
+/// link, so flows are published before they are due.
+///
+/// POSIX only (fork, shared anonymous mappings). The supervisor forks, so
+/// call run() while the process has a single thread.
+
+#include "ShmRing.hpp"
+#include "../coordination/NetworkCoordinator.hpp"
+#include "../engine/EngineConfig.hpp"
+#include "../model/Lane.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace tip::shard {
+
+    struct NodeSpec {
+        std::vector<model::Lane> lanes;
+        engine::EngineConfig     config;
+        int32_t                  offsetSeconds = 0;
+        uint32_t                 shard         = 0;  ///< Process that runs the node
+    };
+
+    struct LinkSpec {
+        std::size_t fromNode, fromLane, toNode, toLane;
+        uint32_t    travelSeconds;
+    };
+
+    /// Whole-network description every shard builds its part from.
+    struct NetworkSpec {
+        std::vector<NodeSpec>       nodes;
+        std::vector<LinkSpec>       links;
+        coordination::NetworkConfig network;
+    };
+
+    struct ShardConfig {
+        std::size_t ringCapacity       = 1 << 14;  ///< Records per shard-to-shard ring
+        std::size_t checkpointBytes    = 1 << 22;  ///< Per checkpoint buffer (two per shard)
+        uint32_t    checkpointInterval = 0;        ///< Ticks; 0 = shortest cross-shard link
+        uint32_t    maxRestarts        = 8;        ///< Over the whole run
+        std::size_t threadsPerShard    = 1;        ///< NetworkCoordinator threads in each shard
+    };
+
+    struct ShardResult {
+        coordination::NetworkStats stats;   ///< Of the shard's own network
+        uint64_t decisionDigest = 0;        ///< Order-sensitive hash of every decision (see digestDecision)
+        uint64_t received       = 0;        ///< Vehicles delivered from other shards
+    };
+
+    struct ShardRunResult {
+        std::vector<ShardResult> shards;
+        uint32_t restarts = 0;
+    };
+
+    /// Fold node's decision at tick into digest; shards fold their nodes in
+    /// ascending node order each tick.
+    [[nodiscard]] uint64_t digestDecision(uint64_t digest, uint64_t tick, std::size_t node,
+                                          const model::Decision& decision) noexcept;
+
+    class ShardSupervisor {
+    public:
+        /// Validate the spec and map the shared memory.
+        /// @throws std::invalid_argument if the spec or configuration is inconsistent.
+        /// @throws std::runtime_error if the mapping fails.
+        explicit ShardSupervisor(NetworkSpec spec, ShardConfig config = {});
+        ~ShardSupervisor();
+
+        ShardSupervisor(const ShardSupervisor&) = delete;
+        ShardSupervisor& operator=(const ShardSupervisor&) = delete;
+
+        [[nodiscard]] std::size_t shardCount() const noexcept { return shardCount_; }
+        [[nodiscard]] uint32_t checkpointInterval() const noexcept { return interval_; }
+
+        /// Fault injection: the first process of shard kills itself with
+        /// SIGKILL when it reaches tick.
+        void injectCrash(std::size_t shard, uint64_t tick);
+
+        /// Run ticks global ticks and return per-shard results. Can be called once.
+        /// @throws std::runtime_error if shards fail more than maxRestarts times.
+        [[nodiscard]] ShardRunResult run(uint64_t ticks);
+
+    private:
+        struct Control;
+        /// Link between two shards; node indices are within each shard.
+        struct CrossLink {
+            uint32_t    fromShard, toShard;
+            std::size_t fromLocal, fromLane;
+            std::size_t toLocal, toLane;
+            uint32_t    travelSeconds;
+        };
+
+        NetworkSpec spec_;
+        ShardConfig config_;
+        std::size_t shardCount_ = 0;
+        uint32_t    interval_   = 0;
+        std::vector<CrossLink> crossLinks_;
+        std::vector<std::vector<std::size_t>> shardNodes_;  ///< Global node indices per shard, ascending
+        std::vector<uint64_t> crashTick_;                   ///< UINT64_MAX = none
+
+        // Shared mapping: controls, then checkpoint buffers, then rings
+        void*       memory_ = nullptr;
+        std::size_t mappedBytes_ = 0;
+        std::size_t checkpointOffset_ = 0;
+        std::size_t ringOffset_ = 0;
+        bool        ran_ = false;
+
+        [[nodiscard]] Control& control(std::size_t shard) const noexcept;
+        [[nodiscard]] uint8_t* checkpointBuffer(std::size_t shard, uint64_t which) const noexcept;
+        [[nodiscard]] ShmRing ring(std::size_t from, std::size_t to) const noexcept;
+
+        /// Body of a shard process; never returns.
+        [[noreturn]] void runShard(std::size_t shard, uint64_t ticks, bool firstIncarnation);
+        void shardLoop(std::size_t shard, uint64_t ticks, bool firstIncarnation);
+    };
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+/// Single-producer single-consumer ring of boundary-link flows in memory
+/// shared between processes.
+///
+/// Both cursors count records since creation and are published separately
+/// from the positions a process works at: the producer writes ahead of the
+/// published tail and the consumer reads ahead of the published head, and
+/// each publishes only at a checkpoint. A process restarted from its last
+/// checkpoint therefore resumes from cursors its peers already agree with:
+/// unpublished records are rewritten and unpublished reads repeated.
+
+#include "../concurrency/CacheAligned.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace tip::shard {
+
+    /// Vehicles released onto a cross-shard link.
+    struct FlowRecord {
+        uint32_t link        = 0;  ///< Index into the sharded network's cross links
+        uint32_t vehicles    = 0;
+        uint64_t releaseTick = 0;  ///< Tick the vehicles left the upstream lane
+    };
+
+    class ShmRing {
+    public:
+        static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                      "ShmRing needs address-free 64-bit atomics");
+
+        /// Bytes needed for a ring of capacity records.
+        [[nodiscard]] static constexpr std::size_t bytesFor(std::size_t capacity) noexcept {
+            return sizeof(Header) + capacity * sizeof(FlowRecord);
+        }
+
+        ShmRing() = default;
+
+        /// Initialize an empty ring in memory (cache-line aligned, bytesFor(capacity) long).
+        static ShmRing create(void* memory, std::size_t capacity) {
+            auto* header = new (memory) Header;
+            header->capacity = capacity;
+            return ShmRing(header);
+        }
+
+        /// View a ring created by create(), possibly in another process.
+        static ShmRing attach(void* memory) noexcept {
+            return ShmRing(static_cast<Header*>(memory));
+        }
+
+        [[nodiscard]] std::size_t capacity() const noexcept { return header_->capacity; }
+
+        // --- Producer ---
+
+        /// Write record at cursor and advance it; false if the consumer's
+        /// published head leaves no room.
+        [[nodiscard]] bool tryWrite(uint64_t& cursor, const FlowRecord& record) noexcept {
+            if (cursor - header_->head.load(std::memory_order_acquire) >= header_->capacity) return false;
+            slots()[cursor % header_->capacity] = record;
+            ++cursor;
+            return true;
+        }
+
+        /// Make records before cursor visible to the consumer.
+        void publishTail(uint64_t cursor) noexcept { header_->tail.store(cursor, std::memory_order_release); }
+
+        [[nodiscard]] uint64_t publishedTail() const noexcept {
+            return header_->tail.load(std::memory_order_acquire);
+        }
+
+        // --- Consumer ---
+
+        /// Record at a position below publishedTail().
+        [[nodiscard]] const FlowRecord& at(uint64_t position) const noexcept {
+            return slots()[position % header_->capacity];
+        }
+
+        /// Let the producer reuse slots before cursor.
+        void publishHead(uint64_t cursor) noexcept { header_->head.store(cursor, std::memory_order_release); }
+
+        [[nodiscard]] uint64_t publishedHead() const noexcept {
+            return header_->head.load(std::memory_order_acquire);
+        }
+
+    private:
+        struct alignas(concurrency::CACHE_LINE) Header {
+            alignas(concurrency::CACHE_LINE) std::atomic<uint64_t> head{0};
+            alignas(concurrency::CACHE_LINE) std::atomic<uint64_t> tail{0};
+            std::size_t capacity = 0;
+        };
+
+        Header* header_ = nullptr;
+
+        explicit ShmRing(Header* header) noexcept : header_(header) {}
+
+        [[nodiscard]] FlowRecord* slots() const noexcept {
+            return reinterpret_cast<FlowRecord*>(header_ + 1);
+        }
+    };
+
+}
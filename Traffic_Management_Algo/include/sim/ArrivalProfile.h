@@ -0,0 +1,39 @@
+#pragma once
+/// Per-lane vehicle arrival rates.
+///
+/// Arrivals are Poisson with rate ratePerSecond · hourlyFactors[hour]. An
+/// empty factor table keeps the rate constant over the day.
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace tip::sim {
+
+    struct ArrivalProfile {
+        double              ratePerSecond = 0.1; ///< Mean arrivals per second (λ at factor 1)
+        std::vector<double> hourlyFactors;       ///< 24 multipliers by hour of day, or empty
+
+        /// Constant-rate Poisson arrivals.
+        [[nodiscard]] static ArrivalProfile poisson(double ratePerSecond) {
+            return {ratePerSecond, {}};
+        }
+
+        /// Weekday profile with morning and evening peaks at ratePerSecond.
+        [[nodiscard]] static ArrivalProfile daily(double peakRatePerSecond) {
+            static constexpr std::array<double, 24> WEEKDAY = {
+                0.08, 0.05, 0.04, 0.04, 0.08, 0.25, 0.60, 0.95,
+                1.00, 0.75, 0.60, 0.62, 0.66, 0.64, 0.65, 0.72,
+                0.88, 1.00, 0.90, 0.65, 0.45, 0.35, 0.25, 0.15,
+            };
+            return {peakRatePerSecond, {WEEKDAY.begin(), WEEKDAY.end()}};
+        }
+
+        /// Rate multiplier for a time of day in seconds after midnight.
+        [[nodiscard]] double factorAt(uint32_t secondOfDay) const noexcept {
+            if (hourlyFactors.empty()) return 1.0;
+            return hourlyFactors[(secondOfDay / 3600) % hourlyFactors.size()];
+        }
+    };
+
+}
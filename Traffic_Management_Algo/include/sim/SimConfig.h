@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+
+namespace tip::sim {
+
+    /// Simulator parameters. One simulation tick is one second, like engine ticks.
+    struct SimConfig {
+        uint64_t seed            = 1;      ///< Arrival stream seed; equal seeds give equal runs
+        double   saturationFlow  = 0.5;    ///< Departures per green second per lane (1800 veh/h)
+        uint32_t laneCapacity    = 250;    ///< Vehicles a lane can store; further arrivals are blocked
+        uint32_t startSecond     = 0;      ///< Time of day at tick 0 (seconds after midnight)
+    };
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+/// Macroscopic queue simulator that drives engines with synthetic traffic.
+///
+/// Each tick:
+///   1. Poisson arrivals join every lane queue (blocked at laneCapacity)
+///   2. The CorridorCoordinator steps every engine on the updated queues
+///   3. Lanes of each GREEN phase discharge at saturation flow
+///
+/// Arrivals draw from one seeded generator in intersection and lane order,
+/// so a run is reproducible for a given seed at any corridor thread count.
+
+#include "SimConfig.hpp"
+#include "ArrivalProfile.hpp"
+#include "../coordination/CorridorCoordinator.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace tip::sim {
+
+    /// Cumulative counters over a run.
+    struct SimStats {
+        uint64_t ticks      = 0;
+        uint64_t arrivals   = 0;   ///< Vehicles that joined a queue
+        uint64_t blocked    = 0;   ///< Arrivals turned away by full lanes
+        uint64_t departures = 0;   ///< Vehicles discharged on green
+        uint64_t queuedVehicleSeconds = 0; ///< Sum of all queues over all ticks (total delay)
+
+        /// Mean delay per departed vehicle in seconds.
+        [[nodiscard]] double meanDelay() const noexcept {
+            return departures ? static_cast<double>(queuedVehicleSeconds) / static_cast<double>(departures) : 0.0;
+        }
+    };
+
+    class Simulator {
+    public:
+        explicit Simulator(SimConfig config = {});
+
+        /// Add an engine with one arrival profile for every lane.
+        /// @throws std::invalid_argument if profiles.size() differs from the engine's lane count.
+        void addIntersection(std::shared_ptr<engine::TrafficEngine> engine,
+                             int32_t offsetSeconds,
+                             std::vector<ArrivalProfile> profiles);
+
+        /// Add an engine whose lanes all share one arrival profile.
+        void addIntersection(std::shared_ptr<engine::TrafficEngine> engine,
+                             int32_t offsetSeconds,
+                             const ArrivalProfile& profile);
+
+        /// Advance the simulation by one second.
+        void tick();
+
+        /// Advance the simulation by ticks seconds.
+        void run(uint64_t ticks);
+
+        /// Corridor driving the engines (e.g., to set its thread count).
+        [[nodiscard]] coordination::CorridorCoordinator& corridor() noexcept { return corridor_; }
+
+        /// Decisions from the latest tick, one per intersection.
+        [[nodiscard]] const coordination::DecisionBuffer& lastDecisions() const noexcept {
+            return corridor_.lastDecisions();
+        }
+
+        [[nodiscard]] const SimStats& stats() const noexcept { return stats_; }
+        [[nodiscard]] uint64_t now() const noexcept { return stats_.ticks; }
+        [[nodiscard]] std::size_t size() const noexcept { return engines_.size(); }
+
+    private:
+        SimConfig                          config_;
+        coordination::CorridorCoordinator  corridor_;
+        std::vector<std::shared_ptr<engine::TrafficEngine>> engines_;
+        std::mt19937_64                    rng_;
+        SimStats                           stats_;
+
+        // Per-lane columns over all intersections; lanes of intersection i
+        // start at laneBase_[i]
+        std::vector<std::size_t>    laneBase_;
+        std::vector<ArrivalProfile> profiles_;
+        std::vector<double>         lambda_;       ///< Arrivals per tick at the current hour
+        std::vector<double>         emptyChance_;  ///< exp(-lambda_), P(no arrival)
+        std::vector<double>         credit_;       ///< Fractional departures carried over on green
+        uint32_t                    ratesHour_ = std::numeric_limits<uint32_t>::max(); ///< Hour lambda_ was computed for
+        std::vector<engine::LaneDelta> deltas_;    ///< Queue changes for one intersection
+
+        void updateRates(uint32_t secondOfDay);
+        void arrive();
+        void discharge();
+
+        /// Poisson draw for lane l by inversion (expected λ + 1 iterations).
+        [[nodiscard]] uint32_t samplePoisson(std::size_t l);
+    };
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+/// On-disk layout of decision trace files (format version 1).
+///
+/// A trace is a FileHeader followed by chunks. Each chunk is a ChunkHeader and
+/// payloadBytes of payload:
+///   - PHASE_NAMES: count entries of (varint id, varint length, bytes); every
+///     name id used by a later DECISIONS chunk is defined first
+///   - DECISIONS: count records of one engine, stored column by column, each
+///     column prefixed by its varint byte length:
+///       tick (zigzag delta from previous, starting at firstTick), phase index,
+///       phase name id, signal state, active priority, green duration,
+///       phase score (bits XOR previous score bits), then per lane over all
+///       records: queue length and wait counter (zigzag deltas), BLE boost
+///       (bits XOR previous), priority
+/// Integers are LEB128 varints; header fields are little-endian.
+
+#include "../model/PriorityReason.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace tip::trace {
+
+    static_assert(std::endian::native == std::endian::little,
+                  "trace headers are written in host order and the format is little-endian");
+
+    inline constexpr char     MAGIC[8]       = {'T', 'I', 'P', 'T', 'R', 'A', 'C', 'E'};
+    inline constexpr uint32_t FORMAT_VERSION = 1;
+
+    enum class ChunkKind : uint32_t {
+        PHASE_NAMES = 1,
+        DECISIONS   = 2
+    };
+
+    struct FileHeader {
+        char     magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    struct ChunkHeader {
+        ChunkKind kind;
+        uint32_t  engineId;     ///< DECISIONS only
+        uint32_t  count;        ///< Records or names
+        uint32_t  laneCount;    ///< DECISIONS only
+        uint64_t  firstTick;
+        uint64_t  lastTick;
+        uint64_t  payloadBytes;
+    };
+
+    static_assert(sizeof(FileHeader) == 16 && sizeof(ChunkHeader) == 40);
+
+    /// Lane inputs captured with each decision.
+    struct LaneSample {
+        uint32_t              queueLength    = 0;
+        uint32_t              waitCounter    = 0;
+        double                bleBoost       = 0.0;
+        model::PriorityReason priorityReason = model::PriorityReason::NONE;
+    };
+
+    namespace encoding {
+
+        inline void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+            while (v >= 0x80) {
+                out.push_back(static_cast<uint8_t>(v) | 0x80);
+                v >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(v));
+        }
+
+        /// Read a varint from [pos, end).
+        /// @throws std::runtime_error on truncated input.
+        inline uint64_t getVarint(const uint8_t*& pos, const uint8_t* end) {
+            uint64_t v = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                if (pos == end) throw std::runtime_error("trace: truncated varint");
+                const uint8_t byte = *pos++;
+                v |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return v;
+            }
+            throw std::runtime_error("trace: malformed varint");
+        }
+
+        [[nodiscard]] constexpr uint64_t zigzag(int64_t v) noexcept {
+            return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+        }
+
+        [[nodiscard]] constexpr int64_t unzigzag(uint64_t v) noexcept {
+            return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+        }
+
+    }
+
+}
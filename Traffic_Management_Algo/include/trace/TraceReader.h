@@ -0,0 +1,88 @@
+#pragma once
+/// Memory-mapped reader for decision trace files.
+///
+/// Opening maps the file, checks the header and indexes the chunk headers;
+/// payloads are decoded only for chunks a query touches. Phase names stored
+/// in the file are interned on open, so decoded decisions resolve
+/// phaseName() like live ones.
+
+#include "TraceFormat.hpp"
+#include "../model/Decision.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace tip::trace {
+
+    /// One decoded decision. lanes is valid until the next record is delivered.
+    struct TraceRecord {
+        uint32_t                    engineId = 0;
+        uint64_t                    tick     = 0;
+        model::Decision             decision;
+        std::span<const LaneSample> lanes;
+    };
+
+    class TraceReader {
+    public:
+        /// Map and index a trace file.
+        /// @throws std::runtime_error if the file is missing, of another version, or corrupt.
+        explicit TraceReader(const std::string& path);
+        ~TraceReader();
+
+        TraceReader(const TraceReader&) = delete;
+        TraceReader& operator=(const TraceReader&) = delete;
+
+        /// Number of decision records in the file.
+        [[nodiscard]] std::size_t recordCount() const noexcept { return recordCount_; }
+
+        /// Tick range covered by the file (both 0 when empty).
+        [[nodiscard]] uint64_t firstTick() const noexcept { return firstTick_; }
+        [[nodiscard]] uint64_t lastTick() const noexcept { return lastTick_; }
+
+        /// Call fn(const TraceRecord&) for every record with fromTick <= tick <= toTick,
+        /// chunk by chunk in file order (in tick order within each engine).
+        template <typename Fn>
+        void forEachInRange(uint64_t fromTick, uint64_t toTick, Fn&& fn) const {
+            for (std::size_t c = 0; c < chunks_.size(); ++c) {
+                const auto& header = chunks_[c].header;
+                if (header.lastTick < fromTick || header.firstTick > toTick) continue;
+                decode(c);
+                TraceRecord record;
+                record.engineId = header.engineId;
+                for (std::size_t r = 0; r < header.count; ++r) {
+                    if (ticks_[r] < fromTick || ticks_[r] > toTick) continue;
+                    record.tick     = ticks_[r];
+                    record.decision = decisions_[r];
+                    record.lanes    = {samples_.data() + r * header.laneCount, header.laneCount};
+                    fn(record);
+                }
+            }
+        }
+
+    private:
+        struct Chunk {
+            ChunkHeader    header;
+            const uint8_t* payload;
+        };
+
+        void*              mapping_ = nullptr;
+        std::size_t        mappingSize_ = 0;
+        std::vector<Chunk> chunks_;         ///< DECISIONS chunks only
+        std::vector<model::PhaseNameId> nameIds_; ///< File name id → process name id
+        std::size_t        recordCount_ = 0;
+        uint64_t           firstTick_ = 0;
+        uint64_t           lastTick_  = 0;
+
+        // Decode scratch for the current chunk
+        mutable std::vector<uint64_t>        ticks_;
+        mutable std::vector<model::Decision> decisions_;
+        mutable std::vector<LaneSample>      samples_;
+
+        void readNames(const ChunkHeader& header, const uint8_t* pos, const uint8_t* end);
+        void decode(std::size_t chunk) const;
+    };
+
+}
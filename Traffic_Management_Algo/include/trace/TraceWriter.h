@@ -0,0 +1,97 @@
+#pragma once
+/// Appends engine decisions and their lane inputs to a binary trace file.
+///
+/// Each engine records into its own EngineRecorder, a columnar append buffer
+/// that encodes and writes one DECISIONS chunk whenever it fills. Recorders
+/// of different engines may be used from different threads; chunk writes are
+/// serialized by the writer. Recording does not allocate once buffers reach
+/// their chunk capacity.
+
+#include "TraceFormat.hpp"
+#include "../model/Decision.hpp"
+#include "../model/Lane.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace tip::trace {
+
+    class TraceWriter;
+
+    /// Per-engine append buffer. Use from one thread at a time.
+    class EngineRecorder {
+    public:
+        /// Append one decision with the lane state it was made from.
+        /// Ticks should not decrease between records.
+        /// @throws std::invalid_argument if lanes.size() differs from the recorder's lane count.
+        void record(uint64_t tick, const model::Decision& decision, std::span<const model::Lane> lanes);
+
+        /// Write buffered records as a chunk.
+        void flush();
+
+        [[nodiscard]] uint32_t engineId() const noexcept { return engineId_; }
+        [[nodiscard]] std::size_t laneCount() const noexcept { return laneCount_; }
+
+    private:
+        friend class TraceWriter;
+        EngineRecorder(TraceWriter& writer, uint32_t engineId, std::size_t laneCount, std::size_t capacity);
+
+        TraceWriter& writer_;
+        uint32_t     engineId_;
+        std::size_t  laneCount_;
+        std::size_t  capacity_;
+
+        // Buffered columns (lane columns are record-major)
+        std::vector<uint64_t>        ticks_;
+        std::vector<model::Decision> decisions_;
+        std::vector<LaneSample>      lanes_;
+
+        // Encoding scratch, reused across chunks
+        std::vector<uint8_t> payload_;
+        std::vector<uint8_t> column_;
+    };
+
+    class TraceWriter {
+    public:
+        /// Create (truncate) path and write the file header.
+        /// @throws std::runtime_error if the file cannot be created.
+        explicit TraceWriter(const std::string& path, std::size_t recordsPerChunk = 4096);
+
+        /// Flushes every recorder.
+        ~TraceWriter();
+
+        TraceWriter(const TraceWriter&) = delete;
+        TraceWriter& operator=(const TraceWriter&) = delete;
+
+        /// Recorder for engineId, created on first use. Thread-safe.
+        /// @throws std::invalid_argument if laneCount differs from the recorder's.
+        EngineRecorder& recorder(uint32_t engineId, std::size_t laneCount);
+
+        /// Flush every recorder. Must not race with record() calls.
+        void flush();
+
+    private:
+        friend class EngineRecorder;
+
+        std::mutex                                      mutex_;
+        std::ofstream                                   out_;
+        std::string                                     path_;
+        std::size_t                                     recordsPerChunk_;
+        std::unordered_set<model::PhaseNameId>          namesWritten_;
+        std::vector<uint8_t>                            namesPayload_;
+        std::map<uint32_t, std::unique_ptr<EngineRecorder>> recorders_;
+
+        /// Write a DECISIONS chunk, preceded by any phase names it introduces.
+        void writeChunk(const ChunkHeader& header, std::span<const uint8_t> payload,
+                        std::span<const model::Decision> decisions);
+    };
+
+}
@@ -76,7 +76,7 @@ int main() {
             std::cout << ")\n";
         }
 
-        setQueues(engine1->lanes(), {15, 3, 4, 1, 12, 2, 5, 1});
+        engine1->updateQueues(std::vector<uint32_t>{15, 3, 4, 1, 12, 2, 5, 1});
 
         for (int step = 0; step < 15; ++step) {
             auto d = engine1->step();
@@ -99,7 +99,7 @@ int main() {
             std::cout << ")\n";
         }
 
-        setQueues(engine6->lanes(), {10, 2, 8, 3, 6, 1, 12, 4, 5, 2, 7, 1});
+        engine6->updateQueues(std::vector<uint32_t>{10, 2, 8, 3, 6, 1, 12, 4, 5, 2, 7, 1});
 
         for (int step = 0; step < 15; ++step) {
             auto d = engine6->step();
@@ -121,7 +121,7 @@ int main() {
             std::cout << ")\n";
         }
 
-        setQueues(engine3->lanes(), {8, 3, 5, 2, 10, 1});
+        engine3->updateQueues(std::vector<uint32_t>{8, 3, 5, 2, 10, 1});
 
         for (int step = 0; step < 10; ++step) {
             auto d = engine3->step();
@@ -205,7 +205,7 @@ int main() {
             const auto& decisions = corridor.lastDecisions();
             std::cout << "  t=" << std::setw(2) << t << " | ";
             for (std::size_t i = 0; i < decisions.size(); ++i) {
-                std::cout << "I" << i << ":" << decisions[i].phaseName
+                std::cout << "I" << i << ":" << decisions[i].phaseName()
                           << "(" << model::to_string(decisions[i].signalState) << ") ";
             }
             std::cout << "\n";
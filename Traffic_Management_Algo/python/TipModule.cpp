@@ -0,0 +1,1081 @@
+/// CPython extension module "tip" over tip_core.
+///
+/// Exposes TrafficEngine, CorridorCoordinator, BLEPriorityManager, RLAgent
+/// and BatchEnv. Lane columns (queue lengths, wait counters, BLE boosts),
+/// corridor decisions and the batch environment's observation, action,
+/// reward and done buffers are exported through the buffer protocol as views
+/// of C++ memory; when NumPy is importable the properties return numpy
+/// arrays over those buffers (no copies), otherwise memoryviews.
+/// step_many / tick_many and BatchEnv.step / reset run with the GIL released.
+///
+/// Build with -DTIP_PYTHON=ON.
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include "ble/BLEPriorityManager.hpp"
+#include "ble/BLERegistry.hpp"
+#include "coordination/CorridorCoordinator.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/PhaseNames.hpp"
+#include "rl/BatchEnvironment.hpp"
+#include "rl/RLAgent.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace tip;
+
+namespace {
+
+    // ------------------------------------------------------------------
+    // Shared helpers
+    // ------------------------------------------------------------------
+
+    PyObject* numpyAsArray = nullptr; ///< numpy.asarray, or null without NumPy
+
+    /// Run fn, converting C++ exceptions into Python exceptions.
+    template <typename Fn>
+    PyObject* guarded(Fn&& fn) {
+        try {
+            return fn();
+        } catch (const std::invalid_argument& e) {
+            PyErr_SetString(PyExc_ValueError, e.what());
+        } catch (const std::out_of_range& e) {
+            PyErr_SetString(PyExc_IndexError, e.what());
+        } catch (const std::bad_alloc&) {
+            PyErr_NoMemory();
+        } catch (const std::exception& e) {
+            PyErr_SetString(PyExc_RuntimeError, e.what());
+        }
+        return nullptr;
+    }
+
+    /// Method table entry for a METH_VARARGS | METH_KEYWORDS function.
+    template <typename Fn>
+    PyCFunction keywords(Fn fn) {
+        return reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(fn));
+    }
+
+    template <typename Enum>
+    Enum enumFromName(PyObject* value, std::initializer_list<std::pair<std::string_view, Enum>> names,
+                      const char* what) {
+        if (PyLong_Check(value)) {
+            const long index = PyLong_AsLong(value);
+            for (const auto& [name, e] : names) {
+                if (static_cast<long>(e) == index) return e;
+            }
+        } else if (PyUnicode_Check(value)) {
+            Py_ssize_t length = 0;
+            const char* text = PyUnicode_AsUTF8AndSize(value, &length);
+            if (!text) throw std::invalid_argument(what);
+            const std::string_view name(text, static_cast<std::size_t>(length));
+            for (const auto& [n, e] : names) {
+                if (n == name) return e;
+            }
+        }
+        throw std::invalid_argument(std::string("unknown ") + what);
+    }
+
+    PyObject* decisionToDict(const model::Decision& d) {
+        return Py_BuildValue("{s:n,s:s#,s:d,s:I,s:s,s:s}",
+                             "phase_index", static_cast<Py_ssize_t>(d.selectedPhaseIndex),
+                             "phase_name", d.phaseName().data(), static_cast<Py_ssize_t>(d.phaseName().size()),
+                             "score", d.phaseScore,
+                             "green_duration", d.greenDuration,
+                             "signal", model::to_string(d.signalState).c_str(),
+                             "priority", model::to_string(d.activePriority).c_str());
+    }
+
+    // ------------------------------------------------------------------
+    // BufferView: strided 1-D or C-contiguous N-D buffer over memory owned
+    // by another object
+    // ------------------------------------------------------------------
+
+    constexpr int MAX_VIEW_DIMS = 3;
+
+    struct BufferView {
+        PyObject_HEAD
+        PyObject*   owner;          ///< Keeps the memory alive
+        void*       data;
+        int         ndim;
+        Py_ssize_t  shape[MAX_VIEW_DIMS];
+        Py_ssize_t  strides[MAX_VIEW_DIMS];
+        Py_ssize_t  itemSize;
+        const char* format;
+        bool        readonly;
+        Py_ssize_t* exports;        ///< Owner's live-export counter, or null
+    };
+
+    PyTypeObject* BufferViewType = nullptr;
+
+    int bufferViewGetBuffer(PyObject* self, Py_buffer* view, int flags) {
+        auto* v = reinterpret_cast<BufferView*>(self);
+        if ((flags & PyBUF_WRITABLE) && v->readonly) {
+            PyErr_SetString(PyExc_BufferError, "view is read-only");
+            return -1;
+        }
+        if ((flags & PyBUF_STRIDES) != PyBUF_STRIDES && v->ndim == 1 && v->strides[0] != v->itemSize) {
+            PyErr_SetString(PyExc_BufferError, "view is strided");
+            return -1;
+        }
+        Py_ssize_t items = 1;
+        for (int d = 0; d < v->ndim; ++d) items *= v->shape[d];
+        // Consumers that cannot take a shape see N-D views as flat
+        const bool shaped = v->ndim == 1 || (flags & PyBUF_ND) == PyBUF_ND;
+        view->obj = Py_NewRef(self);
+        view->buf = v->data;
+        view->len = items * v->itemSize;
+        view->itemsize = v->itemSize;
+        view->readonly = v->readonly;
+        view->ndim = shaped ? v->ndim : 1;
+        view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(v->format) : nullptr;
+        view->shape = shaped ? v->shape : nullptr;
+        view->strides = shaped && (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? v->strides : nullptr;
+        view->suboffsets = nullptr;
+        view->internal = nullptr;
+        if (v->exports) ++*v->exports;
+        return 0;
+    }
+
+    void bufferViewReleaseBuffer(PyObject* self, Py_buffer*) {
+        auto* v = reinterpret_cast<BufferView*>(self);
+        if (v->exports) --*v->exports;
+    }
+
+    void bufferViewDealloc(PyObject* self) {
+        auto* v = reinterpret_cast<BufferView*>(self);
+        PyTypeObject* type = Py_TYPE(self);
+        Py_XDECREF(v->owner);
+        type->tp_free(self);
+        Py_DECREF(type);
+    }
+
+    /// Hand v to numpy.asarray (or memoryview), dropping our reference.
+    PyObject* wrapView(BufferView* v) {
+        PyObject* result = numpyAsArray
+            ? PyObject_CallOneArg(numpyAsArray, reinterpret_cast<PyObject*>(v))
+            : PyMemoryView_FromObject(reinterpret_cast<PyObject*>(v));
+        Py_DECREF(v);
+        return result;
+    }
+
+    BufferView* newView(PyObject* owner, void* data, Py_ssize_t itemSize, const char* format, bool readonly,
+                        Py_ssize_t* exports) {
+        auto* v = PyObject_New(BufferView, BufferViewType);
+        if (!v) return nullptr;
+        v->owner = Py_NewRef(owner);
+        v->data = data;
+        v->ndim = 1;
+        v->itemSize = itemSize;
+        v->format = format;
+        v->readonly = readonly;
+        v->exports = exports;
+        return v;
+    }
+
+    /// numpy.asarray (or memoryview) over count items at data spaced stride bytes apart.
+    PyObject* makeView(PyObject* owner, void* data, Py_ssize_t count, Py_ssize_t stride, Py_ssize_t itemSize,
+                       const char* format, bool readonly, Py_ssize_t* exports = nullptr) {
+        auto* v = newView(owner, data, itemSize, format, readonly, exports);
+        if (!v) return nullptr;
+        v->shape[0] = count;
+        v->strides[0] = stride;
+        return wrapView(v);
+    }
+
+    /// numpy.asarray (or memoryview) over a C-contiguous array of the given shape.
+    PyObject* makeArrayView(PyObject* owner, void* data, std::initializer_list<Py_ssize_t> shape,
+                            Py_ssize_t itemSize, const char* format, bool readonly) {
+        auto* v = newView(owner, data, itemSize, format, readonly, nullptr);
+        if (!v) return nullptr;
+        v->ndim = static_cast<int>(shape.size());
+        Py_ssize_t stride = itemSize;
+        for (int d = v->ndim - 1; d >= 0; --d) {
+            v->shape[d] = shape.begin()[d];
+            v->strides[d] = stride;
+            stride *= v->shape[d];
+        }
+        return wrapView(v);
+    }
+
+    // ------------------------------------------------------------------
+    // TrafficEngine
+    // ------------------------------------------------------------------
+
+    struct Engine {
+        PyObject_HEAD
+        std::shared_ptr<engine::TrafficEngine>* engine;
+        bool busy;        ///< step_many running without the GIL
+        bool viewsIssued; ///< Lane views may have written lane memory
+    };
+
+    PyTypeObject* EngineType = nullptr;
+
+    bool checkIdle(bool busy) {
+        if (busy) {
+            PyErr_SetString(PyExc_RuntimeError, "object is in use by another thread (step_many/tick_many)");
+            return false;
+        }
+        return true;
+    }
+
+    std::vector<model::Lane> lanesFromPython(PyObject* spec) {
+        std::vector<model::Lane> lanes;
+        PyObject* seq = PySequence_Fast(spec, "lanes must be a sequence of (approach, approaches, movement)");
+        if (!seq) throw std::invalid_argument("lanes must be a sequence");
+        const Py_ssize_t n = PySequence_Fast_GET_SIZE(seq);
+        for (Py_ssize_t i = 0; i < n; ++i) {
+            unsigned short approach = 0, approaches = 0;
+            PyObject* movement = nullptr;
+            if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(seq, i), "HHO", &approach, &approaches, &movement)) {
+                Py_DECREF(seq);
+                PyErr_Clear();
+                throw std::invalid_argument("each lane must be (approach, approaches, movement)");
+            }
+            lanes.push_back({static_cast<std::size_t>(i), model::Direction(approach, approaches),
+                             enumFromName<model::MovementType>(movement, {
+                                 {"THROUGH", model::MovementType::THROUGH},
+                                 {"LEFT_PROTECTED", model::MovementType::LEFT_PROTECTED},
+                             }, "movement"),
+                             {}});
+        }
+        Py_DECREF(seq);
+        return lanes;
+    }
+
+    PyObject* engineNew(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
+        static const char* keywordList[] = {
+            "lanes", "approaches", "alpha", "beta", "min_green", "max_green", "yellow_time",
+            "all_red_time", "green_per_vehicle", "dynamic_phases", nullptr,
+        };
+        PyObject* laneSpec = nullptr;
+        unsigned short approaches = 0;
+        engine::EngineConfig config;
+        int dynamic = config.dynamicPhases;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O$HddIIIIdp", const_cast<char**>(keywordList),
+                                         &laneSpec, &approaches, &config.alpha, &config.beta,
+                                         &config.minGreen, &config.maxGreen, &config.yellowTime,
+                                         &config.allRedTime, &config.greenPerVehicle, &dynamic)) {
+            return nullptr;
+        }
+        config.dynamicPhases = dynamic != 0;
+
+        return guarded([&]() -> PyObject* {
+            std::vector<model::Lane> lanes;
+            if (laneSpec && laneSpec != Py_None) {
+                lanes = lanesFromPython(laneSpec);
+            } else {
+                if (approaches == 0) throw std::invalid_argument("pass lanes=... or approaches=N");
+                // Standard N-way layout: one through and one protected-left lane per approach
+                for (uint16_t a = 0; a < approaches; ++a) {
+                    model::Direction dir(a, approaches);
+                    lanes.push_back({lanes.size(), dir, model::MovementType::THROUGH, {}});
+                    lanes.push_back({lanes.size(), dir, model::MovementType::LEFT_PROTECTED, {}});
+                }
+            }
+            auto created = std::make_shared<engine::TrafficEngine>(std::move(lanes), config);
+
+            auto* self = reinterpret_cast<Engine*>(type->tp_alloc(type, 0));
+            if (!self) return nullptr;
+            self->engine = new std::shared_ptr<engine::TrafficEngine>(std::move(created));
+            self->busy = false;
+            self->viewsIssued = false;
+            return reinterpret_cast<PyObject*>(self);
+        });
+    }
+
+    void engineDealloc(PyObject* self) {
+        PyTypeObject* type = Py_TYPE(self);
+        delete reinterpret_cast<Engine*>(self)->engine;
+        type->tp_free(self);
+        Py_DECREF(type);
+    }
+
+    engine::TrafficEngine& engineOf(PyObject* self) {
+        return **reinterpret_cast<Engine*>(self)->engine;
+    }
+
+    /// Engine about to step: writes through lane views are not tracked, so
+    /// report every lane dirty once any view exists.
+    engine::TrafficEngine& steppingEngine(PyObject* self) {
+        auto& target = engineOf(self);
+        if (reinterpret_cast<Engine*>(self)->viewsIssued) target.markAllLanesDirty();
+        return target;
+    }
+
+    PyObject* engineStep(PyObject* self, PyObject*) {
+        if (!checkIdle(reinterpret_cast<Engine*>(self)->busy)) return nullptr;
+        return guarded([&] { return decisionToDict(steppingEngine(self).step()); });
+    }
+
+    PyObject* engineStepMany(PyObject* self, PyObject* args) {
+        unsigned long long count = 0;
+        if (!PyArg_ParseTuple(args, "K", &count)) return nullptr;
+        auto* wrapper = reinterpret_cast<Engine*>(self);
+        if (!checkIdle(wrapper->busy)) return nullptr;
+        if (count == 0) Py_RETURN_NONE;
+
+        auto& target = steppingEngine(self);
+        model::Decision last;
+        std::string error;
+        wrapper->busy = true;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            for (unsigned long long i = 0; i < count; ++i) {
+                last = target.step();
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        Py_END_ALLOW_THREADS
+        wrapper->busy = false;
+        if (!error.empty()) {
+            PyErr_SetString(PyExc_RuntimeError, error.c_str());
+            return nullptr;
+        }
+        return decisionToDict(last);
+    }
+
+    PyObject* engineUpdateQueues(PyObject* self, PyObject* arg) {
+        if (!checkIdle(reinterpret_cast<Engine*>(self)->busy)) return nullptr;
+        Py_buffer queues;
+        if (PyObject_GetBuffer(arg, &queues, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0) return nullptr;
+        PyObject* result = nullptr;
+        const std::string_view format = queues.format ? queues.format : "B";
+        if (queues.itemsize != sizeof(uint32_t) || (format != "I" && format != "=I" && format != "<I" && format != "@I")) {
+            PyErr_SetString(PyExc_TypeError, "queues must be a contiguous uint32 buffer");
+        } else {
+            result = guarded([&]() -> PyObject* {
+                engineOf(self).updateQueues({static_cast<const uint32_t*>(queues.buf),
+                                             static_cast<std::size_t>(queues.len) / sizeof(uint32_t)});
+                Py_RETURN_NONE;
+            });
+        }
+        PyBuffer_Release(&queues);
+        return result;
+    }
+
+    PyObject* engineSetPriority(PyObject* self, PyObject* args) {
+        Py_ssize_t lane = 0;
+        PyObject* reason = nullptr;
+        if (!PyArg_ParseTuple(args, "nO", &lane, &reason)) return nullptr;
+        if (!checkIdle(reinterpret_cast<Engine*>(self)->busy)) return nullptr;
+        return guarded([&]() -> PyObject* {
+            auto& lanes = engineOf(self).lanes();
+            if (lane < 0 || static_cast<std::size_t>(lane) >= lanes.size()) throw std::out_of_range("lane index out of range");
+            lanes[static_cast<std::size_t>(lane)].priorityReason = enumFromName<model::PriorityReason>(reason, {
+                {"NONE", model::PriorityReason::NONE},
+                {"BLE", model::PriorityReason::BLE},
+                {"EMERGENCY", model::PriorityReason::EMERGENCY},
+            }, "priority reason");
+            Py_RETURN_NONE;
+        });
+    }
+
+    PyObject* engineQueueLengths(PyObject* self, void*) {
+        reinterpret_cast<Engine*>(self)->viewsIssued = true;
+        auto& lanes = engineOf(self).lanes();
+        return makeView(self, &lanes.front().queueLength, static_cast<Py_ssize_t>(lanes.size()),
+                        sizeof(model::Lane), sizeof(uint32_t), "I", false);
+    }
+
+    PyObject* engineWaitCounters(PyObject* self, void*) {
+        reinterpret_cast<Engine*>(self)->viewsIssued = true;
+        auto& lanes = engineOf(self).lanes();
+        return makeView(self, &lanes.front().waitCounter, static_cast<Py_ssize_t>(lanes.size()),
+                        sizeof(model::Lane), sizeof(uint32_t), "I", false);
+    }
+
+    PyObject* engineBleBoosts(PyObject* self, void*) {
+        reinterpret_cast<Engine*>(self)->viewsIssued = true;
+        auto& lanes = engineOf(self).lanes();
+        return makeView(self, &lanes.front().bleBoost, static_cast<Py_ssize_t>(lanes.size()),
+                        sizeof(model::Lane), sizeof(double), "d", false);
+    }
+
+    PyObject* engineLaneCount(PyObject* self, void*) {
+        return PyLong_FromSize_t(std::as_const(engineOf(self)).lanes().size());
+    }
+
+    PyObject* enginePhases(PyObject* self, void*) {
+        const auto& engine = engineOf(self);
+        const std::size_t count = engine.phases().size();
+        PyObject* list = PyList_New(static_cast<Py_ssize_t>(count));
+        if (!list) return nullptr;
+        for (std::size_t p = 0; p < count; ++p) {
+            const std::string phaseName = engine.phaseName(p);
+            PyObject* name = PyUnicode_FromStringAndSize(phaseName.data(), static_cast<Py_ssize_t>(phaseName.size()));
+            if (!name) {
+                Py_DECREF(list);
+                return nullptr;
+            }
+            PyList_SET_ITEM(list, static_cast<Py_ssize_t>(p), name);
+        }
+        return list;
+    }
+
+    PyObject* engineSignal(PyObject* self, void*) {
+        return PyUnicode_FromString(model::to_string(engineOf(self).currentSignal()).c_str());
+    }
+
+    PyObject* engineConfig(PyObject* self, void*) {
+        const auto& c = engineOf(self).config();
+        return Py_BuildValue("{s:d,s:d,s:I,s:I,s:I,s:I,s:d,s:O}",
+                             "alpha", c.alpha, "beta", c.beta, "min_green", c.minGreen, "max_green", c.maxGreen,
+                             "yellow_time", c.yellowTime, "all_red_time", c.allRedTime,
+                             "green_per_vehicle", c.greenPerVehicle,
+                             "dynamic_phases", c.dynamicPhases ? Py_True : Py_False);
+    }
+
+    PyMethodDef engineMethods[] = {
+        {"step", engineStep, METH_NOARGS, "Run one decision cycle and return the decision."},
+        {"step_many", engineStepMany, METH_VARARGS,
+         "step_many(n): run n cycles without the GIL; returns the last decision (None for n=0)."},
+        {"update_queues", engineUpdateQueues, METH_O,
+         "update_queues(queues): set all queue lengths from a contiguous uint32 buffer (no copy)."},
+        {"set_priority", engineSetPriority, METH_VARARGS,
+         "set_priority(lane, reason): reason is 'NONE', 'BLE' or 'EMERGENCY'."},
+        {nullptr, nullptr, 0, nullptr},
+    };
+
+    PyGetSetDef engineGetSet[] = {
+        {"queue_lengths", engineQueueLengths, nullptr, "Writable uint32 view of lane queue lengths.", nullptr},
+        {"wait_counters", engineWaitCounters, nullptr, "Writable uint32 view of lane wait counters.", nullptr},
+        {"ble_boosts", engineBleBoosts, nullptr, "Writable float64 view of lane BLE boosts.", nullptr},
+        {"lane_count", engineLaneCount, nullptr, "Number of lanes.", nullptr},
+        {"phases", enginePhases, nullptr, "Phase names in plan order.", nullptr},
+        {"signal", engineSignal, nullptr, "Current signal state.", nullptr},
+        {"config", engineConfig, nullptr, "Engine parameters as a dict.", nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr},
+    };
+
+    // ------------------------------------------------------------------
+    // CorridorCoordinator
+    // ------------------------------------------------------------------
+
+    /// Decision as a NumPy structured dtype (field layout checked below).
+    constexpr const char* DECISION_FORMAT =
+        "T{Q:phase_index:d:score:I:phase_name_id:I:green_duration:B:signal:B:priority:6x:}";
+    static_assert(offsetof(model::Decision, phaseScore) == 8 && offsetof(model::Decision, phaseNameId) == 16 &&
+                  offsetof(model::Decision, greenDuration) == 20 && offsetof(model::Decision, signalState) == 24 &&
+                  offsetof(model::Decision, activePriority) == 25 && sizeof(model::Decision) == 32 &&
+                  sizeof(std::size_t) == 8);
+
+    struct Corridor {
+        PyObject_HEAD
+        coordination::CorridorCoordinator* corridor;
+        PyObject*  engines;  ///< list keeping added Engine objects alive
+        Py_ssize_t exports;  ///< Live views of the decision buffer
+        bool       busy;
+    };
+
+    PyTypeObject* CorridorType = nullptr;
+
+    PyObject* corridorNew(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
+        static const char* keywordList[] = {"threads", nullptr};
+        Py_ssize_t threads = 1;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|n", const_cast<char**>(keywordList), &threads)) return nullptr;
+        if (threads < 0) {
+            PyErr_SetString(PyExc_ValueError, "threads must be >= 0");
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            auto* self = reinterpret_cast<Corridor*>(type->tp_alloc(type, 0));
+            if (!self) return nullptr;
+            self->corridor = new coordination::CorridorCoordinator();
+            self->engines = PyList_New(0);
+            self->exports = 0;
+            self->busy = false;
+            self->corridor->setThreadCount(static_cast<std::size_t>(threads));
+            return reinterpret_cast<PyObject*>(self);
+        });
+    }
+
+    void corridorDealloc(PyObject* self) {
+        auto* c = reinterpret_cast<Corridor*>(self);
+        PyTypeObject* type = Py_TYPE(self);
+        delete c->corridor;
+        Py_XDECREF(c->engines);
+        type->tp_free(self);
+        Py_DECREF(type);
+    }
+
+    PyObject* corridorAdd(PyObject* self, PyObject* args) {
+        auto* c = reinterpret_cast<Corridor*>(self);
+        PyObject* engineObject = nullptr;
+        int offset = 0;
+        if (!PyArg_ParseTuple(args, "O!|i", EngineType, &engineObject, &offset)) return nullptr;
+        if (!checkIdle(c->busy)) return nullptr;
+        if (c->exports > 0) {
+            PyErr_SetString(PyExc_BufferError, "cannot add intersections while decision views exist");
+            return nullptr;
+        }
+        if (PyList_Append(c->engines, engineObject) != 0) return nullptr;
+        return guarded([&]() -> PyObject* {
+            c->corridor->addIntersection(*reinterpret_cast<Engine*>(engineObject)->engine, offset);
+            Py_RETURN_NONE;
+        });
+    }
+
+    PyObject* corridorTickMany(PyObject* self, PyObject* args) {
+        auto* c = reinterpret_cast<Corridor*>(self);
+        unsigned int start = 0;
+        unsigned int count = 1;
+        if (!PyArg_ParseTuple(args, "I|I", &start, &count)) return nullptr;
+        if (!checkIdle(c->busy)) return nullptr;
+
+        // Engines are shared with their Python wrappers; block those while ticking
+        const Py_ssize_t engineCount = PyList_GET_SIZE(c->engines);
+        for (Py_ssize_t e = 0; e < engineCount; ++e) {
+            if (!checkIdle(reinterpret_cast<Engine*>(PyList_GET_ITEM(c->engines, e))->busy)) return nullptr;
+        }
+        for (Py_ssize_t e = 0; e < engineCount; ++e) {
+            auto* wrapper = reinterpret_cast<Engine*>(PyList_GET_ITEM(c->engines, e));
+            if (wrapper->viewsIssued) (*wrapper->engine)->markAllLanesDirty();
+            wrapper->busy = true;
+        }
+        c->busy = true;
+
+        std::string error;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            for (unsigned int t = 0; t < count; ++t) c->corridor->tick(start + t);
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        Py_END_ALLOW_THREADS
+
+        c->busy = false;
+        for (Py_ssize_t e = 0; e < engineCount; ++e) reinterpret_cast<Engine*>(PyList_GET_ITEM(c->engines, e))->busy = false;
+        if (!error.empty()) {
+            PyErr_SetString(PyExc_RuntimeError, error.c_str());
+            return nullptr;
+        }
+        Py_RETURN_NONE;
+    }
+
+    PyObject* corridorSetThreads(PyObject* self, PyObject* args) {
+        auto* c = reinterpret_cast<Corridor*>(self);
+        Py_ssize_t threads = 1;
+        if (!PyArg_ParseTuple(args, "n", &threads)) return nullptr;
+        if (!checkIdle(c->busy)) return nullptr;
+        if (threads < 0) {
+            PyErr_SetString(PyExc_ValueError, "threads must be >= 0");
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            c->corridor->setThreadCount(static_cast<std::size_t>(threads));
+            Py_RETURN_NONE;
+        });
+    }
+
+    PyObject* corridorDecisions(PyObject* self, void*) {
+        auto* c = reinterpret_cast<Corridor*>(self);
+        auto& decisions = const_cast<coordination::DecisionBuffer&>(c->corridor->lastDecisions());
+        return makeView(self, decisions.data(), static_cast<Py_ssize_t>(decisions.size()),
+                        sizeof(model::Decision), sizeof(model::Decision), DECISION_FORMAT, true, &c->exports);
+    }
+
+    PyObject* corridorSize(PyObject* self, void*) {
+        return PyLong_FromSize_t(reinterpret_cast<Corridor*>(self)->corridor->size());
+    }
+
+    PyObject* corridorThreads(PyObject* self, void*) {
+        return PyLong_FromSize_t(reinterpret_cast<Corridor*>(self)->corridor->threadCount());
+    }
+
+    PyMethodDef corridorMethods[] = {
+        {"add_intersection", corridorAdd, METH_VARARGS, "add_intersection(engine, offset=0)"},
+        {"tick", corridorTickMany, METH_VARARGS, "tick(t): one global tick, without the GIL."},
+        {"tick_many", corridorTickMany, METH_VARARGS,
+         "tick_many(start, n): ticks start..start+n-1 without the GIL."},
+        {"set_thread_count", corridorSetThreads, METH_VARARGS, "set_thread_count(n); 0 = hardware threads."},
+        {nullptr, nullptr, 0, nullptr},
+    };
+
+    PyGetSetDef corridorGetSet[] = {
+        {"decisions", corridorDecisions, nullptr,
+         "Read-only structured view of the latest decisions (phase_index, score, phase_name_id, "
+         "green_duration, signal, priority).", nullptr},
+        {"size", corridorSize, nullptr, "Number of intersections.", nullptr},
+        {"thread_count", corridorThreads, nullptr, "Threads used by tick.", nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr},
+    };
+
+    // ------------------------------------------------------------------
+    // BLEPriorityManager
+    // ------------------------------------------------------------------
+
+    struct BLEManager {
+        PyObject_HEAD
+        ble::BLEPriorityManager* manager;
+    };
+
+    PyTypeObject* BLEManagerType = nullptr;
+
+    std::chrono::steady_clock::time_point timestampFrom(PyObject* seconds) {
+        if (!seconds || seconds == Py_None) return std::chrono::steady_clock::now();
+        const double value = PyFloat_AsDouble(seconds);
+        if (value == -1.0 && PyErr_Occurred()) {
+            PyErr_Clear();
+            throw std::invalid_argument("timestamp must be a number of seconds");
+        }
+        return std::chrono::steady_clock::time_point(
+            std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(value)));
+    }
+
+    PyObject* bleNew(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
+        static const char* keywordList[] = {"authorized", "cooldown", "max_activations_per_hour", nullptr};
+        PyObject* authorized = nullptr;
+        double cooldown = 30.0;
+        Py_ssize_t maxPerHour = 10;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Odn", const_cast<char**>(keywordList),
+                                         &authorized, &cooldown, &maxPerHour)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            if (cooldown < 0.0 || maxPerHour < 0) throw std::invalid_argument("limits must be non-negative");
+            ble::BLERegistry registry;
+            if (authorized && authorized != Py_None) {
+                PyObject* seq = PySequence_Fast(authorized, "authorized must be a sequence of device ids");
+                if (!seq) return nullptr;
+                for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i) {
+                    Py_ssize_t length = 0;
+                    const char* id = PyUnicode_AsUTF8AndSize(PySequence_Fast_GET_ITEM(seq, i), &length);
+                    if (!id) {
+                        Py_DECREF(seq);
+                        return nullptr;
+                    }
+                    registry.authorize(std::string_view(id, static_cast<std::size_t>(length)));
+                }
+                Py_DECREF(seq);
+            }
+            ble::BLEConfig config;
+            config.cooldownWindow = std::chrono::seconds(static_cast<long long>(cooldown));
+            config.maxActivationsPerHour = static_cast<std::size_t>(maxPerHour);
+
+            auto* self = reinterpret_cast<BLEManager*>(type->tp_alloc(type, 0));
+            if (!self) return nullptr;
+            self->manager = new ble::BLEPriorityManager(config, std::move(registry));
+            return reinterpret_cast<PyObject*>(self);
+        });
+    }
+
+    void bleDealloc(PyObject* self) {
+        PyTypeObject* type = Py_TYPE(self);
+        delete reinterpret_cast<BLEManager*>(self)->manager;
+        type->tp_free(self);
+        Py_DECREF(type);
+    }
+
+    PyObject* bleProcess(PyObject* self, PyObject* args, PyObject* kwargs) {
+        static const char* keywordList[] = {"device_id", "approach", "approaches", "weight", "timestamp", nullptr};
+        const char* deviceId = nullptr;
+        Py_ssize_t deviceLength = 0;
+        unsigned short approach = 0, approaches = 0;
+        double weight = 1.0;
+        PyObject* timestamp = nullptr;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s#HH|dO", const_cast<char**>(keywordList),
+                                         &deviceId, &deviceLength, &approach, &approaches, &weight, &timestamp)) {
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            ble::BLEEvent event;
+            event.deviceId.assign(deviceId, static_cast<std::size_t>(deviceLength));
+            event.direction = model::Direction(approach, approaches);
+            event.weight = weight;
+            event.timestamp = timestampFrom(timestamp);
+            return PyBool_FromLong(reinterpret_cast<BLEManager*>(self)->manager->processEvent(event));
+        });
+    }
+
+    PyObject* bleBoost(PyObject* self, PyObject* args) {
+        unsigned short approach = 0, approaches = 0;
+        if (!PyArg_ParseTuple(args, "HH", &approach, &approaches)) return nullptr;
+        return guarded([&] {
+            return PyFloat_FromDouble(
+                reinterpret_cast<BLEManager*>(self)->manager->getBoost(model::Direction(approach, approaches)));
+        });
+    }
+
+    PyObject* bleClear(PyObject* self, PyObject*) {
+        reinterpret_cast<BLEManager*>(self)->manager->clearBoosts();
+        Py_RETURN_NONE;
+    }
+
+    PyMethodDef bleMethods[] = {
+        {"process_event", keywords(bleProcess), METH_VARARGS | METH_KEYWORDS,
+         "process_event(device_id, approach, approaches, weight=1.0, timestamp=None) -> accepted. "
+         "timestamp is steady-clock seconds; None means now."},
+        {"boost", bleBoost, METH_VARARGS, "boost(approach, approaches) -> accumulated boost."},
+        {"clear_boosts", bleClear, METH_NOARGS, "Reset all boosts."},
+        {nullptr, nullptr, 0, nullptr},
+    };
+
+    // ------------------------------------------------------------------
+    // RLAgent
+    // ------------------------------------------------------------------
+
+    struct Agent {
+        PyObject_HEAD
+        rl::RLAgent agent;
+    };
+
+    PyTypeObject* AgentType = nullptr;
+
+    PyObject* agentNew(PyTypeObject* type, PyObject*, PyObject*) {
+        auto* self = reinterpret_cast<Agent*>(type->tp_alloc(type, 0));
+        if (self) new (&self->agent) rl::RLAgent();
+        return reinterpret_cast<PyObject*>(self);
+    }
+
+    void agentDealloc(PyObject* self) {
+        PyTypeObject* type = Py_TYPE(self);
+        reinterpret_cast<Agent*>(self)->agent.~RLAgent();
+        type->tp_free(self);
+        Py_DECREF(type);
+    }
+
+    PyObject* uintList(const std::vector<uint32_t>& values) {
+        PyObject* list = PyList_New(static_cast<Py_ssize_t>(values.size()));
+        if (!list) return nullptr;
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            PyList_SET_ITEM(list, static_cast<Py_ssize_t>(i), PyLong_FromUnsignedLong(values[i]));
+        }
+        return list;
+    }
+
+    PyObject* agentObserve(PyObject* self, PyObject* args) {
+        PyObject* engineObject = nullptr;
+        if (!PyArg_ParseTuple(args, "O!", EngineType, &engineObject)) return nullptr;
+        if (!checkIdle(reinterpret_cast<Engine*>(engineObject)->busy)) return nullptr;
+        return guarded([&]() -> PyObject* {
+            const auto state = reinterpret_cast<Agent*>(self)->agent.observe(engineOf(engineObject));
+            PyObject* queues = uintList(state.queueLengths);
+            PyObject* waits = uintList(state.waitCounters);
+            PyObject* result = (queues && waits)
+                ? Py_BuildValue("{s:O,s:O,s:d,s:I}", "queue_lengths", queues, "wait_counters", waits,
+                                "last_phase_score", state.lastPhaseScore, "last_green_duration", state.lastGreenDuration)
+                : nullptr;
+            Py_XDECREF(queues);
+            Py_XDECREF(waits);
+            return result;
+        });
+    }
+
+    PyObject* agentTune(PyObject* self, PyObject* args) {
+        PyObject* engineObject = nullptr;
+        if (!PyArg_ParseTuple(args, "O!", EngineType, &engineObject)) return nullptr;
+        if (!checkIdle(reinterpret_cast<Engine*>(engineObject)->busy)) return nullptr;
+        return guarded([&]() -> PyObject* {
+            reinterpret_cast<Agent*>(self)->agent.tune(engineOf(engineObject));
+            Py_RETURN_NONE;
+        });
+    }
+
+    PyMethodDef agentMethods[] = {
+        {"observe", agentObserve, METH_VARARGS, "observe(engine) -> state dict."},
+        {"tune", agentTune, METH_VARARGS, "tune(engine): observe, act and apply parameter deltas."},
+        {nullptr, nullptr, 0, nullptr},
+    };
+
+    // ------------------------------------------------------------------
+    // BatchEnvironment
+    // ------------------------------------------------------------------
+
+    struct BatchEnv {
+        PyObject_HEAD
+        rl::BatchEnvironment* env;
+        bool busy;  ///< step/reset running without the GIL
+    };
+
+    PyTypeObject* BatchEnvType = nullptr;
+
+    PyObject* batchNew(PyTypeObject* type, PyObject* args, PyObject* kwargs) {
+        static const char* keywordList[] = {
+            "engine", "batch", "ticks_per_step", "episode_ticks", "arrival_rate", "saturation_flow",
+            "lane_capacity", "seed", "threads", nullptr,
+        };
+        PyObject* engineObject = nullptr;
+        Py_ssize_t batch = 0;
+        Py_ssize_t threads = 1;
+        rl::BatchConfig config;
+        unsigned long long seed = config.seed;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!n|$IIddIKn", const_cast<char**>(keywordList),
+                                         EngineType, &engineObject, &batch, &config.ticksPerStep,
+                                         &config.episodeTicks, &config.arrivalRate, &config.saturationFlow,
+                                         &config.laneCapacity, &seed, &threads)) {
+            return nullptr;
+        }
+        if (!checkIdle(reinterpret_cast<Engine*>(engineObject)->busy)) return nullptr;
+        if (batch <= 0 || threads < 0) {
+            PyErr_SetString(PyExc_ValueError, "batch must be positive and threads >= 0");
+            return nullptr;
+        }
+        config.seed = seed;
+        config.threads = static_cast<std::size_t>(threads);
+
+        return guarded([&]() -> PyObject* {
+            // The template engine's lanes (including their queues) and
+            // configuration become every environment's initial state
+            auto& source = engineOf(engineObject);
+            auto created = std::make_unique<rl::BatchEnvironment>(
+                std::as_const(source).lanes(), source.config(), static_cast<std::size_t>(batch), config);
+
+            auto* self = reinterpret_cast<BatchEnv*>(type->tp_alloc(type, 0));
+            if (!self) return nullptr;
+            self->env = created.release();
+            self->busy = false;
+            return reinterpret_cast<PyObject*>(self);
+        });
+    }
+
+    void batchDealloc(PyObject* self) {
+        PyTypeObject* type = Py_TYPE(self);
+        delete reinterpret_cast<BatchEnv*>(self)->env;
+        type->tp_free(self);
+        Py_DECREF(type);
+    }
+
+    /// Run fn on the environment with the GIL released.
+    template <typename Fn>
+    PyObject* batchRun(PyObject* self, Fn fn) {
+        auto* b = reinterpret_cast<BatchEnv*>(self);
+        if (!checkIdle(b->busy)) return nullptr;
+        std::exception_ptr error;
+        b->busy = true;
+        Py_BEGIN_ALLOW_THREADS
+        try {
+            fn(*b->env);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        Py_END_ALLOW_THREADS
+        b->busy = false;
+        if (error) return guarded([&]() -> PyObject* { std::rethrow_exception(error); });
+        Py_RETURN_NONE;
+    }
+
+    PyObject* batchStep(PyObject* self, PyObject*) {
+        return batchRun(self, [](rl::BatchEnvironment& env) { env.step(); });
+    }
+
+    PyObject* batchStepMany(PyObject* self, PyObject* args) {
+        unsigned long long count = 0;
+        if (!PyArg_ParseTuple(args, "K", &count)) return nullptr;
+        return batchRun(self, [count](rl::BatchEnvironment& env) {
+            for (unsigned long long i = 0; i < count; ++i) env.step();
+        });
+    }
+
+    PyObject* batchReset(PyObject* self, PyObject*) {
+        return batchRun(self, [](rl::BatchEnvironment& env) { env.reset(); });
+    }
+
+    PyObject* batchSetThreads(PyObject* self, PyObject* args) {
+        auto* b = reinterpret_cast<BatchEnv*>(self);
+        Py_ssize_t threads = 1;
+        if (!PyArg_ParseTuple(args, "n", &threads)) return nullptr;
+        if (!checkIdle(b->busy)) return nullptr;
+        if (threads < 0) {
+            PyErr_SetString(PyExc_ValueError, "threads must be >= 0");
+            return nullptr;
+        }
+        return guarded([&]() -> PyObject* {
+            b->env->setThreadCount(static_cast<std::size_t>(threads));
+            Py_RETURN_NONE;
+        });
+    }
+
+    rl::BatchEnvironment& batchOf(PyObject* self) {
+        return *reinterpret_cast<BatchEnv*>(self)->env;
+    }
+
+    PyObject* batchObservations(PyObject* self, void*) {
+        auto& env = batchOf(self);
+        return makeArrayView(self, const_cast<float*>(env.observations().data()),
+                             {static_cast<Py_ssize_t>(env.batchSize()), static_cast<Py_ssize_t>(env.laneCount()),
+                              static_cast<Py_ssize_t>(rl::FEATURE_COUNT)},
+                             sizeof(float), "f", true);
+    }
+
+    PyObject* batchActions(PyObject* self, void*) {
+        auto& env = batchOf(self);
+        return makeArrayView(self, env.actions().data(),
+                             {static_cast<Py_ssize_t>(env.batchSize()), static_cast<Py_ssize_t>(rl::ACTION_SIZE)},
+                             sizeof(float), "f", false);
+    }
+
+    PyObject* batchRewards(PyObject* self, void*) {
+        auto& env = batchOf(self);
+        return makeArrayView(self, const_cast<float*>(env.rewards().data()),
+                             {static_cast<Py_ssize_t>(env.batchSize())}, sizeof(float), "f", true);
+    }
+
+    PyObject* batchDones(PyObject* self, void*) {
+        auto& env = batchOf(self);
+        return makeArrayView(self, const_cast<uint8_t*>(env.dones().data()),
+                             {static_cast<Py_ssize_t>(env.batchSize())}, sizeof(uint8_t), "B", true);
+    }
+
+    PyObject* batchSize(PyObject* self, void*) {
+        return PyLong_FromSize_t(batchOf(self).batchSize());
+    }
+
+    PyObject* batchLaneCount(PyObject* self, void*) {
+        return PyLong_FromSize_t(batchOf(self).laneCount());
+    }
+
+    PyObject* batchEpisodes(PyObject* self, void*) {
+        return PyLong_FromUnsignedLongLong(batchOf(self).episodes());
+    }
+
+    PyObject* batchThreads(PyObject* self, void*) {
+        return PyLong_FromSize_t(batchOf(self).threadCount());
+    }
+
+    PyMethodDef batchMethods[] = {
+        {"step", batchStep, METH_NOARGS,
+         "Apply actions and advance every environment one step, without the GIL."},
+        {"step_many", batchStepMany, METH_VARARGS,
+         "step_many(n): n steps with the same actions, without the GIL; outputs are those of the last."},
+        {"reset", batchReset, METH_NOARGS, "Restart every episode and write fresh observations."},
+        {"set_thread_count", batchSetThreads, METH_VARARGS, "set_thread_count(n); 0 = hardware threads."},
+        {nullptr, nullptr, 0, nullptr},
+    };
+
+    PyGetSetDef batchGetSet[] = {
+        {"observations", batchObservations, nullptr,
+         "Read-only float32 view [batch, lanes, 4]: queue length, wait counter, BLE boost, green.", nullptr},
+        {"actions", batchActions, nullptr,
+         "Writable float32 view [batch, 3]: delta alpha, delta beta, delta green per vehicle.", nullptr},
+        {"rewards", batchRewards, nullptr, "Read-only float32 view [batch] of the last step's rewards.", nullptr},
+        {"dones", batchDones, nullptr, "Read-only uint8 view [batch]: 1 where the last step ended an episode.",
+         nullptr},
+        {"batch_size", batchSize, nullptr, "Number of environments.", nullptr},
+        {"lane_count", batchLaneCount, nullptr, "Lanes per environment.", nullptr},
+        {"episodes", batchEpisodes, nullptr, "Episodes finished over all environments.", nullptr},
+        {"thread_count", batchThreads, nullptr, "Threads used by step and reset.", nullptr},
+        {nullptr, nullptr, nullptr, nullptr, nullptr},
+    };
+
+    // ------------------------------------------------------------------
+    // Module
+    // ------------------------------------------------------------------
+
+    PyObject* phaseName(PyObject*, PyObject* args) {
+        unsigned int id = 0;
+        if (!PyArg_ParseTuple(args, "I", &id)) return nullptr;
+        const auto name = model::phaseNameOf(id);
+        return PyUnicode_FromStringAndSize(name.data(), static_cast<Py_ssize_t>(name.size()));
+    }
+
+    PyMethodDef moduleMethods[] = {
+        {"phase_name", phaseName, METH_VARARGS, "phase_name(id): name for a decision's phase_name_id."},
+        {nullptr, nullptr, 0, nullptr},
+    };
+
+    PyType_Slot bufferViewSlots[] = {
+        {Py_tp_dealloc, reinterpret_cast<void*>(bufferViewDealloc)},
+        {Py_bf_getbuffer, reinterpret_cast<void*>(bufferViewGetBuffer)},
+        {Py_bf_releasebuffer, reinterpret_cast<void*>(bufferViewReleaseBuffer)},
+        {Py_tp_doc, const_cast<char*>("Buffer over engine memory.")},
+        {0, nullptr},
+    };
+    PyType_Slot engineSlots[] = {
+        {Py_tp_new, reinterpret_cast<void*>(engineNew)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(engineDealloc)},
+        {Py_tp_methods, engineMethods},
+        {Py_tp_getset, engineGetSet},
+        {Py_tp_doc, const_cast<char*>("TrafficEngine(lanes=None, *, approaches=0, alpha, beta, min_green, "
+                                      "max_green, yellow_time, all_red_time, green_per_vehicle, dynamic_phases)")},
+        {0, nullptr},
+    };
+    PyType_Slot corridorSlots[] = {
+        {Py_tp_new, reinterpret_cast<void*>(corridorNew)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(corridorDealloc)},
+        {Py_tp_methods, corridorMethods},
+        {Py_tp_getset, corridorGetSet},
+        {Py_tp_doc, const_cast<char*>("CorridorCoordinator(threads=1)")},
+        {0, nullptr},
+    };
+    PyType_Slot bleSlots[] = {
+        {Py_tp_new, reinterpret_cast<void*>(bleNew)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(bleDealloc)},
+        {Py_tp_methods, bleMethods},
+        {Py_tp_doc, const_cast<char*>("BLEPriorityManager(authorized=(), cooldown=30.0, max_activations_per_hour=10)")},
+        {0, nullptr},
+    };
+    PyType_Slot agentSlots[] = {
+        {Py_tp_new, reinterpret_cast<void*>(agentNew)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(agentDealloc)},
+        {Py_tp_methods, agentMethods},
+        {Py_tp_doc, const_cast<char*>("RLAgent()")},
+        {0, nullptr},
+    };
+
+    PyType_Slot batchSlots[] = {
+        {Py_tp_new, reinterpret_cast<void*>(batchNew)},
+        {Py_tp_dealloc, reinterpret_cast<void*>(batchDealloc)},
+        {Py_tp_methods, batchMethods},
+        {Py_tp_getset, batchGetSet},
+        {Py_tp_doc, const_cast<char*>("BatchEnv(engine, batch, *, ticks_per_step=10, episode_ticks=3600, "
+                                      "arrival_rate=0.1, saturation_flow=0.5, lane_capacity=250, seed=1, "
+                                      "threads=1): batch copies of engine's lanes and configuration")},
+        {0, nullptr},
+    };
+
+    PyType_Spec bufferViewSpec = {"tip.BufferView", sizeof(BufferView), 0, Py_TPFLAGS_DEFAULT, bufferViewSlots};
+    PyType_Spec engineSpec     = {"tip.TrafficEngine", sizeof(Engine), 0, Py_TPFLAGS_DEFAULT, engineSlots};
+    PyType_Spec corridorSpec   = {"tip.CorridorCoordinator", sizeof(Corridor), 0, Py_TPFLAGS_DEFAULT, corridorSlots};
+    PyType_Spec bleSpec        = {"tip.BLEPriorityManager", sizeof(BLEManager), 0, Py_TPFLAGS_DEFAULT, bleSlots};
+    PyType_Spec agentSpec      = {"tip.RLAgent", sizeof(Agent), 0, Py_TPFLAGS_DEFAULT, agentSlots};
+    PyType_Spec batchSpec      = {"tip.BatchEnv", sizeof(BatchEnv), 0, Py_TPFLAGS_DEFAULT, batchSlots};
+
+    PyModuleDef moduleDef = {
+        PyModuleDef_HEAD_INIT, "tip", "Python bindings for tip_core.", -1, moduleMethods,
+        nullptr, nullptr, nullptr, nullptr,
+    };
+
+    bool addType(PyObject* module, PyType_Spec& spec, PyTypeObject*& out, const char* name) {
+        out = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&spec));
+        if (!out) return false;
+        return PyModule_AddObjectRef(module, name, reinterpret_cast<PyObject*>(out)) == 0;
+    }
+
+}
+
+PyMODINIT_FUNC PyInit_tip() {
+    PyObject* module = PyModule_Create(&moduleDef);
+    if (!module) return nullptr;
+
+    if (!addType(module, bufferViewSpec, BufferViewType, "BufferView") ||
+        !addType(module, engineSpec, EngineType, "TrafficEngine") ||
+        !addType(module, corridorSpec, CorridorType, "CorridorCoordinator") ||
+        !addType(module, bleSpec, BLEManagerType, "BLEPriorityManager") ||
+        !addType(module, agentSpec, AgentType, "RLAgent") ||
+        !addType(module, batchSpec, BatchEnvType, "BatchEnv")) {
+        Py_DECREF(module);
+        return nullptr;
+    }
+    if (PyObject* numpy = PyImport_ImportModule("numpy")) {
+        numpyAsArray = PyObject_GetAttrString(numpy, "asarray");
+        Py_DECREF(numpy);
+    }
+    PyErr_Clear(); // NumPy is optional
+
+    PyModule_AddStringConstant(module, "DECISION_FORMAT", DECISION_FORMAT);
+    PyModule_AddIntConstant(module, "OBSERVATION_FEATURES", static_cast<long>(rl::FEATURE_COUNT));
+    PyModule_AddIntConstant(module, "ACTION_SIZE", static_cast<long>(rl::ACTION_SIZE));
+    return module;
+}
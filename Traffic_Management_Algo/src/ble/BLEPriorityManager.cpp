@@ -1,86 +1,144 @@
 
 #include "ble/BLEPriorityManager.hpp"
+#include "metrics/Metrics.hpp"
 #include <algorithm>
 
 namespace tip::ble {
 
 BLEPriorityManager::BLEPriorityManager(BLEConfig config, BLERegistry registry)
-    : config_(std::move(config)), registry_(std::move(registry)) {}
+    : config_(std::move(config))
+    , registry_(std::move(registry))
+    , queue_(std::make_unique<concurrency::MpscQueue<BLEEvent>>(config_.queueCapacity)) {}
 
 bool BLEPriorityManager::processEvent(const BLEEvent& event) {
+    TIP_METRICS_SCOPE();
+    TIP_TIME(BLE_PROCESS);
+
     // Authorization check
     if (!registry_.isAuthorized(event.deviceId)) {
+        TIP_COUNT(BLE_REJECTED_UNAUTHORIZED, 1);
         return false;
     }
 
     auto now = event.timestamp;
 
+    // Intern authorized devices only, so unknown beacons never grow the tables
+    const DeviceIndex device = devices_.intern(event.deviceId);
+    if (device >= deviceState_.size()) {
+        deviceState_.resize(std::size_t{device} + 1);
+        activationRing_.resize(deviceState_.size() * config_.maxActivationsPerHour);
+    }
+
     // Cooldown check
-    if (!checkCooldown(event.deviceId, now)) {
+    if (!checkCooldown(device, now)) {
+        TIP_COUNT(BLE_REJECTED_COOLDOWN, 1);
         return false;
     }
 
     // Rate limit check
-    if (!checkRateLimit(event.deviceId, now)) {
+    if (!checkRateLimit(device, now)) {
+        TIP_COUNT(BLE_REJECTED_RATE_LIMIT, 1);
         return false;
     }
 
     // Accept the event
-    recordActivation(event.deviceId, now);
+    recordActivation(device, now);
+    TIP_COUNT(BLE_ACCEPTED, 1);
 
     // Accumulate boost for the approach index
+    if (event.direction.index >= directionBoosts_.size()) {
+        directionBoosts_.resize(std::size_t{event.direction.index} + 1, 0.0);
+    }
     directionBoosts_[event.direction.index] += event.weight;
 
     return true;
 }
 
+std::size_t BLEPriorityManager::processEvents(std::span<const BLEEvent> events) {
+    // Order by timestamp; events sit contiguously, so address order is batch order
+    batchOrder_.clear();
+    for (const auto& event : events) {
+        batchOrder_.push_back(&event);
+    }
+    std::sort(batchOrder_.begin(), batchOrder_.end(), [](const BLEEvent* a, const BLEEvent* b) {
+        return a->timestamp < b->timestamp || (a->timestamp == b->timestamp && a < b);
+    });
+
+    std::size_t accepted = 0;
+    for (const BLEEvent* event : batchOrder_) {
+        if (processEvent(*event)) {
+            ++accepted;
+        }
+    }
+    return accepted;
+}
+
+bool BLEPriorityManager::enqueue(BLEEvent event) {
+    return queue_->tryPush(std::move(event));
+}
+
+std::size_t BLEPriorityManager::drainQueue() {
+    drained_.clear();
+    queue_->drain(drained_);
+    return processEvents(drained_);
+}
+
 double BLEPriorityManager::getBoost(const model::Direction& dir) const {
-    auto it = directionBoosts_.find(dir.index);
-    if (it != directionBoosts_.end()) {
-        return it->second;
+    if (dir.index < directionBoosts_.size()) {
+        return directionBoosts_[dir.index];
     }
     return 0.0;
 }
 
 void BLEPriorityManager::clearBoosts() {
-    directionBoosts_.clear();
+    std::fill(directionBoosts_.begin(), directionBoosts_.end(), 0.0);
 }
 
-bool BLEPriorityManager::checkCooldown(const std::string& deviceId,
+bool BLEPriorityManager::checkCooldown(DeviceIndex device,
                                         std::chrono::steady_clock::time_point now) const {
-    auto it = lastActivation_.find(deviceId);
-    if (it == lastActivation_.end()) {
+    const auto& state = deviceState_[device];
+    if (!state.activated) {
         return true; // First activation
     }
-    return (now - it->second) >= config_.cooldownWindow;
+    return (now - state.lastActivation) >= config_.cooldownWindow;
 }
 
-bool BLEPriorityManager::checkRateLimit(const std::string& deviceId,
+bool BLEPriorityManager::checkRateLimit(DeviceIndex device,
                                          std::chrono::steady_clock::time_point now) const {
-    auto it = activationHistory_.find(deviceId);
-    if (it == activationHistory_.end()) {
+    const auto& state = deviceState_[device];
+    if (!state.activated) {
         return true;
     }
 
-    const auto& history = it->second;
-    auto oneHourAgo = now - std::chrono::hours(1);
-
-    auto count = std::count_if(history.begin(), history.end(),
-        [&](const auto& ts) { return ts >= oneHourAgo; });
+    // The ring holds the last maxActivationsPerHour activations in time order;
+    // the cap is reached when even the oldest of them is within the hour
+    const std::size_t capacity = config_.maxActivationsPerHour;
+    if (state.ringCount < capacity) {
+        return true;
+    }
+    if (capacity == 0) {
+        return false;
+    }
 
-    return static_cast<std::size_t>(count) < config_.maxActivationsPerHour;
+    auto oneHourAgo = now - std::chrono::hours(1);
+    const auto oldest = activationRing_[device * capacity + state.ringHead];
+    return oldest < oneHourAgo;
 }
 
-void BLEPriorityManager::recordActivation(const std::string& deviceId,
+void BLEPriorityManager::recordActivation(DeviceIndex device,
                                             std::chrono::steady_clock::time_point now) {
-    lastActivation_[deviceId] = now;
-
-    auto& history = activationHistory_[deviceId];
-    history.push_back(now);
+    auto& state = deviceState_[device];
+    state.lastActivation = now;
+    state.activated = true;
 
-    auto oneHourAgo = now - std::chrono::hours(1);
-    while (!history.empty() && history.front() < oneHourAgo) {
-        history.pop_front();
+    const std::size_t capacity = config_.maxActivationsPerHour;
+    if (capacity == 0) {
+        return;
+    }
+    activationRing_[device * capacity + state.ringHead] = now;
+    state.ringHead = static_cast<uint32_t>((state.ringHead + 1) % capacity);
+    if (state.ringCount < capacity) {
+        ++state.ringCount;
     }
 }
 
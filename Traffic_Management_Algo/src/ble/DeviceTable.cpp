@@ -0,0 +1,55 @@
+
+#include "ble/DeviceTable.hpp"
+
+#include <functional>
+
+namespace tip::ble {
+
+    namespace {
+        [[nodiscard]] uint64_t hashOf(std::string_view deviceId) noexcept {
+            return std::hash<std::string_view>{}(deviceId);
+        }
+    }
+
+    std::size_t DeviceTable::probe(std::string_view deviceId, uint64_t hash) const noexcept {
+        const std::size_t mask = slots_.size() - 1;
+        for (std::size_t i = hash & mask;; i = (i + 1) & mask) {
+            const Slot& slot = slots_[i];
+            if (slot.index == EMPTY) return i;
+            if (slot.hash == hash && names_[slot.index] == deviceId) return i;
+        }
+    }
+
+    std::optional<DeviceIndex> DeviceTable::find(std::string_view deviceId) const noexcept {
+        if (slots_.empty()) return std::nullopt;
+        const Slot& slot = slots_[probe(deviceId, hashOf(deviceId))];
+        if (slot.index == EMPTY) return std::nullopt;
+        return slot.index;
+    }
+
+    DeviceIndex DeviceTable::intern(std::string_view deviceId) {
+        if ((names_.size() + 1) * 2 > slots_.size()) grow();
+
+        const uint64_t hash = hashOf(deviceId);
+        Slot& slot = slots_[probe(deviceId, hash)];
+        if (slot.index == EMPTY) {
+            slot = {hash, static_cast<DeviceIndex>(names_.size())};
+            names_.emplace_back(deviceId);
+        }
+        return slot.index;
+    }
+
+    void DeviceTable::grow() {
+        std::vector<Slot> old(slots_.empty() ? 16 : slots_.size() * 2);
+        old.swap(slots_);
+
+        const std::size_t mask = slots_.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.index == EMPTY) continue;
+            std::size_t i = slot.hash & mask;
+            while (slots_[i].index != EMPTY) i = (i + 1) & mask;
+            slots_[i] = slot;
+        }
+    }
+
+}
@@ -0,0 +1,208 @@
+
+#include "ble/MappedRegistry.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tip::ble {
+
+    namespace {
+        constexpr char        MAGIC[8]       = {'T', 'I', 'P', 'B', 'L', 'E', 'R', 'G'};
+        constexpr std::size_t SECTION_ALIGN  = 64;
+        constexpr std::size_t BLOCK_WORDS    = 8;  ///< 512-bit Bloom block (one cache line)
+        constexpr std::size_t BITS_PER_KEY   = 12;
+        constexpr unsigned    BLOOM_PROBES   = 6;
+        constexpr uint32_t    MAX_DIR_BITS   = 24;
+
+        struct FileHeader {
+            char     magic[8];
+            uint32_t version;
+            uint32_t dirBits;
+            uint64_t count;
+            uint64_t bloomBlocks;
+            uint64_t bloomOffset;
+            uint64_t directoryOffset;
+            uint64_t hashOffset;
+        };
+
+        [[nodiscard]] std::size_t alignUp(std::size_t n) noexcept {
+            return (n + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+        }
+
+        /// Whether count elements of elementSize bytes at offset lie inside a
+        /// file of fileSize bytes. Divides rather than multiplies, so header
+        /// values chosen to wrap the arithmetic are rejected too.
+        [[nodiscard]] bool sectionFits(uint64_t offset, uint64_t count, std::size_t elementSize,
+                                       std::size_t fileSize) noexcept {
+            return offset % SECTION_ALIGN == 0
+                && offset <= fileSize
+                && count <= (fileSize - offset) / elementSize;
+        }
+
+        /// Second hash for the in-block probes; the block comes from the low bits.
+        [[nodiscard]] uint64_t probeBits(uint64_t hash) noexcept {
+            hash ^= hash >> 33; hash *= 0xff51afd7ed558ccdULL;
+            hash ^= hash >> 33; hash *= 0xc4ceb9fe1a85ec53ULL;
+            hash ^= hash >> 33;
+            return hash;
+        }
+
+        [[nodiscard]] std::size_t bucketOf(uint64_t hash, uint32_t dirBits) noexcept {
+            return dirBits == 0 ? 0 : static_cast<std::size_t>(hash >> (64 - dirBits));
+        }
+    }
+
+    void MappedRegistry::write(const std::string& path, std::span<const std::string> deviceIds) {
+        std::vector<uint64_t> hashes;
+        hashes.reserve(deviceIds.size());
+        for (const auto& id : deviceIds) {
+            hashes.push_back(deviceIdHash(id));
+        }
+        write(path, std::move(hashes));
+    }
+
+    void MappedRegistry::write(const std::string& path, std::vector<uint64_t> hashes) {
+        std::sort(hashes.begin(), hashes.end());
+        hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+        const std::size_t count = hashes.size();
+
+        // About four hashes per directory bucket
+        const uint32_t dirBits = count < 8 ? 0
+            : std::min<uint32_t>(MAX_DIR_BITS, static_cast<uint32_t>(std::bit_width(count)) - 3);
+        std::vector<uint32_t> directory((std::size_t{1} << dirBits) + 1, 0);
+        {
+            std::size_t i = 0;
+            for (std::size_t b = 0; b + 1 < directory.size(); ++b) {
+                directory[b] = static_cast<uint32_t>(i);
+                while (i < count && bucketOf(hashes[i], dirBits) == b) ++i;
+            }
+            directory.back() = static_cast<uint32_t>(count);
+        }
+
+        const std::size_t bloomBlocks = std::bit_ceil(
+            std::max<std::size_t>(1, (count * BITS_PER_KEY + BLOCK_WORDS * 64 - 1) / (BLOCK_WORDS * 64)));
+        std::vector<uint64_t> bloom(bloomBlocks * BLOCK_WORDS, 0);
+        for (uint64_t h : hashes) {
+            uint64_t* block = bloom.data() + (h & (bloomBlocks - 1)) * BLOCK_WORDS;
+            uint64_t bits = probeBits(h);
+            for (unsigned k = 0; k < BLOOM_PROBES; ++k, bits >>= 9) {
+                block[(bits >> 6) & 7] |= uint64_t{1} << (bits & 63);
+            }
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version         = FORMAT_VERSION;
+        header.dirBits         = dirBits;
+        header.count           = count;
+        header.bloomBlocks     = bloomBlocks;
+        header.bloomOffset     = alignUp(sizeof(FileHeader));
+        header.directoryOffset = alignUp(header.bloomOffset + bloom.size() * sizeof(uint64_t));
+        header.hashOffset      = alignUp(header.directoryOffset + directory.size() * sizeof(uint32_t));
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("MappedRegistry: cannot create " + path);
+        }
+        auto pad = [&out](std::size_t offset) {
+            static constexpr char zeros[SECTION_ALIGN] = {};
+            out.write(zeros, static_cast<std::streamsize>(offset - static_cast<std::size_t>(out.tellp())));
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pad(header.bloomOffset);
+        out.write(reinterpret_cast<const char*>(bloom.data()), static_cast<std::streamsize>(bloom.size() * sizeof(uint64_t)));
+        pad(header.directoryOffset);
+        out.write(reinterpret_cast<const char*>(directory.data()), static_cast<std::streamsize>(directory.size() * sizeof(uint32_t)));
+        pad(header.hashOffset);
+        out.write(reinterpret_cast<const char*>(hashes.data()), static_cast<std::streamsize>(count * sizeof(uint64_t)));
+        if (!out.flush()) {
+            throw std::runtime_error("MappedRegistry: failed writing " + path);
+        }
+    }
+
+    std::shared_ptr<const MappedRegistry> MappedRegistry::open(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("MappedRegistry: cannot open " + path);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("MappedRegistry: " + path + " is truncated");
+        }
+        const auto size = static_cast<std::size_t>(st.st_size);
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw std::runtime_error("MappedRegistry: cannot map " + path);
+        }
+
+        std::shared_ptr<MappedRegistry> registry(new MappedRegistry());
+        registry->mapping_ = mapping;
+        registry->mappingSize_ = size;
+
+        FileHeader header;
+        std::memcpy(&header, mapping, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("MappedRegistry: " + path + " is not a registry file");
+        }
+        if (header.version != FORMAT_VERSION) {
+            throw std::runtime_error("MappedRegistry: " + path + " has unsupported version " +
+                                     std::to_string(header.version));
+        }
+
+        const std::size_t dirEntries = (std::size_t{1} << std::min(header.dirBits, MAX_DIR_BITS)) + 1;
+        const bool fits = header.dirBits <= MAX_DIR_BITS
+            && std::has_single_bit(header.bloomBlocks)
+            && sectionFits(header.bloomOffset, header.bloomBlocks, BLOCK_WORDS * sizeof(uint64_t), size)
+            && sectionFits(header.directoryOffset, dirEntries, sizeof(uint32_t), size)
+            && sectionFits(header.hashOffset, header.count, sizeof(uint64_t), size);
+        if (!fits) {
+            throw std::runtime_error("MappedRegistry: " + path + " is truncated or corrupt");
+        }
+
+        const auto* base = static_cast<const std::byte*>(mapping);
+        registry->bloom_ = {reinterpret_cast<const uint64_t*>(base + header.bloomOffset),
+                            header.bloomBlocks * BLOCK_WORDS};
+        registry->directory_ = {reinterpret_cast<const uint32_t*>(base + header.directoryOffset), dirEntries};
+        registry->hashes_ = {reinterpret_cast<const uint64_t*>(base + header.hashOffset), header.count};
+        registry->dirBits_ = header.dirBits;
+        return registry;
+    }
+
+    MappedRegistry::~MappedRegistry() {
+        if (mapping_) {
+            ::munmap(mapping_, mappingSize_);
+        }
+    }
+
+    bool MappedRegistry::mayContain(uint64_t hash) const noexcept {
+        const std::size_t blocks = bloom_.size() / BLOCK_WORDS;
+        const uint64_t* block = bloom_.data() + (hash & (blocks - 1)) * BLOCK_WORDS;
+        uint64_t bits = probeBits(hash);
+        for (unsigned k = 0; k < BLOOM_PROBES; ++k, bits >>= 9) {
+            if (!(block[(bits >> 6) & 7] & (uint64_t{1} << (bits & 63)))) return false;
+        }
+        return true;
+    }
+
+    bool MappedRegistry::contains(uint64_t hash) const noexcept {
+        if (hashes_.empty() || !mayContain(hash)) return false;
+
+        const std::size_t bucket = bucketOf(hash, dirBits_);
+        // Clamped so a corrupt directory can never read past the table
+        const auto first = hashes_.begin() + std::min<std::size_t>(directory_[bucket], hashes_.size());
+        const auto last  = hashes_.begin() + std::min<std::size_t>(directory_[bucket + 1], hashes_.size());
+        if (first >= last) return false;
+        return std::binary_search(first, last, hash);
+    }
+
+}
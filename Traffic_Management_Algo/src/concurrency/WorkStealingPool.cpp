@@ -0,0 +1,147 @@
+
+#include "concurrency/WorkStealingPool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace tip::concurrency {
+
+    namespace {
+        constexpr uint64_t pack(uint32_t begin, uint32_t end) noexcept {
+            return (static_cast<uint64_t>(begin) << 32) | end;
+        }
+        constexpr uint32_t beginOf(uint64_t r) noexcept { return static_cast<uint32_t>(r >> 32); }
+        constexpr uint32_t endOf(uint64_t r) noexcept { return static_cast<uint32_t>(r); }
+    }
+
+    WorkStealingPool::WorkStealingPool(std::size_t threadCount)
+        : blocks_(threadCount != 0 ? threadCount
+                                   : std::max<std::size_t>(1, std::thread::hardware_concurrency()))
+    {
+        threads_.reserve(blocks_.size() - 1);
+        for (std::size_t w = 1; w < blocks_.size(); ++w) {
+            threads_.emplace_back([this, w] { workerLoop(w); });
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& t : threads_) {
+            t.join();
+        }
+    }
+
+    void WorkStealingPool::parallelFor(std::size_t count, std::size_t grain, const RangeFn& fn) {
+        if (count == 0) return;
+        grain = std::max<std::size_t>(grain, 1);
+
+        const std::size_t chunks = (count + grain - 1) / grain;
+        if (chunks > UINT32_MAX) {
+            throw std::length_error("WorkStealingPool: too many chunks for one parallelFor");
+        }
+
+        // Single worker or single chunk: run inline, no synchronization
+        if (blocks_.size() == 1 || chunks == 1) {
+            for (std::size_t c = 0; c < chunks; ++c) {
+                fn(c * grain, std::min(count, (c + 1) * grain));
+            }
+            return;
+        }
+
+        // Deal contiguous chunk blocks to workers so each starts on local data
+        const std::size_t workers = blocks_.size();
+        for (std::size_t w = 0; w < workers; ++w) {
+            auto b = static_cast<uint32_t>(chunks * w / workers);
+            auto e = static_cast<uint32_t>(chunks * (w + 1) / workers);
+            blocks_[w].range.store(pack(b, e), std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            fn_    = &fn;
+            count_ = count;
+            grain_ = grain;
+            error_ = nullptr;
+            busy_  = workers - 1;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        runChunks(0);
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] { return busy_ == 0; });
+        fn_ = nullptr;
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+    void WorkStealingPool::workerLoop(std::size_t self) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+                if (stopping_) return;
+                seen = generation_;
+            }
+
+            runChunks(self);
+
+            {
+                std::lock_guard lock(mutex_);
+                --busy_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    void WorkStealingPool::runChunks(std::size_t self) {
+        uint32_t chunk = 0;
+        while (popOwn(self, chunk) || steal(self, chunk)) {
+            const std::size_t begin = static_cast<std::size_t>(chunk) * grain_;
+            try {
+                (*fn_)(begin, std::min(count_, begin + grain_));
+            } catch (...) {
+                std::lock_guard lock(mutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+        }
+    }
+
+    bool WorkStealingPool::popOwn(std::size_t self, uint32_t& chunk) noexcept {
+        auto& range = blocks_[self].range;
+        uint64_t r = range.load(std::memory_order_acquire);
+        while (beginOf(r) < endOf(r)) {
+            if (range.compare_exchange_weak(r, pack(beginOf(r) + 1, endOf(r)),
+                                            std::memory_order_acq_rel)) {
+                chunk = beginOf(r);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool WorkStealingPool::steal(std::size_t self, uint32_t& chunk) noexcept {
+        const std::size_t workers = blocks_.size();
+        for (std::size_t k = 1; k < workers; ++k) {
+            auto& range = blocks_[(self + k) % workers].range;
+            uint64_t r = range.load(std::memory_order_acquire);
+            while (beginOf(r) < endOf(r)) {
+                if (range.compare_exchange_weak(r, pack(beginOf(r), endOf(r) - 1),
+                                                std::memory_order_acq_rel)) {
+                    chunk = endOf(r) - 1;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+}
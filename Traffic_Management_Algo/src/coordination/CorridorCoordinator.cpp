@@ -1,8 +1,21 @@
 
 #include "coordination/CorridorCoordinator.hpp"
+#include "metrics/Metrics.hpp"
+
+#include <algorithm>
+#include <numeric>
 
 namespace tip::coordination {
 
+    void CorridorCoordinator::setThreadCount(std::size_t threads) {
+        if (threads == 1) {
+            pool_.reset();
+        } else {
+            pool_ = std::make_unique<concurrency::WorkStealingPool>(threads);
+            if (pool_->threadCount() == 1) pool_.reset();
+        }
+    }
+
     void CorridorCoordinator::addIntersection(
         std::shared_ptr<engine::TrafficEngine> engine,
         int32_t offsetSeconds)
@@ -12,7 +25,30 @@ namespace tip::coordination {
     }
 
     void CorridorCoordinator::tick(uint32_t globalTime) {
-        for (std::size_t i = 0; i < entries_.size(); ++i) {
+        TIP_METRICS_SCOPE();
+        TIP_TIME(CORRIDOR_TICK);
+        TIP_COUNT(CORRIDOR_TICKS, 1);
+
+        if (!pool_) {
+            tickRange(globalTime, 0, entries_.size());
+            return;
+        }
+
+        // Chunk boundaries fall on cache-line boundaries of decisions_, so no
+        // two workers ever write to the same line. Several chunks per worker
+        // leave room for stealing when some intersections switch phase.
+        constexpr std::size_t lineElems =
+            std::lcm(sizeof(model::Decision), concurrency::CACHE_LINE) / sizeof(model::Decision);
+        const std::size_t perWorker = entries_.size() / (pool_->threadCount() * 8);
+        const std::size_t grain = std::max<std::size_t>(1, (perWorker + lineElems - 1) / lineElems) * lineElems;
+
+        pool_->parallelFor(entries_.size(), grain, [&](std::size_t begin, std::size_t end) {
+            tickRange(globalTime, begin, end);
+        });
+    }
+
+    void CorridorCoordinator::tickRange(uint32_t globalTime, std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
             auto& entry = entries_[i];
 
             // Each intersection steps when (globalTime - offset) is non-negative
@@ -24,11 +60,11 @@ namespace tip::coordination {
             } else {
                 // Not yet active — hold ALL_RED
                 model::Decision hold;
-                hold.phaseName = "WAITING";
+                hold.phaseNameId = model::WAITING_PHASE_NAME;
                 hold.signalState = model::SignalPhase::ALL_RED;
                 decisions_[i] = hold;
             }
         }
     }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,62 @@
+
+#include "coordination/EventScheduler.hpp"
+
+#include <algorithm>
+
+namespace tip::coordination {
+
+    void EventScheduler::addIntersection(
+        std::shared_ptr<engine::TrafficEngine> engine,
+        int32_t offsetSeconds)
+    {
+        const auto id = static_cast<uint32_t>(entries_.size());
+        auto& entry = entries_.emplace_back();
+        entry.engine = std::move(engine);
+        wheel_.schedule(id, static_cast<uint64_t>(std::max(offsetSeconds, 0)));
+    }
+
+    std::span<const std::size_t> EventScheduler::tick() {
+        const auto t = now();
+        due_.clear();
+        wheel_.advance(due_);
+        std::sort(due_.begin(), due_.end());
+
+        changed_.clear();
+        for (uint32_t id : due_) {
+            auto& entry = entries_[id];
+
+            // Skip the countdown ticks since the last step, then step into the new state
+            if (entry.active) {
+                entry.engine->advance(t - 1 - entry.syncedTo);
+            }
+            entry.transition   = entry.engine->step();
+            entry.active       = true;
+            entry.syncedTo     = t;
+            entry.transitionAt = t;
+
+            wheel_.schedule(id, uint64_t{t} + entry.engine->ticksUntilTransition());
+            changed_.push_back(id);
+        }
+        return changed_;
+    }
+
+    model::Decision EventScheduler::decision(std::size_t i) {
+        auto& entry = entries_[i];
+        if (!entry.active) {
+            // Not yet active — hold ALL_RED
+            model::Decision hold;
+            hold.phaseNameId = model::WAITING_PHASE_NAME;
+            hold.signalState = model::SignalPhase::ALL_RED;
+            return hold;
+        }
+
+        const uint32_t last = now() - 1;
+        if (entry.transitionAt == last) {
+            return entry.transition;
+        }
+        entry.engine->advance(last - entry.syncedTo);
+        entry.syncedTo = last;
+        return entry.engine->currentDecision();
+    }
+
+}
@@ -0,0 +1,321 @@
+#include "coordination/GreenWaveOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace tip::coordination {
+
+    namespace {
+        /// A derived horizon covers this many free-flow corridor traversals
+        /// plus MIN_HORIZON_SECONDS
+        constexpr uint64_t HORIZON_TRAVERSALS  = 2;
+        constexpr uint64_t MIN_HORIZON_SECONDS = 600;
+
+        bool validRate(double rate) {
+            return std::isfinite(rate) && rate >= 0.0;
+        }
+    }
+
+    GreenWaveOptimizer::GreenWaveOptimizer(const CorridorCoordinator& corridor,
+                                           GreenWaveProblem problem,
+                                           GreenWaveConfig config)
+        : problem_(std::move(problem)), config_(config)
+    {
+        const std::size_t n = corridor.size();
+        if (n == 0) {
+            throw std::invalid_argument("GreenWaveOptimizer: corridor has no intersections");
+        }
+        if (problem_.arterial.size() != n || problem_.linkTravelSeconds.size() != n - 1) {
+            throw std::invalid_argument("GreenWaveOptimizer: expected one arterial lane pair per "
+                                        "intersection and one travel time per link");
+        }
+        if (std::any_of(problem_.linkTravelSeconds.begin(), problem_.linkTravelSeconds.end(),
+                        [](uint32_t s) { return s == 0; })) {
+            throw std::invalid_argument("GreenWaveOptimizer: link travel times must be at least one second");
+        }
+        if (!validRate(problem_.forwardDemand) || !validRate(problem_.reverseDemand) ||
+            !validRate(problem_.sideDemand) || !validRate(config_.saturationFlow) ||
+            !validRate(config_.delayWeight) || !validRate(config_.progressionWeight)) {
+            throw std::invalid_argument("GreenWaveOptimizer: demands and weights must be finite and non-negative");
+        }
+        if (config_.offsetStep == 0) {
+            throw std::invalid_argument("GreenWaveOptimizer: offsetStep must be positive");
+        }
+        if (config_.horizonSeconds == 0) {
+            // Arterial vehicles entering early in the horizon can cross the
+            // corridor even after stopping along the way
+            const uint64_t traversal = std::accumulate(problem_.linkTravelSeconds.begin(),
+                                                       problem_.linkTravelSeconds.end(), uint64_t{0});
+            config_.horizonSeconds = static_cast<uint32_t>(std::min<uint64_t>(
+                MIN_HORIZON_SECONDS + HORIZON_TRAVERSALS * traversal, UINT32_MAX));
+        }
+
+        lanes_.reserve(n);
+        engineConfigs_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto& engine = *corridor.intersection(i).engine;
+            const auto& arterial = problem_.arterial[i];
+            const std::size_t laneCount = std::as_const(engine).lanes().size();
+            if (arterial.forward >= laneCount || arterial.reverse >= laneCount ||
+                arterial.forward == arterial.reverse) {
+                throw std::invalid_argument("GreenWaveOptimizer: arterial lanes must be two distinct lanes "
+                                            "of their intersection");
+            }
+
+            // Evaluations start from empty intersections
+            auto lanes = std::as_const(engine).lanes();
+            for (auto& lane : lanes) {
+                lane.queueLength    = 0;
+                lane.waitCounter    = 0;
+                lane.bleBoost       = 0.0;
+                lane.priorityReason = model::PriorityReason::NONE;
+            }
+            lanes_.push_back(std::move(lanes));
+            engineConfigs_.push_back(corridor.intersection(i).engine->config());
+        }
+
+        if (config_.threads != 1) {
+            pool_ = std::make_unique<concurrency::WorkStealingPool>(config_.threads);
+            if (pool_->threadCount() == 1) pool_.reset();
+        }
+    }
+
+    GreenWaveScore GreenWaveOptimizer::evaluate(const std::vector<int32_t>& offsets) const {
+        const std::size_t n = lanes_.size();
+        if (offsets.size() != n) {
+            throw std::invalid_argument("GreenWaveOptimizer: expected one offset per intersection");
+        }
+
+        CorridorCoordinator corridor;
+        std::vector<std::shared_ptr<engine::TrafficEngine>> engines;
+        std::vector<std::size_t> laneBase;
+        engines.reserve(n);
+        laneBase.reserve(n);
+        std::size_t totalLanes = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            engines.push_back(std::make_shared<engine::TrafficEngine>(lanes_[i], engineConfigs_[i]));
+            corridor.addIntersection(engines.back(), offsets[i]);
+            laneBase.push_back(totalLanes);
+            totalLanes += lanes_[i].size();
+        }
+
+        // Vehicles in flight on each link, as rings indexed by arrival second;
+        // forward[i] feeds intersection i from i-1, reverse[i] feeds it from i+1
+        const uint32_t maxTravel = problem_.linkTravelSeconds.empty()
+            ? 0 : *std::max_element(problem_.linkTravelSeconds.begin(), problem_.linkTravelSeconds.end());
+        const std::size_t ringLen = std::size_t{maxTravel} + 1;
+        std::vector<uint32_t> forwardRing(n * ringLen, 0);
+        std::vector<uint32_t> reverseRing(n * ringLen, 0);
+
+        std::vector<double> arrivalCredit(totalLanes, 0.0);
+        std::vector<double> dischargeCredit(totalLanes, 0.0);
+        std::vector<model::LaneMask> green(n, 0);
+        std::vector<engine::LaneDelta> deltas;
+
+        GreenWaveScore score;
+
+        // Hand vehicles leaving lane l of intersection i to the next link
+        auto release = [&](std::size_t i, std::size_t l, uint32_t vehicles, uint32_t now) {
+            if (l == problem_.arterial[i].forward) {
+                if (i + 1 < n) {
+                    forwardRing[(i + 1) * ringLen + (now + problem_.linkTravelSeconds[i]) % ringLen] += vehicles;
+                } else {
+                    score.arterialThrough += vehicles;
+                }
+            } else if (l == problem_.arterial[i].reverse) {
+                if (i > 0) {
+                    reverseRing[(i - 1) * ringLen + (now + problem_.linkTravelSeconds[i - 1]) % ringLen] += vehicles;
+                } else {
+                    score.arterialThrough += vehicles;
+                }
+            }
+        };
+
+        for (uint32_t t = 0; t < config_.horizonSeconds; ++t) {
+            const std::size_t slot = t % ringLen;
+
+            // Arrivals meet the signal shown since the previous tick
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto& lanes = std::as_const(*engines[i]).lanes();
+                const auto& arterial = problem_.arterial[i];
+                double* credit = arrivalCredit.data() + laneBase[i];
+                deltas.clear();
+
+                for (std::size_t l = 0; l < lanes.size(); ++l) {
+                    double rate = 0.0;
+                    uint32_t arrivals = 0;
+                    if (l == arterial.forward) {
+                        if (i == 0) rate = problem_.forwardDemand;
+                        arrivals = std::exchange(forwardRing[i * ringLen + slot], 0);
+                    } else if (l == arterial.reverse) {
+                        if (i + 1 == n) rate = problem_.reverseDemand;
+                        arrivals = std::exchange(reverseRing[i * ringLen + slot], 0);
+                    } else {
+                        rate = problem_.sideDemand;
+                    }
+                    credit[l] += rate;
+                    const auto entering = static_cast<uint32_t>(credit[l]);
+                    credit[l] -= entering;
+                    arrivals += entering;
+                    if (arrivals == 0) continue;
+
+                    if (model::testLane(green[i], l) && lanes[l].queueLength == 0) {
+                        release(i, l, arrivals, t);
+                    } else {
+                        score.stops += arrivals;
+                        if (l == arterial.forward || l == arterial.reverse) score.arterialStops += arrivals;
+                        deltas.push_back({static_cast<uint32_t>(l), static_cast<int32_t>(arrivals)});
+                    }
+                }
+                engines[i]->applyDeltas(deltas);
+            }
+
+            corridor.tick(t);
+
+            // Green lanes discharge at saturation flow, as in sim::Simulator
+            const auto& decisions = corridor.lastDecisions();
+            for (std::size_t i = 0; i < n; ++i) {
+                auto& engine = *engines[i];
+                const auto& lanes = std::as_const(engine).lanes();
+                const auto& d = decisions[i];
+                green[i] = d.signalState == model::SignalPhase::GREEN
+                         ? engine.phases()[d.selectedPhaseIndex].mask
+                         : model::LaneMask{0};
+                double* credit = dischargeCredit.data() + laneBase[i];
+                deltas.clear();
+
+                for (std::size_t l = 0; l < lanes.size(); ++l) {
+                    uint32_t departed = 0;
+                    if (model::testLane(green[i], l)) {
+                        credit[l] += config_.saturationFlow;
+                        const auto capacity = static_cast<uint32_t>(credit[l]);
+                        credit[l] -= capacity;
+                        departed = std::min(capacity, lanes[l].queueLength);
+                        if (departed > 0) {
+                            deltas.push_back({static_cast<uint32_t>(l), -static_cast<int32_t>(departed)});
+                            release(i, l, departed, t);
+                        }
+                    } else {
+                        credit[l] = 0.0;
+                    }
+                    score.queuedVehicleSeconds += lanes[l].queueLength - departed;
+                }
+                engine.applyDeltas(deltas);
+            }
+        }
+
+        score.objective = static_cast<double>(score.stops)
+                        + config_.delayWeight * static_cast<double>(score.queuedVehicleSeconds)
+                        - config_.progressionWeight * static_cast<double>(score.arterialThrough);
+        return score;
+    }
+
+    std::vector<int32_t> GreenWaveOptimizer::idealWaveOffsets() const {
+        const std::size_t n = lanes_.size();
+        const uint32_t step = config_.offsetStep;
+        const bool forward = problem_.forwardDemand >= problem_.reverseDemand;
+
+        std::vector<int32_t> offsets(n, 0);
+        uint64_t travelled = 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            // Distance along the heavier direction from its entry intersection
+            const std::size_t i = forward ? k : n - 1 - k;
+            if (k > 0) travelled += problem_.linkTravelSeconds[forward ? i - 1 : i];
+            const uint64_t rounded = (travelled + step / 2) / step * step;
+            offsets[i] = static_cast<int32_t>(std::min<uint64_t>(rounded, INT32_MAX / step * step));
+        }
+        return offsets;
+    }
+
+    GreenWaveResult GreenWaveOptimizer::optimize() {
+        const std::size_t n = lanes_.size();
+        const uint32_t step = config_.offsetStep;
+        const uint32_t radius = config_.searchRadius / step;
+        const std::size_t candidates = std::size_t{2} * radius + 1;
+        const bool forward = problem_.forwardDemand >= problem_.reverseDemand;
+
+        GreenWaveResult result;
+        result.zeroOffsets = evaluate(std::vector<int32_t>(n, 0));
+        const auto ideal = idealWaveOffsets();
+        result.idealWave = evaluate(ideal);
+        result.evaluations = 2;
+
+        if (result.idealWave.objective < result.zeroOffsets.objective) {
+            result.offsets = ideal;
+            result.score = result.idealWave;
+        } else {
+            result.offsets.assign(n, 0);
+            result.score = result.zeroOffsets;
+        }
+
+        std::vector<GreenWaveScore> scores(candidates);
+        for (uint32_t sweep = 0; sweep < config_.maxSweeps; ++sweep) {
+            ++result.sweeps;
+            bool improved = false;
+
+            for (std::size_t k = 0; k < n; ++k) {
+                // Candidate c shifts the k-th intersection along the heavier
+                // direction and every one after it by (c - radius) · step,
+                // keeping the spacing downstream. Offsets stay multiples of
+                // step, so the window clips cleanly at 0.
+                const std::size_t begin = forward ? k : 0;
+                const std::size_t end   = forward ? n : n - k;
+                const int64_t lowest = *std::min_element(result.offsets.begin() + begin,
+                                                         result.offsets.begin() + end);
+                const std::size_t first = static_cast<std::size_t>(
+                    std::max<int64_t>(0, int64_t{radius} - lowest / step));
+                auto shifted = [&](std::vector<int32_t>& trial, std::size_t c) {
+                    const int64_t delta = (static_cast<int64_t>(c) - radius) * step;
+                    for (std::size_t i = begin; i < end; ++i) {
+                        trial[i] = static_cast<int32_t>(result.offsets[i] + delta);
+                    }
+                };
+
+                auto scoreRange = [&](std::size_t from, std::size_t to) {
+                    auto trial = result.offsets;
+                    for (std::size_t c = first + from; c < first + to; ++c) {
+                        shifted(trial, c);
+                        scores[c] = c == radius ? result.score : evaluate(trial);
+                    }
+                };
+                if (pool_) {
+                    pool_->parallelFor(candidates - first, 1, scoreRange);
+                } else {
+                    scoreRange(0, candidates - first);
+                }
+                result.evaluations += candidates - first - 1; // the current offsets are already scored
+
+                // Strict improvement only, lowest offsets on ties: the outcome
+                // does not depend on evaluation order
+                std::size_t best = candidates;
+                double bestObjective = result.score.objective;
+                for (std::size_t c = first; c < candidates; ++c) {
+                    if (scores[c].objective < bestObjective) {
+                        best = c;
+                        bestObjective = scores[c].objective;
+                    }
+                }
+                if (best < candidates) {
+                    shifted(result.offsets, best);
+                    result.score = scores[best];
+                    improved = true;
+                }
+            }
+            if (!improved) break;
+        }
+        return result;
+    }
+
+    void GreenWaveOptimizer::apply(CorridorCoordinator& corridor, const GreenWaveResult& result) {
+        if (result.offsets.size() != corridor.size()) {
+            throw std::invalid_argument("GreenWaveOptimizer: expected one offset per intersection");
+        }
+        for (std::size_t i = 0; i < result.offsets.size(); ++i) {
+            corridor.setOffset(i, result.offsets[i]);
+        }
+    }
+
+}
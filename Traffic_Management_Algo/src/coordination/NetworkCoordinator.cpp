@@ -0,0 +1,344 @@
+#include "coordination/NetworkCoordinator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace tip::coordination {
+
+    NetworkCoordinator::NetworkCoordinator(NetworkConfig config)
+        : config_(config)
+    {
+        if (!(config_.saturationFlow >= 0.0)) {
+            throw std::invalid_argument("NetworkCoordinator: saturationFlow must be non-negative");
+        }
+    }
+
+    std::size_t NetworkCoordinator::addIntersection(std::shared_ptr<engine::TrafficEngine> engine,
+                                                    int32_t offsetSeconds)
+    {
+        const std::size_t laneCount = std::as_const(*engine).lanes().size();
+        nodes_.push_back({std::move(engine), offsetSeconds, outLink_.size()});
+        outLink_.resize(outLink_.size() + laneCount, NO_LINK);
+        decisions_.resize(nodes_.size());
+        layoutValid_ = false;
+        return nodes_.size() - 1;
+    }
+
+    uint32_t& NetworkCoordinator::freeOutLink(std::size_t fromNode, std::size_t fromLane) {
+        if (fromLane >= std::as_const(*nodes_.at(fromNode).engine).lanes().size()) {
+            throw std::out_of_range("NetworkCoordinator: link lane does not exist");
+        }
+        uint32_t& out = outLink_[nodes_[fromNode].laneBase + fromLane];
+        if (out != NO_LINK) {
+            throw std::invalid_argument("NetworkCoordinator: lane already has an outgoing link");
+        }
+        return out;
+    }
+
+    std::size_t NetworkCoordinator::addLink(std::size_t fromNode, std::size_t fromLane,
+                                            std::size_t toNode, std::size_t toLane,
+                                            uint32_t travelSeconds)
+    {
+        if (toLane >= std::as_const(*nodes_.at(toNode).engine).lanes().size()) {
+            throw std::out_of_range("NetworkCoordinator: link lane does not exist");
+        }
+        if (travelSeconds == 0) {
+            throw std::invalid_argument("NetworkCoordinator: link travel time must be at least one second");
+        }
+        uint32_t& out = freeOutLink(fromNode, fromLane);
+
+        out = static_cast<uint32_t>(links_.size());
+        links_.push_back({fromNode, fromLane, toNode, toLane, travelSeconds});
+        layoutValid_ = false;
+        return links_.size() - 1;
+    }
+
+    std::size_t NetworkCoordinator::addPort(std::size_t fromNode, std::size_t fromLane) {
+        freeOutLink(fromNode, fromLane) = PORT_BIT | static_cast<uint32_t>(portFlows_.size());
+        portFlows_.push_back(0);
+        return portFlows_.size() - 1;
+    }
+
+    void NetworkCoordinator::setThreadCount(std::size_t threads) {
+        if (threads == 1) {
+            pool_.reset();
+        } else {
+            pool_ = std::make_unique<concurrency::WorkStealingPool>(threads);
+            if (pool_->threadCount() == 1) pool_.reset();
+        }
+        layoutValid_ = false;
+    }
+
+    void NetworkCoordinator::buildLayout() {
+        const std::size_t n = nodes_.size();
+
+        // Undirected adjacency, CSR
+        std::vector<uint32_t> adjStart(n + 1, 0);
+        for (const auto& link : links_) {
+            ++adjStart[link.fromNode + 1];
+            ++adjStart[link.toNode + 1];
+        }
+        for (std::size_t i = 0; i < n; ++i) adjStart[i + 1] += adjStart[i];
+        std::vector<uint32_t> adj(adjStart[n]);
+        {
+            auto fill = adjStart;
+            for (const auto& link : links_) {
+                adj[fill[link.fromNode]++] = static_cast<uint32_t>(link.toNode);
+                adj[fill[link.toNode]++]   = static_cast<uint32_t>(link.fromNode);
+            }
+        }
+
+        // Breadth-first order from each unvisited node, so connected nodes
+        // end up close together
+        std::vector<uint32_t> order;
+        order.reserve(n);
+        std::vector<uint8_t> seen(n, 0);
+        for (std::size_t root = 0; root < n; ++root) {
+            if (seen[root]) continue;
+            seen[root] = 1;
+            order.push_back(static_cast<uint32_t>(root));
+            for (std::size_t head = order.size() - 1; head < order.size(); ++head) {
+                const uint32_t node = order[head];
+                for (uint32_t e = adjStart[node]; e < adjStart[node + 1]; ++e) {
+                    if (!seen[adj[e]]) {
+                        seen[adj[e]] = 1;
+                        order.push_back(adj[e]);
+                    }
+                }
+            }
+        }
+
+        // Keep discharge credit across the rebuild
+        std::vector<double> credit(outLink_.size(), 0.0);
+        for (const auto& part : partitions_) {
+            for (std::size_t k = 0; k < part->nodes.size(); ++k) {
+                const auto& node = nodes_[part->nodes[k]];
+                const std::size_t lanes = std::as_const(*node.engine).lanes().size();
+                std::copy_n(part->credit.begin() + static_cast<std::ptrdiff_t>(part->creditBase[k]), lanes,
+                            credit.begin() + static_cast<std::ptrdiff_t>(node.laneBase));
+            }
+        }
+
+        // Contiguous blocks of the order with about equal lane counts
+        const std::size_t parts = std::max<std::size_t>(1, std::min(threadCount(), n));
+        const std::size_t totalLanes = std::max<std::size_t>(1, outLink_.size());
+        std::vector<std::unique_ptr<Partition>> partitions(parts);
+        for (std::size_t p = 0; p < parts; ++p) {
+            partitions[p] = std::make_unique<Partition>();
+            partitions[p]->index = static_cast<uint32_t>(p);
+        }
+        std::vector<uint32_t> partOf(n, 0);
+        std::size_t lanesBefore = 0;
+        for (const uint32_t node : order) {
+            const std::size_t p = std::min(parts - 1, lanesBefore * parts / totalLanes);
+            const auto& lanes = std::as_const(*nodes_[node].engine).lanes();
+            auto& part = *partitions[p];
+            partOf[node] = static_cast<uint32_t>(p);
+            part.nodes.push_back(node);
+            part.creditBase.push_back(part.credit.size());
+            part.credit.insert(part.credit.end(),
+                               credit.begin() + static_cast<std::ptrdiff_t>(nodes_[node].laneBase),
+                               credit.begin() + static_cast<std::ptrdiff_t>(nodes_[node].laneBase + lanes.size()));
+            lanesBefore += lanes.size();
+        }
+
+        // Delay lines live with the downstream partition, which reads them
+        boundaryLinks_ = 0;
+        std::vector<Link> links = links_;
+        for (auto& link : links) {
+            auto& part = *partitions[partOf[link.toNode]];
+            link.partition  = part.index;
+            link.ringOffset = part.rings.size();
+            part.rings.resize(part.rings.size() + link.travelSeconds + 1, 0);
+            if (partOf[link.fromNode] != partOf[link.toNode]) ++boundaryLinks_;
+        }
+        for (std::size_t i = 0; i < links.size(); ++i) {
+            if (links_[i].placed) {
+                std::copy_n(ring(links_[i]), links_[i].travelSeconds + 1,
+                            partitions[links[i].partition]->rings.begin() + static_cast<std::ptrdiff_t>(links[i].ringOffset));
+            }
+            links[i].placed = true;
+        }
+        links_ = std::move(links);
+        partitions_ = std::move(partitions);
+
+        // Incoming links per node, CSR
+        inStart_.assign(n + 1, 0);
+        for (const auto& link : links_) ++inStart_[link.toNode + 1];
+        for (std::size_t i = 0; i < n; ++i) inStart_[i + 1] += inStart_[i];
+        inLinks_.resize(links_.size());
+        auto fill = inStart_;
+        for (std::size_t i = 0; i < links_.size(); ++i) {
+            inLinks_[fill[links_[i].toNode]++] = static_cast<uint32_t>(i);
+        }
+
+        layoutValid_ = true;
+    }
+
+    void NetworkCoordinator::tick(uint32_t globalTime) {
+        if (!layoutValid_) buildLayout();
+        std::fill(portFlows_.begin(), portFlows_.end(), 0);
+
+        if (pool_ && partitions_.size() > 1) {
+            pool_->parallelFor(partitions_.size(), 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t p = begin; p < end; ++p) tickPartition(*partitions_[p], globalTime);
+            });
+        } else {
+            for (auto& part : partitions_) tickPartition(*part, globalTime);
+        }
+
+        // Hand boundary vehicles to their downstream partitions
+        for (auto& part : partitions_) {
+            for (const auto& [link, vehicles] : part->outbox) enqueue(links_[link], vehicles);
+            part->outbox.clear();
+            for (const auto& [port, vehicles] : part->ported) portFlows_[port] += vehicles;
+            part->ported.clear();
+
+            stats_.departures += part->stats.departures;
+            stats_.exits      += part->stats.exits;
+            stats_.handedOff  += part->stats.handedOff;
+            stats_.delivered  += part->stats.delivered;
+            stats_.queuedVehicleSeconds += part->stats.queuedVehicleSeconds;
+            part->stats = {};
+        }
+        ++stats_.ticks;
+    }
+
+    void NetworkCoordinator::tickPartition(Partition& part, uint32_t globalTime) {
+        for (std::size_t k = 0; k < part.nodes.size(); ++k) {
+            const uint32_t nodeIdx = part.nodes[k];
+            const auto& node = nodes_[nodeIdx];
+            auto& engine = *node.engine;
+
+            // 1. Arrivals from incoming links
+            part.deltas.clear();
+            for (uint32_t e = inStart_[nodeIdx]; e < inStart_[nodeIdx + 1]; ++e) {
+                const auto& link = links_[inLinks_[e]];
+                uint32_t& slot = ring(link)[stats_.ticks % (std::size_t{link.travelSeconds} + 1)];
+                if (slot > 0) {
+                    part.deltas.push_back({static_cast<uint32_t>(link.toLane), static_cast<int32_t>(slot)});
+                    part.stats.delivered += slot;
+                    slot = 0;
+                }
+            }
+            engine.applyDeltas(part.deltas);
+
+            // 2. Step, or hold ALL_RED before the offset
+            model::Decision decision;
+            if (static_cast<int32_t>(globalTime) - node.offsetSeconds >= 0) {
+                decision = engine.step();
+            } else {
+                decision.phaseNameId = model::WAITING_PHASE_NAME;
+                decision.signalState = model::SignalPhase::ALL_RED;
+            }
+            decisions_[nodeIdx] = decision;
+
+            // 3. Green lanes discharge onto their links, as in sim::Simulator
+            const auto& lanes = std::as_const(engine).lanes();
+            const model::LaneMask green = decision.signalState == model::SignalPhase::GREEN
+                                        ? engine.phases()[decision.selectedPhaseIndex].mask
+                                        : model::LaneMask{0};
+            double* credit = part.credit.data() + part.creditBase[k];
+            part.deltas.clear();
+
+            for (std::size_t l = 0; l < lanes.size(); ++l) {
+                uint32_t departed = 0;
+                if (model::testLane(green, l)) {
+                    credit[l] += config_.saturationFlow;
+                    const auto capacity = static_cast<uint32_t>(credit[l]);
+                    credit[l] -= capacity;
+                    departed = std::min(capacity, lanes[l].queueLength);
+                } else {
+                    credit[l] = 0.0;
+                }
+                part.stats.queuedVehicleSeconds += lanes[l].queueLength - departed;
+                if (departed == 0) continue;
+
+                part.deltas.push_back({static_cast<uint32_t>(l), -static_cast<int32_t>(departed)});
+                part.stats.departures += departed;
+                const uint32_t out = outLink_[node.laneBase + l];
+                if (out == NO_LINK) {
+                    part.stats.exits += departed;
+                } else if (out & PORT_BIT) {
+                    part.stats.handedOff += departed;
+                    part.ported.emplace_back(out & ~PORT_BIT, departed);
+                } else if (links_[out].partition == part.index) {
+                    enqueue(links_[out], departed);
+                } else {
+                    part.outbox.emplace_back(out, departed);
+                }
+            }
+            engine.applyDeltas(part.deltas);
+        }
+    }
+
+    uint64_t NetworkCoordinator::inTransit(std::size_t link) const {
+        const auto& l = links_.at(link);
+        if (!l.placed) return 0;
+        const uint32_t* slots = ring(l);
+        uint64_t total = 0;
+        for (std::size_t s = 0; s <= l.travelSeconds; ++s) total += slots[s];
+        return total;
+    }
+
+    uint64_t NetworkCoordinator::inTransit() const {
+        uint64_t total = 0;
+        for (std::size_t i = 0; i < links_.size(); ++i) total += inTransit(i);
+        return total;
+    }
+
+    void NetworkCoordinator::saveState(NetworkState& state) const {
+        state.engines.resize(nodes_.size());
+        for (std::size_t i = 0; i < nodes_.size(); ++i) nodes_[i].engine->saveState(state.engines[i]);
+
+        state.inTransit.clear();
+        for (const auto& link : links_) {
+            const std::size_t slots = std::size_t{link.travelSeconds} + 1;
+            if (link.placed) {
+                state.inTransit.insert(state.inTransit.end(), ring(link), ring(link) + slots);
+            } else {
+                state.inTransit.resize(state.inTransit.size() + slots, 0);
+            }
+        }
+
+        state.credit.assign(outLink_.size(), 0.0);
+        for (const auto& part : partitions_) {
+            for (std::size_t k = 0; k < part->nodes.size(); ++k) {
+                const auto& node = nodes_[part->nodes[k]];
+                const std::size_t lanes = std::as_const(*node.engine).lanes().size();
+                std::copy_n(part->credit.begin() + static_cast<std::ptrdiff_t>(part->creditBase[k]), lanes,
+                            state.credit.begin() + static_cast<std::ptrdiff_t>(node.laneBase));
+            }
+        }
+        state.stats = stats_;
+    }
+
+    void NetworkCoordinator::restoreState(const NetworkState& state) {
+        std::size_t slots = 0;
+        for (const auto& link : links_) slots += std::size_t{link.travelSeconds} + 1;
+        if (state.engines.size() != nodes_.size() || state.inTransit.size() != slots ||
+            state.credit.size() != outLink_.size()) {
+            throw std::invalid_argument("NetworkCoordinator: state does not match the network topology");
+        }
+        for (std::size_t i = 0; i < nodes_.size(); ++i) nodes_[i].engine->restoreState(state.engines[i]);
+
+        if (!layoutValid_) buildLayout();
+        auto transit = state.inTransit.begin();
+        for (const auto& link : links_) {
+            const auto count = static_cast<std::ptrdiff_t>(link.travelSeconds) + 1;
+            std::copy(transit, transit + count, ring(link));
+            transit += count;
+        }
+        for (auto& part : partitions_) {
+            for (std::size_t k = 0; k < part->nodes.size(); ++k) {
+                const auto& node = nodes_[part->nodes[k]];
+                const std::size_t lanes = std::as_const(*node.engine).lanes().size();
+                std::copy_n(state.credit.begin() + static_cast<std::ptrdiff_t>(node.laneBase), lanes,
+                            part->credit.begin() + static_cast<std::ptrdiff_t>(part->creditBase[k]));
+            }
+        }
+        stats_ = state.stats;
+    }
+
+}
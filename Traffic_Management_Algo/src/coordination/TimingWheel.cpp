@@ -0,0 +1,62 @@
+
+#include "coordination/TimingWheel.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace tip::coordination {
+
+    namespace {
+        [[nodiscard]] std::size_t digit(uint64_t tick, unsigned level) noexcept {
+            return static_cast<std::size_t>(tick >> (level * TimingWheel::SLOT_BITS)) & (TimingWheel::SLOTS - 1);
+        }
+    }
+
+    void TimingWheel::schedule(uint32_t id, uint64_t dueTick) {
+        if (id >= dueTick_.size()) {
+            dueTick_.resize(std::size_t{id} + 1);
+            next_.resize(std::size_t{id} + 1, NIL);
+        }
+        ++pending_;
+        file(id, dueTick);
+    }
+
+    void TimingWheel::file(uint32_t id, uint64_t dueTick) {
+        dueTick = std::max(dueTick, now_);
+        dueTick_[id] = dueTick;
+
+        // Highest digit in which dueTick and now_ differ selects the level
+        const uint64_t diff = dueTick ^ now_;
+        const unsigned level = diff == 0 ? 0 : static_cast<unsigned>(std::bit_width(diff) - 1) / SLOT_BITS;
+        uint32_t& head = head_[level][digit(dueTick, level)];
+        next_[id] = head;
+        head = id;
+    }
+
+    void TimingWheel::advance(std::vector<uint32_t>& due) {
+        // Cascade every level whose lower digits just rolled over, top down,
+        // so ids drop through to the level matching their remaining distance
+        unsigned top = 0;
+        while (top + 1 < LEVELS && digit(now_, top) == 0 && (now_ >> ((top + 1) * SLOT_BITS)) != 0) {
+            ++top;
+        }
+        for (unsigned level = top; level > 0; --level) {
+            uint32_t id = std::exchange(head_[level][digit(now_, level)], NIL);
+            while (id != NIL) {
+                const uint32_t next = next_[id];
+                file(id, dueTick_[id]);
+                id = next;
+            }
+        }
+
+        uint32_t id = std::exchange(head_[0][digit(now_, 0)], NIL);
+        while (id != NIL) {
+            due.push_back(id);
+            --pending_;
+            id = next_[id];
+        }
+        ++now_;
+    }
+
+}
@@ -0,0 +1,188 @@
+
+#include "engine/FleetEngine.hpp"
+#include "model/ConflictMatrix.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace tip::engine {
+
+std::size_t FleetEngine::addIntersection(const std::vector<model::Lane>& lanes, EngineConfig config) {
+    if (lanes.empty()) {
+        throw std::runtime_error("FleetEngine: Cannot add intersection with zero lanes");
+    }
+    if (config.dynamicPhases) {
+        throw std::runtime_error("FleetEngine: Dynamic phase mode is only supported by TrafficEngine");
+    }
+
+    // Phase plans are derived exactly as TrafficEngine does; the conflict
+    // matrix is only needed for validation and is dropped afterwards.
+    model::ConflictMatrix conflicts(lanes);
+    auto phases = PhaseBuilder::build(lanes, conflicts);
+
+    for (const auto& lane : lanes) {
+        queueLength_.push_back(lane.queueLength);
+        waitCounter_.push_back(lane.waitCounter);
+        bleBoost_.push_back(lane.bleBoost);
+        priority_.push_back(lane.priorityReason);
+    }
+
+    phaseBegin_.push_back(static_cast<uint32_t>(phaseNames_.size()));
+    phaseCount_.push_back(static_cast<uint32_t>(phases.size()));
+
+    for (auto& phase : phases) {
+        phaseMask_.push_back(phase.mask);
+        phaseNames_.push_back(phase.nameId);
+    }
+
+    laneBegin_.push_back(static_cast<uint32_t>(queueLength_.size()));
+    configs_.push_back(config);
+    signal_.push_back(model::SignalPhase::ALL_RED);  // Start with all-red
+    currentPhase_.push_back(0);
+    remaining_.push_back(config.allRedTime);
+    decisions_.resize(size());
+    laneScores_.resize(std::max(laneScores_.size(), lanes.size()));
+
+    return size() - 1;
+}
+
+const std::vector<model::Decision>& FleetEngine::stepAll() {
+    for (std::size_t i = 0; i < size(); ++i) {
+        stepOne(i, decisions_[i]);
+    }
+    return decisions_;
+}
+
+void FleetEngine::stepOne(std::size_t i, model::Decision& decision) {
+    decision.phaseScore = 0.0;
+    decision.activePriority = model::PriorityReason::NONE;
+
+    // If time remains in current state, decrement and report current state
+    if (remaining_[i] > 0) {
+        --remaining_[i];
+        decision.greenDuration = remaining_[i];
+    } else {
+        // Time expired — advance the state machine
+        switch (signal_[i]) {
+            case model::SignalPhase::GREEN:
+                signal_[i] = model::SignalPhase::YELLOW;
+                remaining_[i] = configs_[i].yellowTime;
+                decision.greenDuration = 0;
+                break;
+            case model::SignalPhase::YELLOW:
+                signal_[i] = model::SignalPhase::ALL_RED;
+                remaining_[i] = configs_[i].allRedTime;
+                decision.greenDuration = 0;
+                break;
+            case model::SignalPhase::ALL_RED: {
+                currentPhase_[i] = selectPhase(i, decision.activePriority);
+                const model::LaneMask phase = phaseMask_[phaseBegin_[i] + currentPhase_[i]];
+
+                uint32_t greenTime = computeGreenDuration(i, phase);
+                signal_[i] = model::SignalPhase::GREEN;
+                remaining_[i] = greenTime;
+
+                updateFairness(i, phase);
+
+                decision.greenDuration = greenTime;
+                decision.phaseScore = scorePhase(i, phase);
+                break;
+            }
+        }
+    }
+
+    decision.selectedPhaseIndex = currentPhase_[i];
+    decision.phaseNameId = phaseNames_[phaseBegin_[i] + currentPhase_[i]];
+    decision.signalState = signal_[i];
+}
+
+uint32_t FleetEngine::selectPhase(std::size_t i, model::PriorityReason& priority) {
+    const model::LaneMask* masks = phaseMask_.data() + phaseBegin_[i];
+    const uint32_t count = phaseCount_[i];
+
+    // Emergency override: first phase containing an emergency-priority lane
+    if (const model::LaneMask emergency = priorityMask(i, model::PriorityReason::EMERGENCY)) {
+        for (uint32_t p = 0; p < count; ++p) {
+            if (masks[p] & emergency) {
+                priority = model::PriorityReason::EMERGENCY;
+                return p;
+            }
+        }
+    }
+
+    // Lane columns are already contiguous: score them in one SIMD pass
+    const uint32_t base = laneBegin_[i];
+    scoreLanes(queueLength_.data() + base, waitCounter_.data() + base, bleBoost_.data() + base,
+               laneCount(i), configs_[i].alpha, configs_[i].beta, laneScores_.data());
+
+    uint32_t bestIdx = 0;
+    double bestScore = -1.0;
+    for (uint32_t p = 0; p < count; ++p) {
+        double s = 0.0;
+        model::forEachLane(masks[p], [&](std::size_t k) {
+            s += laneScores_[k];
+        });
+        if (s > bestScore) {
+            bestScore = s;
+            bestIdx = p;
+        }
+    }
+
+    if (masks[bestIdx] & priorityMask(i, model::PriorityReason::BLE)) {
+        priority = model::PriorityReason::BLE;
+    }
+    return bestIdx;
+}
+
+model::LaneMask FleetEngine::priorityMask(std::size_t i, model::PriorityReason reason) const noexcept {
+    const model::PriorityReason* prio = priority_.data() + laneBegin_[i];
+    model::LaneMask mask = 0;
+    for (std::size_t k = 0; k < laneCount(i); ++k) {
+        if (prio[k] == reason) {
+            mask |= model::laneBit(k);
+        }
+    }
+    return mask;
+}
+
+double FleetEngine::scorePhase(std::size_t i, model::LaneMask phase) const noexcept {
+    const auto& cfg = configs_[i];
+    const uint32_t base = laneBegin_[i];
+    double total = 0.0;
+    model::forEachLane(phase, [&](std::size_t k) {
+        const std::size_t l = base + k;
+        // Same expression as Lane::score so results are bit-identical
+        total += static_cast<double>(queueLength_[l])
+               + cfg.alpha * static_cast<double>(waitCounter_[l])
+               + cfg.beta  * bleBoost_[l];
+    });
+    return total;
+}
+
+uint32_t FleetEngine::computeGreenDuration(std::size_t i, model::LaneMask phase) const {
+    const auto& cfg = configs_[i];
+    const uint32_t* queue = queueLength_.data() + laneBegin_[i];
+    uint32_t totalQueue = 0;
+    model::forEachLane(phase, [&](std::size_t k) {
+        totalQueue += queue[k];
+    });
+
+    auto rawGreen = static_cast<uint32_t>(
+        std::ceil(static_cast<double>(totalQueue) * cfg.greenPerVehicle));
+
+    return std::clamp(rawGreen, cfg.minGreen, cfg.maxGreen);
+}
+
+void FleetEngine::updateFairness(std::size_t i, model::LaneMask phase) noexcept {
+    // W_i(t+1) = W_i(t) + 1 for every lane, then 0 for lanes that got green
+    uint32_t* wait = waitCounter_.data() + laneBegin_[i];
+    for (std::size_t k = 0; k < laneCount(i); ++k) {
+        ++wait[k];
+    }
+    model::forEachLane(phase, [&](std::size_t k) {
+        wait[k] = 0;
+    });
+}
+
+}
@@ -0,0 +1,122 @@
+
+#include "engine/LaneStateBuffer.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace tip::engine {
+
+    namespace {
+        /// Optimistic snapshot attempts before the reader takes the write side.
+        constexpr int OPTIMISTIC_READS = 64;
+    }
+
+    LaneStateBuffer::LaneStateBuffer(std::size_t laneCount)
+        : laneCount_(laneCount)
+        , slots_(std::make_unique<Slot[]>(laneCount))
+        , applied_(laneCount, 0)
+        , snapshot_(laneCount)
+        , snapshotVersion_(laneCount, 0)
+    {
+        lastApplied_.reserve(laneCount);
+    }
+
+    uint64_t LaneStateBuffer::lockWrite() noexcept {
+        uint64_t seq = seq_.load(std::memory_order_relaxed);
+        for (;;) {
+            if (seq & 1) {
+                std::this_thread::yield();
+                seq = seq_.load(std::memory_order_relaxed);
+                continue;
+            }
+            // acq_rel keeps the payload stores below from moving above the odd mark
+            if (seq_.compare_exchange_weak(seq, seq + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                return seq;
+            }
+        }
+    }
+
+    void LaneStateBuffer::store(std::size_t lane, const LaneInput& input) noexcept {
+        Slot& slot = slots_[lane];
+        slot.queueLength.store(input.queueLength, std::memory_order_relaxed);
+        slot.bleBoostBits.store(std::bit_cast<uint64_t>(input.bleBoost), std::memory_order_relaxed);
+        slot.priorityReason.store(static_cast<uint8_t>(input.priorityReason), std::memory_order_relaxed);
+        slot.version.store(slot.version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    void LaneStateBuffer::publish(std::size_t lane, const LaneInput& input) {
+        if (lane >= laneCount_) {
+            throw std::out_of_range("LaneStateBuffer: lane " + std::to_string(lane) +
+                                    " out of range (" + std::to_string(laneCount_) + " lanes)");
+        }
+        const uint64_t seq = lockWrite();
+        store(lane, input);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    void LaneStateBuffer::publish(std::span<const LaneInput> inputs) {
+        if (inputs.size() != laneCount_) {
+            throw std::invalid_argument("LaneStateBuffer: expected " + std::to_string(laneCount_) +
+                                        " lane inputs, got " + std::to_string(inputs.size()));
+        }
+        const uint64_t seq = lockWrite();
+        for (std::size_t i = 0; i < laneCount_; ++i) {
+            store(i, inputs[i]);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    void LaneStateBuffer::copySnapshot() noexcept {
+        for (std::size_t i = 0; i < laneCount_; ++i) {
+            const Slot& slot = slots_[i];
+            snapshot_[i].queueLength    = slot.queueLength.load(std::memory_order_relaxed);
+            snapshot_[i].bleBoost       = std::bit_cast<double>(slot.bleBoostBits.load(std::memory_order_relaxed));
+            snapshot_[i].priorityReason = static_cast<model::PriorityReason>(slot.priorityReason.load(std::memory_order_relaxed));
+            snapshotVersion_[i]         = slot.version.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool LaneStateBuffer::applyTo(std::vector<model::Lane>& lanes) {
+        uint64_t seq = seq_.load(std::memory_order_acquire);
+        if (seq == lastSeq_) {
+            return false;
+        }
+
+        bool consistent = false;
+        for (int attempt = 0; attempt < OPTIMISTIC_READS && !consistent; ++attempt) {
+            seq = seq_.load(std::memory_order_acquire);
+            if (seq & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            copySnapshot();
+            // A release RMW keeps the payload loads above from sinking below
+            // the re-check (Boehm's seqlock reader; no standalone fence)
+            consistent = seq_.fetch_add(0, std::memory_order_release) == seq;
+        }
+        if (!consistent) {
+            // Writers kept interleaving: hold them off for one copy. Restoring
+            // the old even value marks no new publication.
+            seq = lockWrite();
+            copySnapshot();
+            seq_.store(seq, std::memory_order_release);
+        }
+        lastSeq_ = seq;
+
+        const std::size_t count = std::min(laneCount_, lanes.size());
+        lastApplied_.clear();
+        for (std::size_t i = 0; i < count; ++i) {
+            if (snapshotVersion_[i] == applied_[i]) continue;
+            applied_[i] = snapshotVersion_[i];
+            lastApplied_.push_back(i);
+            lanes[i].queueLength    = snapshot_[i].queueLength;
+            lanes[i].bleBoost       = snapshot_[i].bleBoost;
+            lanes[i].priorityReason = snapshot_[i].priorityReason;
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,153 @@
+
+#include "engine/MaxWeightSearch.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace tip::engine {
+
+namespace {
+    /// Sum of laneScores over mask, in lane order.
+    template <typename Mask>
+    double maskScore(const Mask& mask, std::span<const double> laneScores, std::size_t n) {
+        double total = 0.0;
+        model::forEachLane(mask, [&](std::size_t i) {
+            if (i < n) total += laneScores[i];
+        });
+        return total;
+    }
+}
+
+template <typename Mask>
+Mask MaxWeightSearch<Mask>::solve(const model::BasicConflictMatrix<Mask>& conflicts,
+                                  std::span<const double> laneScores,
+                                  const Mask& seed,
+                                  uint64_t nodeBudget)
+{
+    const std::size_t n = std::min(laneScores.size(), conflicts.size());
+
+    // Rank lanes by score, highest first; ties keep lane order (explicit
+    // tie-break rather than stable_sort, which allocates a merge buffer)
+    order_.resize(n);
+    std::iota(order_.begin(), order_.end(), std::size_t{0});
+    std::sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) {
+        return laneScores[a] > laneScores[b] || (laneScores[a] == laneScores[b] && a < b);
+    });
+
+    // The seed is the incumbent to beat
+    const double seedScore = maskScore(seed, laneScores, n);
+
+    // Reuse the previous answer while the dominant lanes are unchanged, unless
+    // the scores have shifted enough that the seed now beats it
+    if (hasCache_ && model::anyLane(cachedDominant_) &&
+        dominantLanes(n, model::laneCount(cachedDominant_)) == cachedDominant_ &&
+        maskScore(cachedResult_, laneScores, n) >= seedScore) {
+        lastCached_ = true;
+        outOfBudget_ = false;
+        return cachedResult_;
+    }
+    lastCached_ = false;
+
+    // Only positive-score lanes can improve the objective
+    std::size_t m = 0;
+    while (m < n && laneScores[order_[m]] > 0.0) ++m;
+
+    // Conflict masks in rank space, sized for every lane up front so a later
+    // larger m does not allocate
+    rankConflicts_.reserve(n);
+    rankScores_.reserve(n);
+    rankConflicts_.assign(m, Mask{});
+    rankScores_.resize(m);
+    for (std::size_t r = 0; r < m; ++r) {
+        const Mask& laneConflicts = conflicts.conflictsOf(order_[r]);
+        for (std::size_t q = 0; q < m; ++q) {
+            if (model::testLane(laneConflicts, order_[q])) {
+                model::setLane(rankConflicts_[r], q);
+            }
+        }
+        rankScores_[r] = laneScores[order_[r]];
+    }
+
+    bestScore_   = seedScore;
+    bestRanked_  = Mask{};
+    seedIsBest_  = true;
+    nodes_       = 0;
+    nodeBudget_  = nodeBudget;
+    outOfBudget_ = false;
+
+    Mask all{};
+    for (std::size_t r = 0; r < m; ++r) {
+        model::setLane(all, r);
+    }
+    branch(all, Mask{}, 0.0);
+
+    Mask result = seed;
+    if (!seedIsBest_) {
+        result = Mask{};
+        model::forEachLane(bestRanked_, [&](std::size_t r) {
+            model::setLane(result, order_[r]);
+        });
+    }
+
+    // Fill spare capacity with any remaining compatible lanes
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!model::testLane(result, i) && !model::intersects(conflicts.conflictsOf(i), result)) {
+            model::setLane(result, i);
+        }
+    }
+
+    if (!outOfBudget_) {
+        std::size_t k = 0;
+        model::forEachLane(result, [&](std::size_t i) {
+            if (laneScores[i] > 0.0) ++k;
+        });
+        cachedDominant_ = dominantLanes(n, k);
+        cachedResult_   = result;
+        hasCache_       = true;
+    }
+    return result;
+}
+
+template <typename Mask>
+void MaxWeightSearch<Mask>::branch(const Mask& candidates, const Mask& current, double score) {
+    if (++nodes_ > nodeBudget_) {
+        outOfBudget_ = true;
+    }
+    if (outOfBudget_) return;
+
+    if (score > bestScore_) {
+        bestScore_  = score;
+        bestRanked_ = current;
+        seedIsBest_ = false;
+    }
+    if (!model::anyLane(candidates)) return;
+
+    // Bound: even taking every remaining candidate cannot beat the incumbent
+    double bound = score;
+    model::forEachLane(candidates, [&](std::size_t r) { bound += rankScores_[r]; });
+    if (bound <= bestScore_) return;
+
+    // Branch on the highest-scoring candidate: take it, then skip it
+    const std::size_t r = model::firstLane(candidates);
+    Mask bit{};
+    model::setLane(bit, r);
+    const Mask rest = model::andNot(candidates, bit);
+    branch(model::andNot(rest, rankConflicts_[r]), current | bit, score + rankScores_[r]);
+    branch(rest, current, score);
+}
+
+template <typename Mask>
+Mask MaxWeightSearch<Mask>::dominantLanes(std::size_t count, std::size_t k) const {
+    Mask mask{};
+    for (std::size_t r = 0; r < std::min(count, k); ++r) {
+        model::setLane(mask, order_[r]);
+    }
+    return mask;
+}
+
+template class MaxWeightSearch<model::LaneMask>;
+template class MaxWeightSearch<model::LaneBitset<128>>;
+template class MaxWeightSearch<model::LaneBitset<256>>;
+template class MaxWeightSearch<model::DynamicLaneBitset>;
+
+}
@@ -6,9 +6,10 @@
 
 namespace tip::engine {
 
-std::vector<model::Phase> PhaseBuilder::build(
+template <typename Mask>
+std::vector<model::BasicPhase<Mask>> PhaseBuilder::build(
     const std::vector<model::Lane>& lanes,
-    const model::ConflictMatrix& conflicts)
+    const model::BasicConflictMatrix<Mask>& conflicts)
 {
     if (lanes.empty()) {
         throw std::runtime_error("PhaseBuilder: No lanes provided");
@@ -25,7 +26,7 @@ std::vector<model::Phase> PhaseBuilder::build(
         numApproaches = std::max(numApproaches, lane.direction.numApproaches);
     }
 
-    std::vector<model::Phase> phases;
+    std::vector<model::BasicPhase<Mask>> phases;
     std::set<uint16_t> processedApproaches;
 
     // For even N: pair opposing approaches (i with i + N/2)
@@ -67,7 +68,7 @@ std::vector<model::Phase> PhaseBuilder::build(
         // Through phase
         auto throughLanes = collectLanes(lanes, groupApproaches, model::MovementType::THROUGH);
         if (!throughLanes.empty()) {
-            model::Phase p(groupName + "-through", std::move(throughLanes));
+            model::BasicPhase<Mask> p(groupName + "-through", std::move(throughLanes));
             validatePhase(p, conflicts);
             phases.push_back(std::move(p));
         }
@@ -75,7 +76,7 @@ std::vector<model::Phase> PhaseBuilder::build(
         // Left-protected phase
         auto leftLanes = collectLanes(lanes, groupApproaches, model::MovementType::LEFT_PROTECTED);
         if (!leftLanes.empty()) {
-            model::Phase p(groupName + "-left", std::move(leftLanes));
+            model::BasicPhase<Mask> p(groupName + "-left", std::move(leftLanes));
             validatePhase(p, conflicts);
             phases.push_back(std::move(p));
         }
@@ -107,10 +108,16 @@ std::vector<std::size_t> PhaseBuilder::collectLanes(
     return indices;
 }
 
+template <typename Mask>
 void PhaseBuilder::validatePhase(
-    const model::Phase& phase,
-    const model::ConflictMatrix& conflicts)
+    const model::BasicPhase<Mask>& phase,
+    const model::BasicConflictMatrix<Mask>& conflicts)
 {
+    if (conflicts.isFeasible(phase.mask)) {
+        return;
+    }
+
+    // Locate the offending pair for the error message
     const auto& idx = phase.laneIndices;
     for (std::size_t i = 0; i < idx.size(); ++i) {
         for (std::size_t j = i + 1; j < idx.size(); ++j) {
@@ -124,4 +131,13 @@ void PhaseBuilder::validatePhase(
     }
 }
 
+template std::vector<model::BasicPhase<model::LaneMask>> PhaseBuilder::build(
+    const std::vector<model::Lane>&, const model::BasicConflictMatrix<model::LaneMask>&);
+template std::vector<model::BasicPhase<model::LaneBitset<128>>> PhaseBuilder::build(
+    const std::vector<model::Lane>&, const model::BasicConflictMatrix<model::LaneBitset<128>>&);
+template std::vector<model::BasicPhase<model::LaneBitset<256>>> PhaseBuilder::build(
+    const std::vector<model::Lane>&, const model::BasicConflictMatrix<model::LaneBitset<256>>&);
+template std::vector<model::BasicPhase<model::DynamicLaneBitset>> PhaseBuilder::build(
+    const std::vector<model::Lane>&, const model::BasicConflictMatrix<model::DynamicLaneBitset>&);
+
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "engine/PhaseMaskTable.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+#include <utility>
+
+namespace tip::engine {
+
+template <typename Mask>
+void PhaseMaskTable<Mask>::reset(std::size_t maxEntries) {
+    // At most half full keeps probe sequences short
+    const std::size_t buckets = std::bit_ceil(std::max<std::size_t>(2, maxEntries * 2));
+    buckets_.assign(buckets, Entry{});
+    bucketMask_ = buckets - 1;
+    size_ = 0;
+}
+
+template <typename Mask>
+uint64_t PhaseMaskTable<Mask>::hashOf(const Mask& mask) noexcept {
+    uint64_t h = 0;
+    if constexpr (std::is_same_v<Mask, model::LaneMask>) {
+        h = mask;
+    } else {
+        // Over set lanes, so DynamicLaneBitsets with trailing zero words hash alike
+        model::forEachLane(mask, [&](std::size_t i) { h = (h ^ (i + 1)) * 0x100000001B3ULL; });
+    }
+    // splitmix64 finalizer
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+template <typename Mask>
+std::size_t PhaseMaskTable<Mask>::slotOf(const Mask& mask, uint64_t hash) const noexcept {
+    for (std::size_t b = hash & bucketMask_;; b = (b + 1) & bucketMask_) {
+        const Entry& e = buckets_[b];
+        if (e.index == NOT_FOUND || (e.hash == hash && e.mask == mask)) return b;
+    }
+}
+
+template <typename Mask>
+std::size_t PhaseMaskTable<Mask>::find(const Mask& mask) const noexcept {
+    if (buckets_.empty()) return NOT_FOUND;
+    return buckets_[slotOf(mask, hashOf(mask))].index;
+}
+
+template <typename Mask>
+void PhaseMaskTable<Mask>::insert(const Mask& mask, std::size_t index) {
+    const uint64_t hash = hashOf(mask);
+    Entry& e = buckets_[slotOf(mask, hash)];
+    if (e.index != NOT_FOUND) return;
+    e.hash = hash;
+    e.index = index;
+    e.mask = mask;
+    ++size_;
+}
+
+template <typename Mask>
+void PhaseMaskTable<Mask>::erase(const Mask& mask, std::size_t index) noexcept {
+    if (buckets_.empty()) return;
+    std::size_t hole = slotOf(mask, hashOf(mask));
+    if (buckets_[hole].index != index) return;
+
+    // Backward-shift: pull later entries of the cluster into the hole when
+    // the hole lies between their home bucket and where they sit
+    for (std::size_t b = (hole + 1) & bucketMask_; buckets_[b].index != NOT_FOUND; b = (b + 1) & bucketMask_) {
+        const std::size_t home = buckets_[b].hash & bucketMask_;
+        if (((b - home) & bucketMask_) >= ((b - hole) & bucketMask_)) {
+            std::swap(buckets_[hole], buckets_[b]);
+            hole = b;
+        }
+    }
+    buckets_[hole].index = NOT_FOUND;
+    --size_;
+}
+
+template class PhaseMaskTable<model::LaneMask>;
+template class PhaseMaskTable<model::LaneBitset<128>>;
+template class PhaseMaskTable<model::LaneBitset<256>>;
+template class PhaseMaskTable<model::DynamicLaneBitset>;
+
+}
@@ -0,0 +1,259 @@
+#include "engine/PhaseScoreIndex.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace tip::engine {
+
+    namespace {
+        /// Phases within this fraction of the best key are rescored exactly.
+        constexpr double TIE_TOLERANCE = 1e-9;
+
+        /// Rebase keys once the epoch has moved this far past base_.
+        constexpr int64_t REBASE_INTERVAL = int64_t{1} << 20;
+    }
+
+    void PhaseScoreIndex::build(const std::vector<std::vector<std::size_t>>& phaseLanes, std::size_t laneCount) {
+        if (phaseLanes.size() >= NONE || laneCount >= NONE) {
+            throw std::invalid_argument("PhaseScoreIndex: too many phases or lanes");
+        }
+        phaseCount_ = phaseLanes.size();
+
+        // Phase → lanes, sorted so exact rescoring sums in lane order
+        phaseLaneStart_.assign(1, 0);
+        phaseLanes_.clear();
+        std::vector<uint32_t> perLane(laneCount, 0);
+        for (const auto& lanes : phaseLanes) {
+            const std::size_t start = phaseLanes_.size();
+            for (std::size_t lane : lanes) {
+                if (lane >= laneCount) {
+                    throw std::out_of_range("PhaseScoreIndex: lane " + std::to_string(lane) +
+                                            " out of range for " + std::to_string(laneCount) + " lanes");
+                }
+                phaseLanes_.push_back(static_cast<uint32_t>(lane));
+            }
+            std::sort(phaseLanes_.begin() + static_cast<std::ptrdiff_t>(start), phaseLanes_.end());
+            phaseLanes_.erase(std::unique(phaseLanes_.begin() + static_cast<std::ptrdiff_t>(start), phaseLanes_.end()),
+                              phaseLanes_.end());
+            for (std::size_t i = start; i < phaseLanes_.size(); ++i) ++perLane[phaseLanes_[i]];
+            phaseLaneStart_.push_back(static_cast<uint32_t>(phaseLanes_.size()));
+        }
+
+        // Lane → phases
+        lanePhaseStart_.assign(laneCount + 1, 0);
+        for (std::size_t l = 0; l < laneCount; ++l) lanePhaseStart_[l + 1] = lanePhaseStart_[l] + perLane[l];
+        lanePhases_.resize(phaseLanes_.size());
+        std::vector<uint32_t> fill(lanePhaseStart_.begin(), lanePhaseStart_.end() - 1);
+        for (uint32_t p = 0; p < phaseCount_; ++p) {
+            for (uint32_t i = phaseLaneStart_[p]; i < phaseLaneStart_[p + 1]; ++i) {
+                lanePhases_[fill[phaseLanes_[i]]++] = p;
+            }
+        }
+
+        // Size groups
+        groups_.clear();
+        groupOf_.resize(phaseCount_);
+        leafOf_.resize(phaseCount_);
+        for (uint32_t p = 0; p < phaseCount_; ++p) {
+            const uint32_t size = phaseLaneStart_[p + 1] - phaseLaneStart_[p];
+            auto it = std::find_if(groups_.begin(), groups_.end(), [&](const Group& g) { return g.size == size; });
+            if (it == groups_.end()) {
+                groups_.push_back({size, 0, {}});
+                it = groups_.end() - 1;
+            }
+            groupOf_[p] = static_cast<uint32_t>(it - groups_.begin());
+            leafOf_[p] = it->leaves++;  // count for now
+        }
+        for (auto& g : groups_) {
+            g.leaves = std::bit_ceil(std::max<uint32_t>(g.leaves, 1));
+            g.tree.assign(2 * g.leaves, NONE);
+        }
+        for (uint32_t p = 0; p < phaseCount_; ++p) {
+            groups_[groupOf_[p]].tree[groups_[groupOf_[p]].leaves + leafOf_[p]] = p;
+        }
+
+        queue_.assign(laneCount, 0);
+        waitEpoch_.assign(laneCount, 0);
+        boost_.assign(laneCount, 0.0);
+        epoch_ = 0;
+        base_ = 0;
+
+        queueSum_.assign(phaseCount_, 0);
+        waitEpochSum_.assign(phaseCount_, 0);
+        boostSum_.assign(phaseCount_, 0.0);
+        boostStale_.assign(phaseCount_, 0);
+        key_.assign(phaseCount_, 0.0);
+        pending_.clear();
+        isPending_.assign(phaseCount_, 0);
+        keysValid_ = false;
+    }
+
+    void PhaseScoreIndex::setLane(std::size_t lane, uint32_t queue, uint32_t wait, double boost) {
+        const int64_t waitEpoch = epoch_ - wait;
+        touchLane(lane, int64_t{queue} - queue_[lane], waitEpoch - waitEpoch_[lane], boost != boost_[lane]);
+        queue_[lane] = queue;
+        waitEpoch_[lane] = waitEpoch;
+        boost_[lane] = boost;
+    }
+
+    void PhaseScoreIndex::nextEpoch() {
+        ++epoch_;
+        if (epoch_ - base_ >= REBASE_INTERVAL) {
+            base_ = epoch_;
+            keysValid_ = false;
+        }
+    }
+
+    void PhaseScoreIndex::resetWait(std::size_t lane) {
+        touchLane(lane, 0, epoch_ - waitEpoch_[lane], false);
+        waitEpoch_[lane] = epoch_;
+    }
+
+    void PhaseScoreIndex::touchLane(std::size_t lane, int64_t queueDelta, int64_t waitEpochDelta, bool boostChanged) {
+        if (!keysValid_) return;  // Everything is recomputed on the next query
+        if (queueDelta == 0 && waitEpochDelta == 0 && !boostChanged) return;
+        for (uint32_t i = lanePhaseStart_[lane]; i < lanePhaseStart_[lane + 1]; ++i) {
+            const uint32_t p = lanePhases_[i];
+            queueSum_[p] += queueDelta;
+            waitEpochSum_[p] += waitEpochDelta;
+            boostStale_[p] |= boostChanged;
+            if (!isPending_[p]) {
+                isPending_[p] = 1;
+                pending_.push_back(p);
+            }
+        }
+    }
+
+    void PhaseScoreIndex::recompute(uint32_t phase) {
+        int64_t queue = 0;
+        int64_t waitEpoch = 0;
+        double  boost = 0.0;
+        for (uint32_t i = phaseLaneStart_[phase]; i < phaseLaneStart_[phase + 1]; ++i) {
+            const uint32_t lane = phaseLanes_[i];
+            queue     += queue_[lane];
+            waitEpoch += waitEpoch_[lane];
+            boost     += boost_[lane];
+        }
+        queueSum_[phase] = queue;
+        waitEpochSum_[phase] = waitEpoch;
+        boostSum_[phase] = boost;
+        boostStale_[phase] = 0;
+        updateKey(phase);
+    }
+
+    void PhaseScoreIndex::updateKey(uint32_t phase) {
+        if (boostStale_[phase]) {
+            double boost = 0.0;
+            for (uint32_t i = phaseLaneStart_[phase]; i < phaseLaneStart_[phase + 1]; ++i) {
+                boost += boost_[phaseLanes_[i]];
+            }
+            boostSum_[phase] = boost;
+            boostStale_[phase] = 0;
+        }
+        const int64_t size = phaseLaneStart_[phase + 1] - phaseLaneStart_[phase];
+        key_[phase] = static_cast<double>(queueSum_[phase]) + beta_ * boostSum_[phase]
+                    + alpha_ * static_cast<double>(size * base_ - waitEpochSum_[phase]);
+    }
+
+    bool PhaseScoreIndex::better(uint32_t a, uint32_t b) const noexcept {
+        if (b == NONE) return a != NONE;
+        if (a == NONE) return false;
+        return key_[a] > key_[b] || (key_[a] == key_[b] && a < b);
+    }
+
+    void PhaseScoreIndex::updateLeaf(uint32_t phase) {
+        auto& g = groups_[groupOf_[phase]];
+        for (uint32_t node = (g.leaves + leafOf_[phase]) / 2; node >= 1; node /= 2) {
+            const uint32_t left = g.tree[2 * node];
+            const uint32_t right = g.tree[2 * node + 1];
+            const uint32_t winner = better(right, left) ? right : left;
+            // Ancestors only see this node's winner; stop once it is a phase
+            // other than the changed one, both before and after
+            if (winner == g.tree[node] && winner != phase) break;
+            g.tree[node] = winner;
+        }
+    }
+
+    void PhaseScoreIndex::collect(const Group& group, uint32_t node, double threshold) {
+        const uint32_t winner = group.tree[node];
+        if (winner == NONE || key_[winner] < threshold) return;
+        if (node >= group.leaves) {
+            candidates_.push_back(winner);
+            return;
+        }
+        collect(group, 2 * node, threshold);
+        collect(group, 2 * node + 1, threshold);
+    }
+
+    double PhaseScoreIndex::exactScore(uint32_t phase, double alpha, double beta) const {
+        // Same expression and order as Lane::score() summed over the phase mask
+        double total = 0.0;
+        for (uint32_t i = phaseLaneStart_[phase]; i < phaseLaneStart_[phase + 1]; ++i) {
+            const uint32_t lane = phaseLanes_[i];
+            const auto wait = static_cast<uint32_t>(epoch_ - waitEpoch_[lane]);
+            total += static_cast<double>(queue_[lane])
+                   + alpha * static_cast<double>(wait)
+                   + beta  * boost_[lane];
+        }
+        return total;
+    }
+
+    std::size_t PhaseScoreIndex::best(double alpha, double beta) {
+        if (phaseCount_ == 0) return 0;
+
+        if (!keysValid_ || alpha != alpha_ || beta != beta_) {
+            alpha_ = alpha;
+            beta_ = beta;
+            for (uint32_t p = 0; p < phaseCount_; ++p) recompute(p);
+            for (auto& g : groups_) {
+                for (uint32_t node = g.leaves - 1; node >= 1; --node) {
+                    const uint32_t left = g.tree[2 * node];
+                    const uint32_t right = g.tree[2 * node + 1];
+                    g.tree[node] = better(right, left) ? right : left;
+                }
+            }
+            for (uint32_t p : pending_) isPending_[p] = 0;
+            pending_.clear();
+            keysValid_ = true;
+        } else {
+            for (uint32_t p : pending_) {
+                isPending_[p] = 0;
+                updateKey(p);
+                updateLeaf(p);
+            }
+            pending_.clear();
+        }
+
+        // Best total over groups: key + α·size·(E - base)
+        const auto sinceBase = static_cast<double>(epoch_ - base_);
+        double top = -std::numeric_limits<double>::infinity();
+        for (const auto& g : groups_) {
+            if (g.tree[1] == NONE) continue;
+            top = std::max(top, key_[g.tree[1]] + alpha_ * static_cast<double>(g.size) * sinceBase);
+        }
+
+        // Rescore everything near the top exactly; lowest index wins ties
+        const double cutoff = top - TIE_TOLERANCE * (1.0 + std::fabs(top));
+        candidates_.clear();
+        for (const auto& g : groups_) {
+            collect(g, 1, cutoff - alpha_ * static_cast<double>(g.size) * sinceBase);
+        }
+        std::sort(candidates_.begin(), candidates_.end());
+
+        std::size_t bestPhase = 0;
+        double bestScore = -1.0;
+        for (uint32_t p : candidates_) {
+            const double score = exactScore(p, alpha, beta);
+            if (score > bestScore) {
+                bestScore = score;
+                bestPhase = p;
+            }
+        }
+        return bestPhase;
+    }
+
+}
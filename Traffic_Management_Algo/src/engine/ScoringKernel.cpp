@@ -0,0 +1,133 @@
+
+#include "engine/ScoringKernel.hpp"
+
+#include <atomic>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TIP_SCORING_X86 1
+#include <immintrin.h>
+#else
+#define TIP_SCORING_X86 0
+#endif
+
+namespace tip::engine {
+
+    namespace {
+
+        using KernelFn = void (*)(const uint32_t*, const uint32_t*, const double*,
+                                  std::size_t, double, double, double*) noexcept;
+
+        void scoreScalar(const uint32_t* queue, const uint32_t* wait, const double* boost,
+                         std::size_t count, double alpha, double beta, double* out) noexcept {
+            for (std::size_t i = 0; i < count; ++i) {
+                out[i] = static_cast<double>(queue[i])
+                       + alpha * static_cast<double>(wait[i])
+                       + beta  * boost[i];
+            }
+        }
+
+#if TIP_SCORING_X86
+        // cvtepi32_pd is signed; bias by 2^31 so uint32 values convert exactly.
+
+        __attribute__((target("sse4.2")))
+        inline __m128d u32x2ToPd(const uint32_t* p) noexcept {
+            __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p));
+            v = _mm_xor_si128(v, _mm_set1_epi32(INT32_MIN));
+            return _mm_add_pd(_mm_cvtepi32_pd(v), _mm_set1_pd(2147483648.0));
+        }
+
+        __attribute__((target("sse4.2")))
+        void scoreSse42(const uint32_t* queue, const uint32_t* wait, const double* boost,
+                        std::size_t count, double alpha, double beta, double* out) noexcept {
+            const __m128d a = _mm_set1_pd(alpha);
+            const __m128d b = _mm_set1_pd(beta);
+            std::size_t i = 0;
+            for (; i + 2 <= count; i += 2) {
+                __m128d s = _mm_add_pd(u32x2ToPd(queue + i), _mm_mul_pd(a, u32x2ToPd(wait + i)));
+                s = _mm_add_pd(s, _mm_mul_pd(b, _mm_loadu_pd(boost + i)));
+                _mm_storeu_pd(out + i, s);
+            }
+            scoreScalar(queue + i, wait + i, boost + i, count - i, alpha, beta, out + i);
+        }
+
+        __attribute__((target("avx2")))
+        inline __m256d u32x4ToPd(const uint32_t* p) noexcept {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            v = _mm_xor_si128(v, _mm_set1_epi32(INT32_MIN));
+            return _mm256_add_pd(_mm256_cvtepi32_pd(v), _mm256_set1_pd(2147483648.0));
+        }
+
+        __attribute__((target("avx2")))
+        void scoreAvx2(const uint32_t* queue, const uint32_t* wait, const double* boost,
+                       std::size_t count, double alpha, double beta, double* out) noexcept {
+            const __m256d a = _mm256_set1_pd(alpha);
+            const __m256d b = _mm256_set1_pd(beta);
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                __m256d s = _mm256_add_pd(u32x4ToPd(queue + i), _mm256_mul_pd(a, u32x4ToPd(wait + i)));
+                s = _mm256_add_pd(s, _mm256_mul_pd(b, _mm256_loadu_pd(boost + i)));
+                _mm256_storeu_pd(out + i, s);
+            }
+            scoreScalar(queue + i, wait + i, boost + i, count - i, alpha, beta, out + i);
+        }
+#endif
+
+        KernelFn kernelFor(ScoringIsa isa) noexcept {
+#if TIP_SCORING_X86
+            switch (isa) {
+                case ScoringIsa::AVX2:   return scoreAvx2;
+                case ScoringIsa::SSE42:  return scoreSse42;
+                case ScoringIsa::SCALAR: break;
+            }
+#else
+            (void)isa;
+#endif
+            return scoreScalar;
+        }
+
+        std::atomic<ScoringIsa>& activeIsa() noexcept {
+            static std::atomic<ScoringIsa> isa{detectScoringIsa()};
+            return isa;
+        }
+
+    }
+
+    std::string to_string(ScoringIsa isa) {
+        switch (isa) {
+            case ScoringIsa::SCALAR: return "SCALAR";
+            case ScoringIsa::SSE42:  return "SSE4.2";
+            case ScoringIsa::AVX2:   return "AVX2";
+        }
+        return "UNKNOWN";
+    }
+
+    ScoringIsa detectScoringIsa() noexcept {
+#if TIP_SCORING_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))   return ScoringIsa::AVX2;
+        if (__builtin_cpu_supports("sse4.2")) return ScoringIsa::SSE42;
+#endif
+        return ScoringIsa::SCALAR;
+    }
+
+    ScoringIsa activeScoringIsa() noexcept {
+        return activeIsa().load(std::memory_order_relaxed);
+    }
+
+    void setScoringIsa(ScoringIsa isa) noexcept {
+        const ScoringIsa best = detectScoringIsa();
+        activeIsa().store(isa > best ? best : isa, std::memory_order_relaxed);
+    }
+
+    void scoreLanes(const uint32_t* queue, const uint32_t* wait, const double* boost,
+                    std::size_t count, double alpha, double beta, double* out) noexcept {
+        kernelFor(activeScoringIsa())(queue, wait, boost, count, alpha, beta, out);
+    }
+
+    void scoreLanes(ScoringIsa isa,
+                    const uint32_t* queue, const uint32_t* wait, const double* boost,
+                    std::size_t count, double alpha, double beta, double* out) noexcept {
+        kernelFor(isa)(queue, wait, boost, count, alpha, beta, out);
+    }
+
+}
@@ -1,41 +1,111 @@
 
 #include "engine/TrafficEngine.hpp"
+#include "metrics/Metrics.hpp"
 
 #include <algorithm>
 #include <numeric>
 #include <cmath>
+#include <limits>
 #include <stdexcept>
 
 namespace tip::engine {
 
-TrafficEngine::TrafficEngine(std::vector<model::Lane> lanes, EngineConfig config)
+template <typename Mask>
+BasicTrafficEngine<Mask>::BasicTrafficEngine(std::vector<model::Lane> lanes, EngineConfig config)
     : lanes_(std::move(lanes))
     , config_(config)
     , conflicts_(lanes_)
     , phases_(PhaseBuilder::build(lanes_, conflicts_))
+    , plannedPhaseCount_(phases_.size())
+    , dynamicSlots_(std::max<std::size_t>(1, config_.dynamicPhaseSlots))
+    // Dynamic mode scores every lane for the search anyway, so the index only adds work there
+    , incremental_(!config_.dynamicPhases && plannedPhaseCount_ >= config_.incrementalScoringMinPhases)
+    , laneInputs_(std::make_unique<LaneStateBuffer>(lanes_.size()))
     , currentSignal_(model::SignalPhase::ALL_RED)
     , currentPhaseIdx_(0)
     , remainingTime_(config_.allRedTime)  // Start with all-red
+    , stateSteps_(remainingTime_ + 1)
+    , queueScratch_(lanes_.size())
+    , waitScratch_(lanes_.size())
+    , boostScratch_(lanes_.size())
+    , laneScores_(lanes_.size())
 {
     if (lanes_.empty()) {
         throw std::runtime_error("TrafficEngine: Cannot initialize with zero lanes");
     }
+    for (std::size_t i = 0; i < lanes_.size(); ++i) {
+        model::setLane(allLanes_, i);
+    }
+    markAllLanesDirty();
+    if (incremental_) {
+        scoreIndex_.build(std::span<const Phase>(phases_.data(), plannedPhaseCount_), lanes_.size());
+    }
 }
 
-model::Decision TrafficEngine::step() {
-    model::Decision decision;
+template <typename Mask>
+void BasicTrafficEngine<Mask>::updateQueues(std::span<const uint32_t> queues) {
+    if (queues.size() != lanes_.size()) {
+        throw std::invalid_argument(
+            "TrafficEngine: updateQueues got " + std::to_string(queues.size()) +
+            " queues for " + std::to_string(lanes_.size()) + " lanes");
+    }
+    for (std::size_t i = 0; i < queues.size(); ++i) {
+        if (lanes_[i].queueLength != queues[i]) {
+            lanes_[i].queueLength = queues[i];
+            markDirty(i);
+        }
+    }
+}
+
+template <typename Mask>
+void BasicTrafficEngine<Mask>::applyDeltas(std::span<const LaneDelta> deltas) {
+    for (const auto& d : deltas) {
+        if (d.lane >= lanes_.size()) {
+            throw std::out_of_range(
+                "TrafficEngine: delta for lane " + std::to_string(d.lane) +
+                " but only " + std::to_string(lanes_.size()) + " lanes");
+        }
+    }
+    for (const auto& d : deltas) {
+        if (d.queueDelta == 0) continue;
+        auto& queue = lanes_[d.lane].queueLength;
+        const auto updated = static_cast<uint32_t>(std::clamp<int64_t>(
+            static_cast<int64_t>(queue) + d.queueDelta, 0, std::numeric_limits<uint32_t>::max()));
+        if (updated == queue) continue;  // Clamped at an end: nothing to rescore
+        queue = updated;
+        markDirty(d.lane);
+    }
+}
+
+template <typename Mask>
+model::Decision BasicTrafficEngine<Mask>::step() {
+    // Pick up sensor inputs published since the last step
+    if (laneInputs_->applyTo(lanes_)) {
+        for (std::size_t lane : laneInputs_->lastApplied()) {
+            markDirty(lane);
+        }
+    }
 
     // If time remains in current state, decrement and return current state info
     if (remainingTime_ > 0) {
         --remainingTime_;
-        decision.selectedPhaseIndex = currentPhaseIdx_;
-        decision.phaseName = phases_[currentPhaseIdx_].name;
-        decision.signalState = currentSignal_;
-        decision.greenDuration = remainingTime_;
-        return decision;
+        return currentDecision();
     }
 
     // Time expired — advance the state machine
+    return changeState();
+}
+
+template <typename Mask>
+model::Decision BasicTrafficEngine<Mask>::changeState() {
+    // Only state changes are timed, and steps are counted here a whole state
+    // at a time, so countdown steps stay free of instrumentation
+    TIP_METRICS_SCOPE();
+    TIP_TIME(STATE_CHANGE);
+    TIP_COUNT(STEPS, stateSteps_);
+
+    model::Decision decision;
+
     switch (currentSignal_) {
         case model::SignalPhase::GREEN: {
             // GREEN → YELLOW
@@ -53,21 +123,25 @@ model::Decision TrafficEngine::step() {
             // ALL_RED → select next phase → GREEN
 
             // Check for emergency override first
+            const std::size_t previousPhaseIdx = currentPhaseIdx_;
             auto emergencyPhase = findEmergencyPhase();
             if (emergencyPhase.has_value()) {
                 currentPhaseIdx_ = emergencyPhase.value();
                 decision.activePriority = model::PriorityReason::EMERGENCY;
+                TIP_COUNT(EMERGENCY_OVERRIDES, 1);
             } else {
-                currentPhaseIdx_ = selectBestPhase();
+                TIP_TIME(PHASE_SELECTION);
+                currentPhaseIdx_ = config_.dynamicPhases ? selectDynamicPhase() : selectBestPhase();
                 // Check if selected phase has BLE priority
-                for (auto idx : phases_[currentPhaseIdx_].laneIndices) {
-                    if (lanes_[idx].priorityReason == model::PriorityReason::BLE) {
-                        decision.activePriority = model::PriorityReason::BLE;
-                        break;
-                    }
+                if (model::intersects(phases_[currentPhaseIdx_].mask, priorityMask(model::PriorityReason::BLE))) {
+                    decision.activePriority = model::PriorityReason::BLE;
                 }
             }
 
+            if (currentPhaseIdx_ != previousPhaseIdx) {
+                TIP_COUNT(PHASE_SWITCHES, 1);
+            }
+
             // Compute green duration
             uint32_t greenTime = computeGreenDuration(phases_[currentPhaseIdx_]);
             currentSignal_ = model::SignalPhase::GREEN;
@@ -82,31 +156,197 @@ model::Decision TrafficEngine::step() {
         }
     }
 
+    stateSteps_ = remainingTime_ + 1;
+
     decision.selectedPhaseIndex = currentPhaseIdx_;
-    decision.phaseName = phases_[currentPhaseIdx_].name;
+    decision.phaseNameId = phases_[currentPhaseIdx_].nameId;
     decision.signalState = currentSignal_;
 
     return decision;
 }
 
-std::optional<std::size_t> TrafficEngine::findEmergencyPhase() const {
-    // Find the first phase containing an emergency-priority lane
-    for (std::size_t p = 0; p < phases_.size(); ++p) {
-        for (auto laneIdx : phases_[p].laneIndices) {
-            if (lanes_[laneIdx].priorityReason == model::PriorityReason::EMERGENCY) {
-                return p;
-            }
+template <typename Mask>
+void BasicTrafficEngine<Mask>::advance(uint32_t ticks) {
+    if (ticks > remainingTime_) {
+        throw std::out_of_range(
+            "TrafficEngine: cannot advance " + std::to_string(ticks) +
+            " ticks past a state change in " + std::to_string(remainingTime_ + 1));
+    }
+    remainingTime_ -= ticks;
+}
+
+template <typename Mask>
+model::Decision BasicTrafficEngine<Mask>::currentDecision() const {
+    model::Decision decision;
+    decision.selectedPhaseIndex = currentPhaseIdx_;
+    decision.phaseNameId = phases_[currentPhaseIdx_].nameId;
+    decision.signalState = currentSignal_;
+    decision.greenDuration = remainingTime_;
+    return decision;
+}
+
+template <typename Mask>
+void BasicTrafficEngine<Mask>::saveState(EngineState& state) const {
+    state.lanes.resize(lanes_.size());
+    for (std::size_t i = 0; i < lanes_.size(); ++i) {
+        state.lanes[i] = {lanes_[i].queueLength, lanes_[i].waitCounter,
+                          lanes_[i].bleBoost, lanes_[i].priorityReason};
+    }
+    state.signal        = currentSignal_;
+    state.phaseIndex    = currentPhaseIdx_;
+    state.remainingTime = remainingTime_;
+    state.stateSteps    = stateSteps_;
+
+    state.dynamicPhases.resize(phases_.size() - plannedPhaseCount_);
+    for (std::size_t p = plannedPhaseCount_; p < phases_.size(); ++p) {
+        state.dynamicPhases[p - plannedPhaseCount_] = phases_[p].laneIndices;
+    }
+    state.dynamicPhaseUses = dynamicLastUse_;
+
+    state.searchDominant.clear();
+    state.searchResult.clear();
+    if (dynamicSearch_.hasCache()) {
+        model::forEachLane(dynamicSearch_.cachedDominant(), [&](std::size_t i) { state.searchDominant.push_back(i); });
+        model::forEachLane(dynamicSearch_.cachedResult(), [&](std::size_t i) { state.searchResult.push_back(i); });
+    }
+}
+
+template <typename Mask>
+void BasicTrafficEngine<Mask>::restoreState(const EngineState& state) {
+    if (state.lanes.size() != lanes_.size()) {
+        throw std::invalid_argument(
+            "TrafficEngine: state has " + std::to_string(state.lanes.size()) +
+            " lanes for " + std::to_string(lanes_.size()));
+    }
+    for (const auto& indices : state.dynamicPhases) {
+        if (indices.empty() || !std::is_sorted(indices.begin(), indices.end()) ||
+            indices.back() >= lanes_.size()) {
+            throw std::invalid_argument("TrafficEngine: state has an invalid dynamic phase");
+        }
+    }
+    if (state.dynamicPhases.size() > dynamicSlots_ ||
+        state.dynamicPhaseUses.size() != state.dynamicPhases.size()) {
+        throw std::invalid_argument("TrafficEngine: state dynamic phases do not fit the dynamic slots");
+    }
+    if (state.phaseIndex >= plannedPhaseCount_ + state.dynamicPhases.size()) {
+        throw std::invalid_argument("TrafficEngine: state phase index is outside the plan");
+    }
+    for (const auto* indices : {&state.searchDominant, &state.searchResult}) {
+        if (!std::is_sorted(indices->begin(), indices->end()) ||
+            (!indices->empty() && indices->back() >= lanes_.size())) {
+            throw std::invalid_argument("TrafficEngine: state has an invalid dynamic search cache");
+        }
+    }
+
+    // Slots already allocated are overwritten in place and surplus ones are
+    // kept as spares, so restoring never frees slot storage; the lookup is
+    // rebuilt on the next dynamic selection
+    const std::size_t slots = state.dynamicPhases.size();
+    spareSlots_.reserve(dynamicSlots_);
+    while (phases_.size() > plannedPhaseCount_ + slots) {
+        spareSlots_.push_back(std::move(phases_.back()));
+        phases_.pop_back();
+    }
+    for (std::size_t s = 0; s < slots; ++s) {
+        Mask mask{};
+        for (std::size_t i : state.dynamicPhases[s]) model::setLane(mask, i);
+        writeDynamicSlot(s, mask);
+    }
+    dynamicLastUse_ = state.dynamicPhaseUses;
+    dynamicClock_ = slots == 0 ? 0 : *std::max_element(dynamicLastUse_.begin(), dynamicLastUse_.end());
+    lookupReady_ = false;
+
+    // Drop the search's answer for the old lanes and take the saved one, so
+    // the next search reuses exactly what the saving engine's would
+    dynamicSearch_.invalidate();
+    if (!state.searchDominant.empty()) {
+        Mask dominant{}, result{};
+        for (std::size_t i : state.searchDominant) model::setLane(dominant, i);
+        for (std::size_t i : state.searchResult) model::setLane(result, i);
+        dynamicSearch_.restoreCache(dominant, result);
+    }
+
+    for (std::size_t i = 0; i < lanes_.size(); ++i) {
+        lanes_[i].queueLength    = state.lanes[i].queueLength;
+        lanes_[i].waitCounter    = state.lanes[i].waitCounter;
+        lanes_[i].bleBoost       = state.lanes[i].bleBoost;
+        lanes_[i].priorityReason = state.lanes[i].priorityReason;
+    }
+    markAllLanesDirty();
+
+    currentSignal_   = state.signal;
+    currentPhaseIdx_ = static_cast<std::size_t>(state.phaseIndex);
+    remainingTime_   = state.remainingTime;
+    stateSteps_      = state.stateSteps;
+}
+
+template <typename Mask>
+Mask BasicTrafficEngine<Mask>::priorityMask(model::PriorityReason reason) const {
+    Mask mask{};
+    for (std::size_t i = 0; i < lanes_.size(); ++i) {
+        if (lanes_[i].priorityReason == reason) {
+            model::setLane(mask, i);
+        }
+    }
+    return mask;
+}
+
+template <typename Mask>
+std::optional<std::size_t> BasicTrafficEngine<Mask>::findEmergencyPhase() const {
+    const Mask emergency = priorityMask(model::PriorityReason::EMERGENCY);
+    if (!model::anyLane(emergency)) {
+        return std::nullopt;
+    }
+
+    // Find the first planned phase containing an emergency-priority lane
+    for (std::size_t p = 0; p < plannedPhaseCount_; ++p) {
+        if (model::intersects(phases_[p].mask, emergency)) {
+            return p;
         }
     }
     return std::nullopt;
 }
 
-std::size_t TrafficEngine::selectBestPhase() const {
+template <typename Mask>
+void BasicTrafficEngine<Mask>::refreshColumns() {
+    model::forEachLane(columnsDirty_, [&](std::size_t i) {
+        queueScratch_[i] = lanes_[i].queueLength;
+        waitScratch_[i]  = lanes_[i].waitCounter;
+        boostScratch_[i] = lanes_[i].bleBoost;
+        if (incremental_) {
+            scoreIndex_.setLane(i, queueScratch_[i], waitScratch_[i], boostScratch_[i]);
+        }
+    });
+    columnsDirty_ = Mask{};
+}
+
+template <typename Mask>
+void BasicTrafficEngine<Mask>::computeLaneScores() {
+    // Refresh the input columns for lanes changed since the last selection,
+    // then score every lane in one pass
+    refreshColumns();
+    scoreLanes(queueScratch_.data(), waitScratch_.data(), boostScratch_.data(),
+               lanes_.size(), config_.alpha, config_.beta, laneScores_.data());
+}
+
+template <typename Mask>
+std::size_t BasicTrafficEngine<Mask>::selectBestPhase() {
+    if (incremental_) {
+        refreshColumns();
+        return scoreIndex_.best(config_.alpha, config_.beta);
+    }
+
+    computeLaneScores();
+
     std::size_t bestIdx = 0;
     double bestScore = -1.0;
 
-    for (std::size_t p = 0; p < phases_.size(); ++p) {
-        double s = scorePhase(phases_[p]);
+    for (std::size_t p = 0; p < plannedPhaseCount_; ++p) {
+        // Reduce in lane order, matching scorePhase()
+        double s = 0.0;
+        model::forEachLane(phases_[p].mask, [&](std::size_t idx) {
+            s += laneScores_[idx];
+        });
         if (s > bestScore) {
             bestScore = s;
             bestIdx = p;
@@ -116,20 +356,103 @@ std::size_t TrafficEngine::selectBestPhase() const {
     return bestIdx;
 }
 
-double TrafficEngine::scorePhase(const model::Phase& phase) const {
+template <typename Mask>
+std::size_t BasicTrafficEngine<Mask>::selectDynamicPhase() {
+    // The best planned phase seeds the search, so the result is never worse
+    const std::size_t planned = selectBestPhase();
+    if (incremental_) {
+        computeLaneScores();  // The search needs every lane's score
+    }
+
+    const Mask mask = dynamicSearch_.solve(
+        conflicts_, laneScores_, phases_[planned].mask, config_.dynamicSearchNodeBudget);
+
+    if (!lookupReady_) buildPhaseLookup();
+    std::size_t p = phaseLookup_.find(mask);
+    if (p == PhaseMaskTable<Mask>::NOT_FOUND) p = storeDynamicPhase(mask);
+    if (p >= plannedPhaseCount_) dynamicLastUse_[p - plannedPhaseCount_] = ++dynamicClock_;
+    return p;
+}
+
+template <typename Mask>
+std::size_t BasicTrafficEngine<Mask>::storeDynamicPhase(const Mask& mask) {
+    std::size_t slot = dynamicLastUse_.size();
+    if (slot < dynamicSlots_) {
+        dynamicLastUse_.push_back(0);
+    } else {
+        // Every slot is taken: replace the least recently selected one
+        slot = static_cast<std::size_t>(
+            std::min_element(dynamicLastUse_.begin(), dynamicLastUse_.end()) - dynamicLastUse_.begin());
+        phaseLookup_.erase(phases_[plannedPhaseCount_ + slot].mask, plannedPhaseCount_ + slot);
+    }
+    writeDynamicSlot(slot, mask);
+    phaseLookup_.insert(mask, plannedPhaseCount_ + slot);
+    return plannedPhaseCount_ + slot;
+}
+
+template <typename Mask>
+void BasicTrafficEngine<Mask>::writeDynamicSlot(std::size_t slot, const Mask& mask) {
+    if (plannedPhaseCount_ + slot == phases_.size()) {
+        if (!spareSlots_.empty()) {
+            phases_.push_back(std::move(spareSlots_.back()));
+            spareSlots_.pop_back();
+        } else {
+            // Sized for any lane set, so reusing the slot never allocates
+            phases_.emplace_back();
+            phases_.back().laneIndices.reserve(lanes_.size());
+        }
+    }
+    Phase& phase = phases_[plannedPhaseCount_ + slot];
+    phase.nameId = model::DYNAMIC_PHASE_NAME;
+    phase.mask = mask;
+    phase.laneIndices.clear();
+    model::forEachLane(mask, [&](std::size_t idx) { phase.laneIndices.push_back(idx); });
+}
+
+template <typename Mask>
+void BasicTrafficEngine<Mask>::buildPhaseLookup() {
+    // Allocate every slot up front, so later selections and restores never do
+    phases_.reserve(plannedPhaseCount_ + dynamicSlots_);
+    dynamicLastUse_.reserve(dynamicSlots_);
+    spareSlots_.reserve(dynamicSlots_);
+    while (phases_.size() - plannedPhaseCount_ + spareSlots_.size() < dynamicSlots_) {
+        spareSlots_.emplace_back();
+        spareSlots_.back().laneIndices.reserve(lanes_.size());
+    }
+
+    // Planned phases first, so a lane set that is also planned keeps its planned index
+    phaseLookup_.reset(plannedPhaseCount_ + dynamicSlots_);
+    for (std::size_t p = 0; p < phases_.size(); ++p) phaseLookup_.insert(phases_[p].mask, p);
+    lookupReady_ = true;
+}
+
+template <typename Mask>
+std::string BasicTrafficEngine<Mask>::phaseName(std::size_t index) const {
+    const Phase& phase = phases_.at(index);
+    if (index < plannedPhaseCount_) return phase.name;
+    std::string name = "DYN";
+    for (std::size_t k = 0; k < phase.laneIndices.size(); ++k) {
+        name += (k == 0 ? "-" : "+") + std::to_string(phase.laneIndices[k]);
+    }
+    return name;
+}
+
+template <typename Mask>
+double BasicTrafficEngine<Mask>::scorePhase(const Phase& phase) const {
     double total = 0.0;
-    for (auto idx : phase.laneIndices) {
+    model::forEachLane(phase.mask, [&](std::size_t idx) {
         total += lanes_[idx].score(config_.alpha, config_.beta);
-    }
+    });
     return total;
 }
 
-uint32_t TrafficEngine::computeGreenDuration(const model::Phase& phase) const {
+template <typename Mask>
+uint32_t BasicTrafficEngine<Mask>::computeGreenDuration(const Phase& phase) const {
     // Sum queue lengths across phase lanes
     uint32_t totalQueue = 0;
-    for (auto idx : phase.laneIndices) {
+    model::forEachLane(phase.mask, [&](std::size_t idx) {
         totalQueue += lanes_[idx].queueLength;
-    }
+    });
 
     // Proportional green time, bounded
     auto rawGreen = static_cast<uint32_t>(
@@ -138,19 +461,32 @@ uint32_t TrafficEngine::computeGreenDuration(const model::Phase& phase) const {
     return std::clamp(rawGreen, config_.minGreen, config_.maxGreen);
 }
 
-void TrafficEngine::updateFairness(std::size_t selectedPhaseIdx) {
-    // Build a set of lanes in the selected phase for O(1) lookup
-    const auto& selectedLanes = phases_[selectedPhaseIdx].laneIndices;
+template <typename Mask>
+void BasicTrafficEngine<Mask>::updateFairness(std::size_t selectedPhaseIdx) {
+    // Phase membership is a single bit test per lane position
+    const Mask& selected = phases_[selectedPhaseIdx].mask;
 
-    for (auto& lane : lanes_) {
-        bool inPhase = std::find(selectedLanes.begin(), selectedLanes.end(), lane.id)
-                       != selectedLanes.end();
-        if (inPhase) {
+    for (std::size_t i = 0; i < lanes_.size(); ++i) {
+        auto& lane = lanes_[i];
+        if (model::testLane(selected, i)) {
             lane.resetWait();     // W_i(t+1) = 0 if green
         } else {
             lane.incrementWait(); // W_i(t+1) = W_i(t) + 1 otherwise
         }
+        waitScratch_[i] = lane.waitCounter;
+    }
+
+    if (incremental_) {
+        scoreIndex_.nextEpoch();
+        model::forEachLane(selected, [&](std::size_t i) {
+            if (i < lanes_.size()) scoreIndex_.resetWait(i);
+        });
     }
 }
 
-}
\ No newline at end of file
+template class BasicTrafficEngine<model::LaneMask>;
+template class BasicTrafficEngine<model::LaneBitset<128>>;
+template class BasicTrafficEngine<model::LaneBitset<256>>;
+template class BasicTrafficEngine<model::DynamicLaneBitset>;
+
+}
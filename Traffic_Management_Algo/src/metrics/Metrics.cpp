@@ -0,0 +1,101 @@
+#include "metrics/Metrics.hpp"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace tip::metrics {
+
+    namespace {
+        struct Registry {
+            std::mutex mutex;
+            std::deque<std::unique_ptr<detail::ThreadBlock>> blocks;
+        };
+
+        Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+    }
+
+    namespace detail {
+        ThreadBlock& attach() {
+            auto& reg = registry();
+            std::lock_guard lock(reg.mutex);
+            reg.blocks.push_back(std::make_unique<ThreadBlock>());
+            current = reg.blocks.back().get();
+            return *current;
+        }
+    }
+
+    void ScopedTimer::start(detail::ThreadBlock& block, Timer timer) {
+        block.untilSample[static_cast<std::size_t>(timer)] = TIMER_SAMPLE_PERIOD - 1;
+        histogram_ = &block.timers[static_cast<std::size_t>(timer)];
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    void ScopedTimer::stop() {
+        histogram_->record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count()));
+    }
+
+    std::string_view to_string(Counter counter) noexcept {
+        switch (counter) {
+            case Counter::STEPS:                     return "steps";
+            case Counter::PHASE_SWITCHES:            return "phase_switches";
+            case Counter::EMERGENCY_OVERRIDES:       return "emergency_overrides";
+            case Counter::BLE_ACCEPTED:              return "ble_accepted";
+            case Counter::BLE_REJECTED_UNAUTHORIZED: return "ble_rejected_unauthorized";
+            case Counter::BLE_REJECTED_COOLDOWN:     return "ble_rejected_cooldown";
+            case Counter::BLE_REJECTED_RATE_LIMIT:   return "ble_rejected_rate_limit";
+            case Counter::CORRIDOR_TICKS:            return "corridor_ticks";
+            case Counter::COUNT:                     break;
+        }
+        return "unknown";
+    }
+
+    std::string_view to_string(Timer timer) noexcept {
+        switch (timer) {
+            case Timer::STATE_CHANGE:    return "state_change";
+            case Timer::PHASE_SELECTION: return "phase_selection";
+            case Timer::BLE_PROCESS:     return "ble_process";
+            case Timer::CORRIDOR_TICK:   return "corridor_tick";
+            case Timer::COUNT:           break;
+        }
+        return "unknown";
+    }
+
+    uint64_t TimerSnapshot::percentile(double q) const noexcept {
+        if (samples == 0) return 0;
+        const auto rank = static_cast<uint64_t>(q * static_cast<double>(samples - 1));
+        uint64_t seen = 0;
+        for (std::size_t b = 0; b < buckets.size(); ++b) {
+            seen += buckets[b];
+            if (seen > rank) return histogram::lowerBound(b);
+        }
+        return histogram::lowerBound(buckets.size() - 1);
+    }
+
+    Snapshot snapshot() {
+        Snapshot merged;
+        auto& reg = registry();
+        std::lock_guard lock(reg.mutex);
+        for (const auto& block : reg.blocks) {
+            for (std::size_t c = 0; c < COUNTER_COUNT; ++c) {
+                merged.counters[c] += block->counters[c].load(std::memory_order_relaxed);
+            }
+            for (std::size_t t = 0; t < TIMER_COUNT; ++t) {
+                auto& out = merged.timers[t];
+                const auto& histogram = block->timers[t];
+                for (std::size_t b = 0; b < histogram::BUCKETS; ++b) {
+                    const uint64_t n = histogram.bucket(b);
+                    out.buckets[b] += n;
+                    out.samples += n;
+                }
+                out.sumNanos += histogram.sum();
+            }
+        }
+        return merged;
+    }
+
+}
@@ -1,42 +1,108 @@
 
 #include "model/ConflictMatrix.hpp"
+#include "model/PolylineIndex.hpp"
+
+#include <utility>
 
 namespace tip::model {
 
-    ConflictMatrix::ConflictMatrix(const std::vector<Lane>& lanes)
+    template <typename Mask>
+    BasicConflictMatrix<Mask>::BasicConflictMatrix(const std::vector<Lane>& lanes)
+        : BasicConflictMatrix(lanes, nullptr)
+    {}
+
+    template <typename Mask>
+    BasicConflictMatrix<Mask>::BasicConflictMatrix(const std::vector<Lane>& lanes,
+                                                   concurrency::WorkStealingPool& pool)
+        : BasicConflictMatrix(lanes, &pool)
+    {}
+
+    template <typename Mask>
+    BasicConflictMatrix<Mask>::BasicConflictMatrix(const std::vector<Lane>& lanes,
+                                                   concurrency::WorkStealingPool* pool)
         : n_(lanes.size())
-        , mask_(n_, LaneMask{0})
+        , mask_(n_, Mask{})
+        , all_(LaneMaskTraits<Mask>::all(n_))
     {
-        if (n_ > 64) {
+        if (n_ > LaneMaskTraits<Mask>::capacity) {
             throw std::runtime_error(
                 "ConflictMatrix: lane count (" + std::to_string(n_) +
-                ") exceeds maximum of 64");
+                ") exceeds maximum of " + std::to_string(LaneMaskTraits<Mask>::capacity));
         }
 
+        auto run = [pool](std::size_t count, std::size_t grain,
+                          const concurrency::WorkStealingPool::RangeFn& fn) {
+            if (pool && count > grain) {
+                pool->parallelFor(count, grain, fn);
+            } else {
+                fn(0, count);
+            }
+        };
+
+        std::vector<PolylineIndex> index(n_);
+        run(n_, 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) index[i] = PolylineIndex(lanes[i].path);
+        });
+
+        // Broad phase: keep pairs whose bounding boxes overlap
+        std::vector<std::pair<uint32_t, uint32_t>> candidates;
         for (std::size_t i = 0; i < n_; ++i) {
             for (std::size_t j = i + 1; j < n_; ++j) {
-                if (polylinesIntersect(lanes[i].path, lanes[j].path)) {
-                    mask_[i] |= (LaneMask{1} << j);
-                    mask_[j] |= (LaneMask{1} << i);
+                if (index[i].bounds().overlaps(index[j].bounds())) {
+                    candidates.emplace_back(static_cast<uint32_t>(i), static_cast<uint32_t>(j));
                 }
             }
         }
+
+        // Narrow phase: one result byte per pair, merged serially so workers
+        // never write to a shared mask word
+        std::vector<uint8_t> hit(candidates.size(), 0);
+        run(candidates.size(), concurrency::CACHE_LINE, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                const auto [i, j] = candidates[k];
+                hit[k] = index[i].intersects(index[j]) ? 1 : 0;
+            }
+        });
+
+        for (std::size_t k = 0; k < candidates.size(); ++k) {
+            if (!hit[k]) continue;
+            const auto [i, j] = candidates[k];
+            setLane(mask_[i], j);
+            setLane(mask_[j], i);
+        }
     }
 
-    bool ConflictMatrix::isFeasible(LaneMask activeMask) const noexcept {
-        LaneMask remaining = activeMask;
-        while (remaining) {
-            // Extract lowest set bit index
-            int i = __builtin_ctzll(remaining);
-            // Check if this lane conflicts with any other active lane
-            // (exclude self by clearing own bit)
-            LaneMask others = activeMask & ~(LaneMask{1} << i);
-            if (mask_[static_cast<std::size_t>(i)] & others) {
-                return false;
+    template <typename Mask>
+    bool BasicConflictMatrix<Mask>::isFeasible(const Mask& activeMask) const noexcept {
+        if constexpr (std::is_same_v<Mask, LaneMask>) {
+            LaneMask remaining = activeMask;
+            while (remaining) {
+                // Extract lowest set bit index
+                int i = __builtin_ctzll(remaining);
+                // Check if this lane conflicts with any other active lane
+                // (exclude self by clearing own bit)
+                LaneMask others = activeMask & ~(LaneMask{1} << i);
+                if (mask_[static_cast<std::size_t>(i)] & others) {
+                    return false;
+                }
+                remaining &= remaining - 1; // clear lowest set bit
             }
-            remaining &= remaining - 1; // clear lowest set bit
+            return true;
+        } else {
+            // Lanes never conflict with themselves, so no self-bit masking is needed
+            bool feasible = true;
+            forEachLane(activeMask, [&](std::size_t i) {
+                if (feasible && (i >= n_ || intersects(mask_[i], activeMask))) {
+                    feasible = false;
+                }
+            });
+            return feasible;
         }
-        return true;
     }
 
-}
\ No newline at end of file
+    template class BasicConflictMatrix<LaneMask>;
+    template class BasicConflictMatrix<LaneBitset<128>>;
+    template class BasicConflictMatrix<LaneBitset<256>>;
+    template class BasicConflictMatrix<DynamicLaneBitset>;
+
+}
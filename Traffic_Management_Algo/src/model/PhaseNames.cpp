@@ -0,0 +1,52 @@
+
+#include "model/PhaseNames.hpp"
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace tip::model {
+
+    namespace {
+        struct PhaseNameTable {
+            std::mutex                                        mutex;
+            std::deque<std::string>                           names; ///< Stable addresses; indexed by id
+            std::unordered_map<std::string_view, PhaseNameId> ids;   ///< Views into names
+
+            PhaseNameTable() {
+                add("");
+                add("WAITING");
+                add("DYN");
+            }
+
+            PhaseNameId add(std::string_view name) {
+                const auto id = static_cast<PhaseNameId>(names.size());
+                const auto& stored = names.emplace_back(name);
+                ids.emplace(stored, id);
+                return id;
+            }
+        };
+
+        PhaseNameTable& table() {
+            static PhaseNameTable instance;
+            return instance;
+        }
+    }
+
+    PhaseNameId internPhaseName(std::string_view name) {
+        auto& t = table();
+        std::lock_guard lock(t.mutex);
+        if (auto it = t.ids.find(name); it != t.ids.end()) {
+            return it->second;
+        }
+        return t.add(name);
+    }
+
+    std::string_view phaseNameOf(PhaseNameId id) {
+        auto& t = table();
+        std::lock_guard lock(t.mutex);
+        return id < t.names.size() ? std::string_view(t.names[id]) : std::string_view();
+    }
+
+}
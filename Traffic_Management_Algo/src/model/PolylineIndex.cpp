@@ -0,0 +1,85 @@
+
+#include "model/PolylineIndex.hpp"
+
+#include <algorithm>
+
+namespace tip::model {
+
+    namespace {
+        /// Below this many segment pairs a plain double loop is cheaper than sweeping.
+        constexpr std::size_t BRUTE_FORCE_PAIRS = 64;
+    }
+
+    PolylineIndex::PolylineIndex(const std::vector<Point>& path)
+        : path_(&path)
+    {
+        if (path.size() < 2) return;
+
+        segments_.reserve(path.size() - 1);
+        for (std::size_t i = 0; i + 1 < path.size(); ++i) {
+            Segment seg{{}, i};
+            seg.box.expand(path[i]);
+            seg.box.expand(path[i + 1]);
+            bounds_.expand(path[i]);
+            segments_.push_back(seg);
+        }
+        bounds_.expand(path.back());
+
+        std::sort(segments_.begin(), segments_.end(),
+            [](const Segment& a, const Segment& b) { return a.box.minX < b.box.minX; });
+    }
+
+    bool PolylineIndex::segmentsHit(const Segment& a, const PolylineIndex& other,
+                                    const Segment& b) const noexcept {
+        const auto& p = *path_;
+        const auto& q = *other.path_;
+        return a.box.overlaps(b.box)
+            && segmentsIntersect(p[a.start], p[a.start + 1], q[b.start], q[b.start + 1]);
+    }
+
+    bool PolylineIndex::intersects(const PolylineIndex& other) const {
+        // Broad phase
+        if (!bounds_.overlaps(other.bounds_)) return false;
+
+        if (segments_.size() * other.segments_.size() <= BRUTE_FORCE_PAIRS) {
+            return polylinesIntersect(*path_, *other.path_);
+        }
+
+        // Sweep in x across both sorted segment lists. Each side keeps the
+        // segments whose x-extent may still overlap upcoming segments.
+        thread_local std::vector<const Segment*> activeA;
+        thread_local std::vector<const Segment*> activeB;
+        activeA.clear();
+        activeB.clear();
+
+        auto purge = [](std::vector<const Segment*>& active, double x) {
+            std::erase_if(active, [x](const Segment* s) { return s->box.maxX < x; });
+        };
+
+        std::size_t i = 0, j = 0;
+        while (i < segments_.size() || j < other.segments_.size()) {
+            const bool takeA = j == other.segments_.size()
+                || (i < segments_.size() && segments_[i].box.minX <= other.segments_[j].box.minX);
+
+            if (takeA) {
+                const Segment& a = segments_[i++];
+                if (!a.box.overlaps(other.bounds_)) continue;
+                purge(activeB, a.box.minX);
+                for (const Segment* b : activeB) {
+                    if (segmentsHit(a, other, *b)) return true;
+                }
+                activeA.push_back(&a);
+            } else {
+                const Segment& b = other.segments_[j++];
+                if (!b.box.overlaps(bounds_)) continue;
+                purge(activeA, b.box.minX);
+                for (const Segment* a : activeA) {
+                    if (segmentsHit(*a, other, b)) return true;
+                }
+                activeB.push_back(&b);
+            }
+        }
+        return false;
+    }
+
+}
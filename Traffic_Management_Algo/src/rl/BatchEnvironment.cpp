@@ -0,0 +1,199 @@
+#include "rl/BatchEnvironment.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace tip::rl {
+
+    namespace {
+        /// Same bounds as the Simulator: keeps inversion sampling short.
+        constexpr double   MAX_RATE_PER_SECOND = 10.0;
+        constexpr uint32_t MAX_DRAW = 128;
+
+        /// Spreads environment indices over the generator seed space.
+        constexpr uint64_t SEED_STRIDE = 0x9E3779B97F4A7C15ULL;
+    }
+
+    BatchEnvironment::Env::Env(const std::vector<model::Lane>& lanes, const engine::EngineConfig& config,
+                               uint64_t seed)
+        : engine(lanes, config), rng(seed), credit(lanes.size(), 0.0)
+    {
+        deltas.reserve(lanes.size());
+    }
+
+    BatchEnvironment::BatchEnvironment(std::vector<model::Lane> lanes, engine::EngineConfig config,
+                                       std::size_t batch, BatchConfig batchConfig)
+        : config_(batchConfig), initialConfig_(config), laneCount_(lanes.size())
+    {
+        if (batch == 0) throw std::invalid_argument("BatchEnvironment: batch must be positive");
+        if (config_.ticksPerStep == 0 || config_.episodeTicks == 0) {
+            throw std::invalid_argument("BatchEnvironment: ticksPerStep and episodeTicks must be positive");
+        }
+        if (!(config_.arrivalRate >= 0.0 && config_.arrivalRate <= MAX_RATE_PER_SECOND) ||
+            !(config_.saturationFlow >= 0.0 && config_.saturationFlow <= MAX_RATE_PER_SECOND)) {
+            throw std::invalid_argument("BatchEnvironment: rates must be within [0, 10] per second");
+        }
+        emptyChance_ = std::exp(-config_.arrivalRate);
+
+        envs_.reserve(batch);
+        for (std::size_t k = 0; k < batch; ++k) {
+            envs_.push_back(std::make_unique<Env>(lanes, config, config_.seed + SEED_STRIDE * (k + 1)));
+        }
+        envs_.front()->engine.saveState(initialState_);
+
+        observations_.resize(batch * laneCount_ * FEATURE_COUNT);
+        actions_.resize(batch * ACTION_SIZE);
+        rewards_.resize(batch);
+        dones_.resize(batch);
+
+        stepRange_ = [this](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) stepEnv(k);
+        };
+        resetRange_ = [this](std::size_t begin, std::size_t end) {
+            for (std::size_t k = begin; k < end; ++k) {
+                resetEnv(k);
+                rewards_[k] = 0.0F;
+                dones_[k] = 0;
+            }
+        };
+        setThreadCount(config_.threads);
+        reset();
+    }
+
+    BatchEnvironment::~BatchEnvironment() = default;
+
+    void BatchEnvironment::setThreadCount(std::size_t threads) {
+        if (threads == 1) {
+            pool_.reset();
+        } else {
+            pool_ = std::make_unique<concurrency::WorkStealingPool>(threads);
+            if (pool_->threadCount() == 1) pool_.reset();
+        }
+        config_.threads = threadCount();
+    }
+
+    uint64_t BatchEnvironment::episodes() const noexcept {
+        uint64_t total = 0;
+        for (const auto& env : envs_) total += env->episodes;
+        return total;
+    }
+
+    void BatchEnvironment::reset() {
+        forEachEnv(resetRange_);
+    }
+
+    void BatchEnvironment::step() {
+        for (float a : actions_) {
+            if (!std::isfinite(a)) throw std::invalid_argument("BatchEnvironment: actions must be finite");
+        }
+        forEachEnv(stepRange_);
+    }
+
+    void BatchEnvironment::forEachEnv(const concurrency::WorkStealingPool::RangeFn& fn) {
+        if (!pool_) {
+            fn(0, envs_.size());
+            return;
+        }
+        // Each environment runs ticksPerStep engine steps, which dwarfs the
+        // one reward and done write it shares a cache line with neighbours
+        const std::size_t grain = std::max<std::size_t>(1, envs_.size() / (pool_->threadCount() * 8));
+        pool_->parallelFor(envs_.size(), grain, fn);
+    }
+
+    void BatchEnvironment::stepEnv(std::size_t k) {
+        Env& env = *envs_[k];
+        auto& engine = env.engine;
+        const auto& lanes = std::as_const(engine).lanes();
+
+        // Same clamps as RLAgent::apply
+        const float* action = actions_.data() + k * ACTION_SIZE;
+        auto& cfg = engine.config();
+        cfg.alpha = std::max(0.0, cfg.alpha + action[0]);
+        cfg.beta  = std::max(0.0, cfg.beta + action[1]);
+        cfg.greenPerVehicle = std::clamp(cfg.greenPerVehicle + action[2], 1.0, 5.0);
+
+        uint64_t queued = 0;
+        for (uint32_t t = 0; t < config_.ticksPerStep; ++t) {
+            env.deltas.clear();
+            for (std::size_t l = 0; l < laneCount_; ++l) {
+                const uint32_t room = config_.laneCapacity - std::min(lanes[l].queueLength, config_.laneCapacity);
+                const uint32_t joined = std::min(samplePoisson(env.rng), room);
+                if (joined > 0) env.deltas.push_back({static_cast<uint32_t>(l), static_cast<int32_t>(joined)});
+            }
+            engine.applyDeltas(env.deltas);
+
+            const model::Decision d = engine.step();
+            const model::LaneMask green = d.signalState == model::SignalPhase::GREEN
+                                        ? engine.phases()[d.selectedPhaseIndex].mask
+                                        : model::LaneMask{0};
+            env.deltas.clear();
+            for (std::size_t l = 0; l < laneCount_; ++l) {
+                uint32_t departed = 0;
+                if (model::testLane(green, l)) {
+                    env.credit[l] += config_.saturationFlow;
+                    const auto capacity = static_cast<uint32_t>(env.credit[l]);
+                    env.credit[l] -= capacity;
+                    departed = std::min(capacity, lanes[l].queueLength);
+                    if (departed > 0) env.deltas.push_back({static_cast<uint32_t>(l), -static_cast<int32_t>(departed)});
+                } else {
+                    env.credit[l] = 0.0;
+                }
+                queued += lanes[l].queueLength - departed;
+            }
+            engine.applyDeltas(env.deltas);
+        }
+
+        rewards_[k] = -static_cast<float>(static_cast<double>(queued) /
+                                          (static_cast<double>(laneCount_) * config_.ticksPerStep));
+        env.elapsed += config_.ticksPerStep;
+        dones_[k] = env.elapsed >= config_.episodeTicks;
+        if (dones_[k]) {
+            ++env.episodes;
+            resetEnv(k);
+        } else {
+            observe(k);
+        }
+    }
+
+    void BatchEnvironment::resetEnv(std::size_t k) {
+        Env& env = *envs_[k];
+        env.engine.config() = initialConfig_;
+        env.engine.restoreState(initialState_);
+        std::fill(env.credit.begin(), env.credit.end(), 0.0);
+        env.elapsed = 0;
+        observe(k);
+    }
+
+    void BatchEnvironment::observe(std::size_t k) {
+        const auto& engine = envs_[k]->engine;
+        const model::Decision d = engine.currentDecision();
+        const model::LaneMask green = d.signalState == model::SignalPhase::GREEN
+                                    ? engine.phases()[d.selectedPhaseIndex].mask
+                                    : model::LaneMask{0};
+        const auto& lanes = engine.lanes();
+        float* out = observations_.data() + k * laneCount_ * FEATURE_COUNT;
+        for (std::size_t l = 0; l < laneCount_; ++l, out += FEATURE_COUNT) {
+            out[FEATURE_QUEUE_LENGTH] = static_cast<float>(lanes[l].queueLength);
+            out[FEATURE_WAIT_COUNTER] = static_cast<float>(lanes[l].waitCounter);
+            out[FEATURE_BLE_BOOST]    = static_cast<float>(lanes[l].bleBoost);
+            out[FEATURE_GREEN]        = model::testLane(green, l) ? 1.0F : 0.0F;
+        }
+    }
+
+    uint32_t BatchEnvironment::samplePoisson(std::mt19937_64& rng) const {
+        const double u = static_cast<double>(rng() >> 11) * 0x1.0p-53;
+        double p = emptyChance_;
+        double cumulative = p;
+        uint32_t k = 0;
+        // Rounding can leave cumulative just below 1; the bound keeps the loop finite
+        while (u > cumulative && k < MAX_DRAW) {
+            ++k;
+            p *= config_.arrivalRate / k;
+            cumulative += p;
+        }
+        return k;
+    }
+
+}
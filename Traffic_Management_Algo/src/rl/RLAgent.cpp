@@ -12,17 +12,20 @@ namespace tip::rl {
 
 StateObservation RLAgent::observe(const engine::TrafficEngine& engine) const {
     StateObservation state;
+    observe(engine, state);
+    return state;
+}
+
+void RLAgent::observe(const engine::TrafficEngine& engine, StateObservation& state) const {
     const auto& lanes = engine.lanes();
 
-    state.queueLengths.reserve(lanes.size());
-    state.waitCounters.reserve(lanes.size());
+    state.queueLengths.resize(lanes.size());
+    state.waitCounters.resize(lanes.size());
 
-    for (const auto& lane : lanes) {
-        state.queueLengths.push_back(lane.queueLength);
-        state.waitCounters.push_back(lane.waitCounter);
+    for (std::size_t i = 0; i < lanes.size(); ++i) {
+        state.queueLengths[i] = lanes[i].queueLength;
+        state.waitCounters[i] = lanes[i].waitCounter;
     }
-
-    return state;
 }
 
 TuningAction RLAgent::computeAction(const StateObservation& state) const {
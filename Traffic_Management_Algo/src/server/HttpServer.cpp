@@ -0,0 +1,416 @@
+#include "server/HttpServer.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace tip::server {
+
+    struct HttpServer::Connection {
+        int         fd;
+        std::string in;
+        std::size_t consumed = 0;       ///< Bytes of in parsed this iteration
+        std::string out;
+        std::size_t outOffset = 0;
+        std::string errorResponse;      ///< Sent after this iteration's responses, then the connection closes
+        bool        active = false;     ///< Listed in active_ this iteration
+        uint32_t    events = EPOLLIN | EPOLLRDHUP;  ///< Registered epoll interest
+        bool        peerClosed = false;
+        bool        closeAfterFlush = false;
+    };
+
+    namespace {
+        [[nodiscard]] std::string_view reasonPhrase(int status) noexcept {
+            switch (status) {
+                case 200: return "OK";
+                case 204: return "No Content";
+                case 400: return "Bad Request";
+                case 404: return "Not Found";
+                case 405: return "Method Not Allowed";
+                case 411: return "Length Required";
+                case 413: return "Payload Too Large";
+                case 422: return "Unprocessable Entity";
+                case 501: return "Not Implemented";
+                default:  return status < 500 ? "Bad Request" : "Internal Server Error";
+            }
+        }
+
+        [[nodiscard]] bool equalsIgnoreCase(std::string_view a, std::string_view b) noexcept {
+            return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+                return (x | 0x20) == (y | 0x20);
+            });
+        }
+
+        [[nodiscard]] std::string_view trim(std::string_view s) noexcept {
+            while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+            while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+            return s;
+        }
+
+        [[noreturn]] void throwErrno(const char* what) {
+            throw std::runtime_error(std::string("HttpServer: ") + what + ": " + std::strerror(errno));
+        }
+    }
+
+    HttpServer::HttpServer(uint16_t port, BatchHandler handler)
+        : handler_(std::move(handler))
+    {
+        listenFd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd_ < 0) throwErrno("socket");
+
+        try {
+            const int one = 1;
+            ::setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_ANY);
+            addr.sin_port = htons(port);
+            if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) throwErrno("bind");
+            if (::listen(listenFd_, SOMAXCONN) != 0) throwErrno("listen");
+
+            socklen_t length = sizeof(addr);
+            ::getsockname(listenFd_, reinterpret_cast<sockaddr*>(&addr), &length);
+            port_ = ntohs(addr.sin_port);
+
+            epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+            if (epollFd_ < 0) throwErrno("epoll_create1");
+            stopFd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (stopFd_ < 0) throwErrno("eventfd");
+
+            for (int fd : {listenFd_, stopFd_}) {
+                epoll_event ev{};
+                ev.events = EPOLLIN;
+                ev.data.fd = fd;
+                if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) != 0) throwErrno("epoll_ctl");
+            }
+        } catch (...) {
+            for (int fd : {listenFd_, epollFd_, stopFd_}) {
+                if (fd >= 0) ::close(fd);
+            }
+            throw;
+        }
+    }
+
+    HttpServer::~HttpServer() {
+        for (auto& connection : connections_) {
+            if (connection) ::close(connection->fd);
+        }
+        ::close(stopFd_);
+        ::close(epollFd_);
+        ::close(listenFd_);
+    }
+
+    void HttpServer::stop() noexcept {
+        const uint64_t one = 1;
+        [[maybe_unused]] auto written = ::write(stopFd_, &one, sizeof(one));
+    }
+
+    void HttpServer::run() {
+        constexpr int MAX_EVENTS = 256;
+        epoll_event events[MAX_EVENTS];
+
+        while (true) {
+            const int ready = ::epoll_wait(epollFd_, events, MAX_EVENTS, -1);
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                throwErrno("epoll_wait");
+            }
+
+            active_.clear();
+            for (int e = 0; e < ready; ++e) {
+                const int fd = events[e].data.fd;
+                if (fd == stopFd_) {
+                    uint64_t count = 0;
+                    [[maybe_unused]] auto read = ::read(stopFd_, &count, sizeof(count));
+                    return;
+                }
+                if (fd == listenFd_) {
+                    acceptAll();
+                    continue;
+                }
+                auto* connection = static_cast<std::size_t>(fd) < connections_.size()
+                                 ? connections_[static_cast<std::size_t>(fd)].get() : nullptr;
+                if (!connection) continue;
+                if (events[e].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    readAll(*connection);
+                    if (!connection->active) {
+                        connection->active = true;
+                        active_.push_back(connection);
+                    }
+                } else if (events[e].events & EPOLLOUT) {
+                    flush(*connection);
+                }
+            }
+
+            // Parse every complete request that arrived, then answer them as one batch
+            requests_.clear();
+            owners_.clear();
+            keepAlive_.clear();
+            for (Connection* connection : active_) parse(*connection);
+
+            responses_.resize(requests_.size());
+            for (auto& response : responses_) {
+                response.status = 200;
+                response.body.clear();
+                response.extraHeaders = {};
+            }
+            if (!requests_.empty()) {
+                try {
+                    handler_(requests_, responses_);
+                } catch (const std::exception&) {
+                    for (auto& response : responses_) {
+                        response.status = 500;
+                        response.body = R"({"detail":"Internal Server Error"})";
+                        response.extraHeaders = {};
+                    }
+                }
+            }
+            for (std::size_t r = 0; r < requests_.size(); ++r) {
+                Connection& owner = *owners_[r];
+                if (owner.out.size() - owner.outOffset >= MAX_OUTPUT_BYTES) {
+                    // Pipelined faster than responses fit: answer what is queued, then hang up
+                    owner.closeAfterFlush = true;
+                    continue;
+                }
+                appendResponse(owner.out, responses_[r], keepAlive_[r]);
+                if (!keepAlive_[r]) owner.closeAfterFlush = true;
+            }
+
+            for (Connection* connection : active_) {
+                connection->active = false;
+                connection->in.erase(0, connection->consumed);
+                connection->consumed = 0;
+                if (!connection->errorResponse.empty()) {
+                    connection->out += connection->errorResponse;
+                    connection->errorResponse.clear();
+                    connection->closeAfterFlush = true;
+                }
+                flush(*connection);
+            }
+        }
+    }
+
+    void HttpServer::acceptAll() {
+        while (true) {
+            const int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return; // EAGAIN, or a transient error such as EMFILE
+
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            epoll_event ev{};
+            ev.events = EPOLLIN | EPOLLRDHUP;
+            ev.data.fd = fd;
+            if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+                ::close(fd);
+                continue;
+            }
+            if (static_cast<std::size_t>(fd) >= connections_.size()) {
+                connections_.resize(static_cast<std::size_t>(fd) + 1);
+            }
+            connections_[static_cast<std::size_t>(fd)] = std::make_unique<Connection>();
+            connections_[static_cast<std::size_t>(fd)]->fd = fd;
+        }
+    }
+
+    void HttpServer::readAll(Connection& connection) {
+        constexpr std::size_t READ_CHUNK = 16384;
+        while (connection.in.size() <= MAX_REQUEST_BYTES) {
+            const std::size_t used = connection.in.size();
+            connection.in.resize(used + READ_CHUNK);
+            const ssize_t n = ::recv(connection.fd, connection.in.data() + used, READ_CHUNK, 0);
+            connection.in.resize(used + static_cast<std::size_t>(std::max<ssize_t>(n, 0)));
+            if (n > 0) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return;
+            if (n < 0 && errno == EINTR) continue;
+            connection.peerClosed = true; // EOF or reset
+            return;
+        }
+    }
+
+    void HttpServer::parse(Connection& connection) {
+        const std::string_view buffer = connection.in;
+        auto reject = [&](int status, std::string_view detail) {
+            HttpResponse response{status, R"({"detail":")" + std::string(detail) + "\"}", {}};
+            appendResponse(connection.errorResponse, response, false);
+            connection.consumed = buffer.size();
+        };
+
+        while (connection.errorResponse.empty() && !connection.closeAfterFlush) {
+            const std::string_view rest = buffer.substr(connection.consumed);
+            const std::size_t headerEnd = rest.find("\r\n\r\n");
+            if (headerEnd == std::string_view::npos) {
+                if (rest.size() > MAX_REQUEST_BYTES) reject(413, "Request too large");
+                return;
+            }
+
+            // Request line: METHOD SP target SP version
+            std::string_view head = rest.substr(0, headerEnd);
+            const std::size_t lineEnd = std::min(head.find("\r\n"), head.size());
+            const std::string_view line = head.substr(0, lineEnd);
+            const std::size_t sp1 = line.find(' ');
+            const std::size_t sp2 = line.rfind(' ');
+            if (sp1 == std::string_view::npos || sp2 <= sp1) {
+                reject(400, "Malformed request line");
+                return;
+            }
+            const std::string_view method  = line.substr(0, sp1);
+            const std::string_view target  = line.substr(sp1 + 1, sp2 - sp1 - 1);
+            const std::string_view version = line.substr(sp2 + 1);
+            bool keepAlive = version != "HTTP/1.0";
+
+            std::size_t contentLength = 0;
+            for (std::size_t pos = lineEnd; pos < head.size();) {
+                const std::size_t start = pos + 2;
+                const std::size_t end = std::min(head.find("\r\n", start), head.size());
+                const std::string_view header = head.substr(start, end - start);
+                pos = end;
+
+                const std::size_t colon = header.find(':');
+                if (colon == std::string_view::npos) continue;
+                const std::string_view name = header.substr(0, colon);
+                const std::string_view value = trim(header.substr(colon + 1));
+                if (equalsIgnoreCase(name, "Content-Length")) {
+                    auto [next, ec] = std::from_chars(value.data(), value.data() + value.size(), contentLength);
+                    if (ec != std::errc{} || next != value.data() + value.size()) {
+                        reject(400, "Invalid Content-Length");
+                        return;
+                    }
+                } else if (equalsIgnoreCase(name, "Transfer-Encoding")) {
+                    reject(411, "Chunked bodies are not supported");
+                    return;
+                } else if (equalsIgnoreCase(name, "Connection")) {
+                    if (equalsIgnoreCase(value, "close")) keepAlive = false;
+                    else if (equalsIgnoreCase(value, "keep-alive")) keepAlive = true;
+                }
+            }
+
+            if (contentLength > MAX_REQUEST_BYTES) {
+                reject(413, "Request too large");
+                return;
+            }
+            const std::size_t bodyStart = headerEnd + 4;
+            if (rest.size() - bodyStart < contentLength) return; // body still arriving
+
+            const std::size_t question = target.find('?');
+            requests_.push_back({
+                method,
+                target.substr(0, question),
+                question == std::string_view::npos ? std::string_view{} : target.substr(question + 1),
+                rest.substr(bodyStart, contentLength),
+            });
+            owners_.push_back(&connection);
+            keepAlive_.push_back(keepAlive);
+            connection.consumed += bodyStart + contentLength;
+            if (!keepAlive) return;
+        }
+    }
+
+    void HttpServer::flush(Connection& connection) {
+        while (connection.outOffset < connection.out.size()) {
+            const ssize_t n = ::send(connection.fd, connection.out.data() + connection.outOffset,
+                                     connection.out.size() - connection.outOffset, MSG_NOSIGNAL);
+            if (n > 0) {
+                connection.outOffset += static_cast<std::size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                watch(connection);
+                return;
+            }
+            close(connection);
+            return;
+        }
+
+        connection.out.clear();
+        connection.outOffset = 0;
+        if (connection.closeAfterFlush || connection.peerClosed) {
+            close(connection);
+            return;
+        }
+        watch(connection);
+    }
+
+    void HttpServer::watch(Connection& connection) {
+        // Level-triggered: a closed peer would report readable forever, and
+        // reading behind unsent output would let a client queue without bound
+        const bool pending = connection.outOffset < connection.out.size();
+        uint32_t events = 0;
+        if (pending) events |= EPOLLOUT;
+        else if (!connection.peerClosed) events |= EPOLLIN | EPOLLRDHUP;
+        if (events == connection.events) return;
+
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = connection.fd;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection.fd, &ev);
+        connection.events = events;
+    }
+
+    void HttpServer::close(Connection& connection) {
+        const int fd = connection.fd;
+        ::epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+        ::close(fd);
+        connections_[static_cast<std::size_t>(fd)].reset();
+    }
+
+    void HttpServer::appendResponse(std::string& out, const HttpResponse& response, bool keepAlive) {
+        char length[24];
+        auto [end, ec] = std::to_chars(length, length + sizeof(length), response.body.size());
+        char status[8];
+        auto [statusEnd, statusEc] = std::to_chars(status, status + sizeof(status), response.status);
+
+        out += "HTTP/1.1 ";
+        out.append(status, statusEnd);
+        out += ' ';
+        out += reasonPhrase(response.status);
+        out += "\r\nContent-Type: application/json\r\nAccess-Control-Allow-Origin: *\r\nContent-Length: ";
+        out.append(length, end);
+        out += "\r\n";
+        out += response.extraHeaders;
+        if (!keepAlive) out += "Connection: close\r\n";
+        out += "\r\n";
+        out += response.body;
+    }
+
+    std::string HttpServer::queryParam(std::string_view query, std::string_view name, std::string_view fallback) {
+        while (!query.empty()) {
+            const std::size_t amp = query.find('&');
+            const std::string_view pair = query.substr(0, amp);
+            query = amp == std::string_view::npos ? std::string_view{} : query.substr(amp + 1);
+
+            const std::size_t eq = pair.find('=');
+            if (pair.substr(0, eq) != name) continue;
+            const std::string_view raw = eq == std::string_view::npos ? std::string_view{} : pair.substr(eq + 1);
+
+            std::string value;
+            for (std::size_t i = 0; i < raw.size(); ++i) {
+                unsigned int byte = 0;
+                if (raw[i] == '+') {
+                    value.push_back(' ');
+                } else if (raw[i] == '%' && i + 2 < raw.size() &&
+                           std::from_chars(raw.data() + i + 1, raw.data() + i + 3, byte, 16).ptr == raw.data() + i + 3) {
+                    value.push_back(static_cast<char>(byte));
+                    i += 2;
+                } else {
+                    value.push_back(raw[i]);
+                }
+            }
+            return value;
+        }
+        return std::string(fallback);
+    }
+
+}
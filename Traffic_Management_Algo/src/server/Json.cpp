@@ -0,0 +1,249 @@
+#include "server/Json.hpp"
+
+#include <cctype>
+#include <charconv>
+#include <limits>
+#include <stdexcept>
+
+namespace tip::server::json {
+
+    namespace {
+        /// Recursive-descent reader over one body.
+        class Reader {
+        public:
+            explicit Reader(std::string_view text) : p_(text.data()), end_(text.data() + text.size()) {}
+
+            void skipSpace() noexcept {
+                while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) ++p_;
+            }
+
+            /// Consume c (after whitespace) if present.
+            bool accept(char c) noexcept {
+                skipSpace();
+                if (p_ != end_ && *p_ == c) {
+                    ++p_;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(char c) {
+                if (!accept(c)) fail(std::string("expected '") + c + "'");
+            }
+
+            [[nodiscard]] bool atEnd() noexcept {
+                skipSpace();
+                return p_ == end_;
+            }
+
+            void readString(std::string& out) {
+                expect('"');
+                out.clear();
+                while (true) {
+                    if (p_ == end_) fail("unterminated string");
+                    const char c = *p_++;
+                    if (c == '"') return;
+                    if (static_cast<unsigned char>(c) < 0x20) fail("control character in string");
+                    if (c != '\\') {
+                        out.push_back(c);
+                        continue;
+                    }
+                    if (p_ == end_) fail("unterminated string");
+                    switch (*p_++) {
+                        case '"':  out.push_back('"');  break;
+                        case '\\': out.push_back('\\'); break;
+                        case '/':  out.push_back('/');  break;
+                        case 'b':  out.push_back('\b'); break;
+                        case 'f':  out.push_back('\f'); break;
+                        case 'n':  out.push_back('\n'); break;
+                        case 'r':  out.push_back('\r'); break;
+                        case 't':  out.push_back('\t'); break;
+                        case 'u':  appendUtf8(out, readCodePoint()); break;
+                        default:   fail("invalid escape");
+                    }
+                }
+            }
+
+            /// Non-negative integer; also accepts a number with a zero fraction (e.g. 3.0).
+            uint32_t readCount() {
+                skipSpace();
+                const char* begin = p_;
+                uint64_t value = 0;
+                auto [next, ec] = std::from_chars(begin, end_, value);
+                if (ec != std::errc{} || value > std::numeric_limits<uint32_t>::max()) {
+                    fail("expected a non-negative integer");
+                }
+                p_ = next;
+                if (p_ != end_ && *p_ == '.') {
+                    ++p_;
+                    if (p_ == end_ || *p_ < '0' || *p_ > '9') fail("expected a non-negative integer");
+                    while (p_ != end_ && *p_ == '0') ++p_;
+                    if (p_ != end_ && *p_ >= '1' && *p_ <= '9') fail("expected a non-negative integer");
+                }
+                return static_cast<uint32_t>(value);
+            }
+
+            /// Skip any JSON value.
+            void skipValue(int depth = 0) {
+                if (depth > 64) fail("nesting too deep");
+                skipSpace();
+                if (p_ == end_) fail("unexpected end of input");
+                switch (*p_) {
+                    case '"': {
+                        std::string ignored;
+                        readString(ignored);
+                        return;
+                    }
+                    case '{': {
+                        ++p_;
+                        if (accept('}')) return;
+                        do {
+                            std::string key;
+                            readString(key);
+                            expect(':');
+                            skipValue(depth + 1);
+                        } while (accept(','));
+                        expect('}');
+                        return;
+                    }
+                    case '[': {
+                        ++p_;
+                        if (accept(']')) return;
+                        do {
+                            skipValue(depth + 1);
+                        } while (accept(','));
+                        expect(']');
+                        return;
+                    }
+                    default: {
+                        const char* begin = p_;
+                        while (p_ != end_ && (std::isalnum(static_cast<unsigned char>(*p_)) ||
+                                              *p_ == '-' || *p_ == '+' || *p_ == '.')) {
+                            ++p_;
+                        }
+                        const std::string_view literal(begin, static_cast<std::size_t>(p_ - begin));
+                        if (literal.empty()) fail("unexpected character");
+                        if (literal == "true" || literal == "false" || literal == "null") return;
+                        double ignored = 0.0;
+                        auto [next, ec] = std::from_chars(literal.data(), literal.data() + literal.size(), ignored);
+                        if (ec != std::errc{} || next != literal.data() + literal.size()) fail("invalid literal");
+                        return;
+                    }
+                }
+            }
+
+            [[noreturn]] void fail(const std::string& message) const {
+                throw std::invalid_argument(message);
+            }
+
+        private:
+            const char* p_;
+            const char* end_;
+
+            uint32_t readHex4() {
+                if (end_ - p_ < 4) fail("invalid \\u escape");
+                uint32_t value = 0;
+                auto [next, ec] = std::from_chars(p_, p_ + 4, value, 16);
+                if (ec != std::errc{} || next != p_ + 4) fail("invalid \\u escape");
+                p_ += 4;
+                return value;
+            }
+
+            uint32_t readCodePoint() {
+                uint32_t cp = readHex4();
+                if (cp >= 0xD800 && cp < 0xDC00) {
+                    if (end_ - p_ < 2 || p_[0] != '\\' || p_[1] != 'u') fail("unpaired surrogate");
+                    p_ += 2;
+                    const uint32_t low = readHex4();
+                    if (low < 0xDC00 || low >= 0xE000) fail("unpaired surrogate");
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                } else if (cp >= 0xDC00 && cp < 0xE000) {
+                    fail("unpaired surrogate");
+                }
+                return cp;
+            }
+
+            static void appendUtf8(std::string& out, uint32_t cp) {
+                if (cp < 0x80) {
+                    out.push_back(static_cast<char>(cp));
+                } else if (cp < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                } else if (cp < 0x10000) {
+                    out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+                }
+            }
+        };
+    }
+
+    void parseLaneInputs(std::string_view body, std::vector<LaneInput>& out) {
+        out.clear();
+        Reader reader(body);
+        std::string key;
+
+        reader.expect('[');
+        if (!reader.accept(']')) {
+            do {
+                LaneInput lane;
+                bool hasId = false, hasNormal = false, hasEmergency = false;
+                reader.expect('{');
+                if (!reader.accept('}')) {
+                    do {
+                        reader.readString(key);
+                        reader.expect(':');
+                        if (key == "lane_id") {
+                            reader.readString(lane.lane_id);
+                            hasId = true;
+                        } else if (key == "normal") {
+                            lane.normal = reader.readCount();
+                            hasNormal = true;
+                        } else if (key == "emergency") {
+                            lane.emergency = reader.readCount();
+                            hasEmergency = true;
+                        } else {
+                            reader.skipValue();
+                        }
+                    } while (reader.accept(','));
+                    reader.expect('}');
+                }
+                if (!hasId || !hasNormal || !hasEmergency) {
+                    reader.fail("each lane needs lane_id, normal and emergency");
+                }
+                out.push_back(std::move(lane));
+            } while (reader.accept(','));
+            reader.expect(']');
+        }
+        if (!reader.atEnd()) reader.fail("trailing characters after body");
+    }
+
+    void appendString(std::string& out, std::string_view value) {
+        static constexpr char HEX[] = "0123456789abcdef";
+        out.push_back('"');
+        for (const char c : value) {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n";  break;
+                case '\r': out += "\\r";  break;
+                case '\t': out += "\\t";  break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        out += "\\u00";
+                        out.push_back(HEX[(c >> 4) & 0xF]);
+                        out.push_back(HEX[c & 0xF]);
+                    } else {
+                        out.push_back(c);
+                    }
+            }
+        }
+        out.push_back('"');
+    }
+
+}
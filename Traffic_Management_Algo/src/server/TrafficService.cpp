@@ -0,0 +1,232 @@
+#include "server/TrafficService.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+namespace tip::server {
+
+    namespace {
+        constexpr const char* RED_STATE    = "[1,0,0]";
+        constexpr const char* YELLOW_STATE = "[0,1,0]";
+        constexpr const char* GREEN_STATE  = "[0,0,1]";
+
+        constexpr std::string_view PREFLIGHT_HEADERS =
+            "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\nAccess-Control-Allow-Headers: *\r\n";
+
+        void setError(HttpResponse& response, int status, std::string_view detail) {
+            response.status = status;
+            response.body = R"({"detail":)";
+            json::appendString(response.body, detail);
+            response.body += '}';
+        }
+
+        void appendNumber(std::string& out, uint64_t value) {
+            char digits[24];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+            out.append(digits, end);
+        }
+    }
+
+    TrafficService::TrafficService() {
+        config_.minGreen = 3;
+        config_.maxGreen = 12;
+        config_.yellowTime = 2;
+        config_.allRedTime = 0;
+        config_.greenPerVehicle = 1.0 / 2.5;
+    }
+
+    void TrafficService::handle(std::span<const HttpRequest> requests, std::span<HttpResponse> responses) {
+        pendingCount_ = 0;
+        statusRequests_.clear();
+
+        for (std::size_t r = 0; r < requests.size(); ++r) {
+            const auto& request = requests[r];
+            auto& response = responses[r];
+
+            if (request.method == "OPTIONS") {
+                response.status = 204;
+                response.extraHeaders = PREFLIGHT_HEADERS;
+            } else if (request.path == "/update") {
+                if (request.method != "POST") {
+                    setError(response, 405, "Method Not Allowed");
+                    continue;
+                }
+                if (pendingCount_ == pending_.size()) pending_.emplace_back();
+                auto& update = pending_[pendingCount_];
+                try {
+                    json::parseLaneInputs(request.body, update.lanes);
+                } catch (const std::invalid_argument& e) {
+                    setError(response, 422, e.what());
+                    continue;
+                }
+                update.intersectionId = HttpServer::queryParam(request.query, "intersection", "default");
+                update.request = r;
+                ++pendingCount_;
+            } else if (request.path == "/status") {
+                if (request.method != "GET") {
+                    setError(response, 405, "Method Not Allowed");
+                    continue;
+                }
+                statusRequests_.push_back(r);
+            } else {
+                setError(response, 404, "Not Found");
+            }
+        }
+
+        // Group updates by intersection, keeping arrival order within each
+        order_.resize(pendingCount_);
+        for (std::size_t i = 0; i < pendingCount_; ++i) order_[i] = i;
+        std::stable_sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) {
+            return pending_[a].intersectionId < pending_[b].intersectionId;
+        });
+
+        for (std::size_t begin = 0; begin < order_.size();) {
+            const std::string& id = pending_[order_[begin]].intersectionId;
+            std::size_t end = begin;
+            while (end < order_.size() && pending_[order_[end]].intersectionId == id) ++end;
+
+            auto& intersection = intersections_[id];
+            // Split the run wherever the lane set changes; each change rebuilds the engine
+            for (std::size_t groupBegin = begin; groupBegin < end;) {
+                const auto& first = pending_[order_[groupBegin]];
+                if (!intersection.engine || !sameLanes(intersection, first.lanes)) {
+                    try {
+                        rebuild(intersection, first.lanes);
+                    } catch (const std::exception& e) {
+                        setError(responses[first.request], 422, e.what());
+                        ++groupBegin;
+                        continue;
+                    }
+                }
+                std::size_t groupEnd = groupBegin + 1;
+                while (groupEnd < end && sameLanes(intersection, pending_[order_[groupEnd]].lanes)) ++groupEnd;
+
+                step(intersection, std::span(order_).subspan(groupBegin, groupEnd - groupBegin), responses);
+                groupBegin = groupEnd;
+            }
+            if (!intersection.engine) intersections_.erase(id);
+            begin = end;
+        }
+
+        for (std::size_t r : statusRequests_) {
+            writeStatus(HttpServer::queryParam(requests[r].query, "intersection", "default"), responses[r].body);
+        }
+    }
+
+    bool TrafficService::sameLanes(const Intersection& intersection, std::span<const LaneInput> inputs) {
+        if (inputs.size() != intersection.laneIds.size()) return false;
+        // Equal sizes and every id known means the same set unless an id repeats,
+        // which the seen mask catches
+        uint64_t seen = 0;
+        for (const auto& input : inputs) {
+            auto it = intersection.laneIndex.find(input.lane_id);
+            if (it == intersection.laneIndex.end()) return false;
+            const uint64_t bit = uint64_t{1} << it->second;
+            if (seen & bit) return false;
+            seen |= bit;
+        }
+        return true;
+    }
+
+    void TrafficService::rebuild(Intersection& intersection, std::span<const LaneInput> inputs) const {
+        if (inputs.empty()) {
+            throw std::invalid_argument("update needs at least one lane");
+        }
+        if (inputs.size() > model::MAX_MASK_LANES) {
+            throw std::invalid_argument("update has more than 64 lanes");
+        }
+
+        Intersection next;
+        const auto approaches = static_cast<uint16_t>(inputs.size());
+        std::vector<model::Lane> lanes;
+        lanes.reserve(inputs.size());
+        for (const auto& input : inputs) {
+            if (!next.laneIndex.emplace(input.lane_id, next.laneIds.size()).second) {
+                throw std::invalid_argument("duplicate lane_id " + input.lane_id);
+            }
+            const auto index = static_cast<uint16_t>(next.laneIds.size());
+            lanes.push_back({index, model::Direction(index, approaches), model::MovementType::THROUGH, {}});
+            next.laneIds.push_back(input.lane_id);
+        }
+        next.emergency.assign(inputs.size(), 0);
+        next.engine = std::make_unique<engine::TrafficEngine>(std::move(lanes), config_);
+        intersection = std::move(next);
+    }
+
+    void TrafficService::step(Intersection& intersection, std::span<const std::size_t> group,
+                              std::span<HttpResponse> responses) {
+        // Published inputs are applied at the start of step() and mark only
+        // their own lanes dirty, so incremental scoring keeps its work small
+        auto& engine = *intersection.engine;
+        const auto& lanes = std::as_const(engine).lanes();
+        for (std::size_t p : group) {
+            for (const auto& input : pending_[p].lanes) {
+                const std::size_t l = intersection.laneIndex.find(input.lane_id)->second;
+                engine.laneInputs().publish(l, {input.normal, lanes[l].bleBoost,
+                                                input.emergency > 0 ? model::PriorityReason::EMERGENCY
+                                                                    : model::PriorityReason::NONE});
+                intersection.emergency[l] = input.emergency;
+            }
+        }
+        intersection.decision = engine.step();
+        intersection.stepped = true;
+        ++steps_;
+
+        auto& body = responses[pending_[group.front()].request].body;
+        body = R"({"status":"success","output":{)";
+        for (std::size_t l = 0; l < lanes.size(); ++l) {
+            if (l > 0) body += ',';
+            const char* state = laneState(intersection, l);
+            json::appendString(body, intersection.laneIds[l]);
+            body += R"(:{"state":)";
+            body += state;
+            body += R"(,"wait":)";
+            appendNumber(body, lanes[l].waitCounter);
+            if (state == GREEN_STATE) {
+                body += R"(,"green_time":)";
+                appendNumber(body, intersection.decision.greenDuration);
+            }
+            body += '}';
+        }
+        body += "}}";
+
+        for (std::size_t p : group.subspan(1)) {
+            responses[pending_[p].request].body = body;
+        }
+    }
+
+    void TrafficService::writeStatus(const std::string& id, std::string& body) const {
+        body = "{";
+        auto it = intersections_.find(id);
+        if (it != intersections_.end()) {
+            const auto& intersection = it->second;
+            const auto& lanes = std::as_const(*intersection.engine).lanes();
+            for (std::size_t l = 0; l < lanes.size(); ++l) {
+                if (l > 0) body += ',';
+                json::appendString(body, intersection.laneIds[l]);
+                body += R"(:{"normal":)";
+                appendNumber(body, lanes[l].queueLength);
+                body += R"(,"emergency":)";
+                appendNumber(body, intersection.emergency[l]);
+                body += R"(,"wait":)";
+                appendNumber(body, lanes[l].waitCounter);
+                body += R"(,"state":)";
+                body += laneState(intersection, l);
+                body += '}';
+            }
+        }
+        body += '}';
+    }
+
+    const char* TrafficService::laneState(const Intersection& intersection, std::size_t lane) {
+        const auto& decision = intersection.decision;
+        const bool served = intersection.stepped &&
+            model::testLane(intersection.engine->phases()[decision.selectedPhaseIndex].mask, lane);
+        if (served && decision.signalState == model::SignalPhase::GREEN)  return GREEN_STATE;
+        if (served && decision.signalState == model::SignalPhase::YELLOW) return YELLOW_STATE;
+        return RED_STATE;
+    }
+
+}
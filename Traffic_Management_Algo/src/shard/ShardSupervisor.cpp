@@ -0,0 +1,474 @@
+#include "shard/ShardSupervisor.hpp"
+#include "engine/TrafficEngine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+namespace tip::shard {
+
+    namespace {
+        constexpr uint64_t NO_CRASH = std::numeric_limits<uint64_t>::max();
+        constexpr uint32_t DEFAULT_INTERVAL = 60;  ///< Without cross-shard links
+
+        constexpr std::size_t alignUp(std::size_t n) noexcept {
+            return (n + concurrency::CACHE_LINE - 1) / concurrency::CACHE_LINE * concurrency::CACHE_LINE;
+        }
+
+        /// Appends plain values to a checkpoint image. Checkpoints are only
+        /// read back by forks of the same binary, so values are copied as is.
+        class ByteWriter {
+        public:
+            explicit ByteWriter(std::vector<uint8_t>& out) : out_(out) { out_.clear(); }
+
+            template <typename T>
+            void put(const T& value) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                append(&value, sizeof(T));
+            }
+
+            template <typename T>
+            void putVector(const std::vector<T>& values) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                put<uint64_t>(values.size());
+                append(values.data(), values.size() * sizeof(T));
+            }
+
+        private:
+            std::vector<uint8_t>& out_;
+
+            void append(const void* data, std::size_t n) {
+                if (n == 0) return;
+                const std::size_t at = out_.size();
+                out_.resize(at + n);
+                std::memcpy(out_.data() + at, data, n);
+            }
+        };
+
+        class ByteReader {
+        public:
+            ByteReader(const uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+            template <typename T>
+            T get() {
+                static_assert(std::is_trivially_copyable_v<T>);
+                T value;
+                std::memcpy(&value, take(sizeof(T)), sizeof(T));
+                return value;
+            }
+
+            template <typename T>
+            void getVector(std::vector<T>& values) {
+                const auto count = get<uint64_t>();
+                if (count > (size_ - pos_) / sizeof(T)) throw std::runtime_error("ShardSupervisor: corrupt checkpoint");
+                values.resize(count);
+                std::memcpy(values.data(), take(count * sizeof(T)), count * sizeof(T));
+            }
+
+        private:
+            const uint8_t* data_;
+            std::size_t    size_;
+            std::size_t    pos_ = 0;
+
+            const uint8_t* take(std::size_t n) {
+                if (n > size_ - pos_) throw std::runtime_error("ShardSupervisor: corrupt checkpoint");
+                const uint8_t* p = data_ + pos_;
+                pos_ += n;
+                return p;
+            }
+        };
+
+        void putState(ByteWriter& out, const coordination::NetworkState& state) {
+            out.put<uint64_t>(state.engines.size());
+            for (const auto& engine : state.engines) {
+                out.putVector(engine.lanes);
+                out.put(engine.signal);
+                out.put(engine.phaseIndex);
+                out.put(engine.remainingTime);
+                out.put(engine.stateSteps);
+                out.put<uint64_t>(engine.dynamicPhases.size());
+                for (const auto& phase : engine.dynamicPhases) out.putVector(phase);
+                out.putVector(engine.dynamicPhaseUses);
+                out.putVector(engine.searchDominant);
+                out.putVector(engine.searchResult);
+            }
+            out.putVector(state.inTransit);
+            out.putVector(state.credit);
+            out.put(state.stats);
+        }
+
+        void getState(ByteReader& in, coordination::NetworkState& state) {
+            state.engines.resize(in.get<uint64_t>());
+            for (auto& engine : state.engines) {
+                in.getVector(engine.lanes);
+                engine.signal        = in.get<model::SignalPhase>();
+                engine.phaseIndex    = in.get<uint64_t>();
+                engine.remainingTime = in.get<uint32_t>();
+                engine.stateSteps    = in.get<uint32_t>();
+                engine.dynamicPhases.resize(in.get<uint64_t>());
+                for (auto& phase : engine.dynamicPhases) in.getVector(phase);
+                in.getVector(engine.dynamicPhaseUses);
+                in.getVector(engine.searchDominant);
+                in.getVector(engine.searchResult);
+            }
+            in.getVector(state.inTransit);
+            in.getVector(state.credit);
+            state.stats = in.get<coordination::NetworkStats>();
+        }
+    }
+
+    /// Per-shard block in shared memory.
+    struct alignas(concurrency::CACHE_LINE) ShardSupervisor::Control {
+        alignas(concurrency::CACHE_LINE) std::atomic<uint64_t> done{0};   ///< Ticks finished
+        alignas(concurrency::CACHE_LINE) std::atomic<uint64_t> commit{0}; ///< Checkpoints committed; latest in buffer commit % 2
+        std::atomic<uint32_t> finished{0};
+        ShardResult           result;  ///< Valid once finished is set
+    };
+
+    static_assert(std::atomic<uint32_t>::is_always_lock_free);
+    static_assert(std::is_trivially_copyable_v<ShardResult>);
+
+    uint64_t digestDecision(uint64_t digest, uint64_t tick, std::size_t node,
+                            const model::Decision& decision) noexcept
+    {
+        if (digest == 0) digest = 1469598103934665603ULL;
+        auto mix = [&](uint64_t v) { digest = (digest ^ v) * 1099511628211ULL; };
+        mix(tick);
+        mix(node);
+        mix(decision.selectedPhaseIndex);
+        mix(static_cast<uint64_t>(decision.signalState));
+        mix(decision.greenDuration);
+        return digest;
+    }
+
+    ShardSupervisor::ShardSupervisor(NetworkSpec spec, ShardConfig config)
+        : spec_(std::move(spec)), config_(config)
+    {
+        if (spec_.nodes.empty()) {
+            throw std::invalid_argument("ShardSupervisor: network has no nodes");
+        }
+        if (config_.ringCapacity == 0 || config_.checkpointBytes < 64) {
+            throw std::invalid_argument("ShardSupervisor: ring and checkpoint sizes must be positive");
+        }
+
+        for (const auto& node : spec_.nodes) shardCount_ = std::max<std::size_t>(shardCount_, node.shard + std::size_t{1});
+        shardNodes_.resize(shardCount_);
+        std::vector<std::size_t> localOf(spec_.nodes.size());
+        for (std::size_t i = 0; i < spec_.nodes.size(); ++i) {
+            auto& nodes = shardNodes_[spec_.nodes[i].shard];
+            localOf[i] = nodes.size();
+            nodes.push_back(i);
+        }
+        if (std::any_of(shardNodes_.begin(), shardNodes_.end(), [](const auto& n) { return n.empty(); })) {
+            throw std::invalid_argument("ShardSupervisor: shard indices must be contiguous from 0");
+        }
+
+        uint32_t shortest = std::numeric_limits<uint32_t>::max();
+        for (const auto& link : spec_.links) {
+            if (link.fromNode >= spec_.nodes.size() || link.toNode >= spec_.nodes.size() ||
+                link.fromLane >= spec_.nodes[link.fromNode].lanes.size() ||
+                link.toLane >= spec_.nodes[link.toNode].lanes.size() || link.travelSeconds == 0) {
+                throw std::invalid_argument("ShardSupervisor: link endpoints must exist and travel time be positive");
+            }
+            const uint32_t from = spec_.nodes[link.fromNode].shard;
+            const uint32_t to   = spec_.nodes[link.toNode].shard;
+            if (from != to) {
+                crossLinks_.push_back({from, to, localOf[link.fromNode], link.fromLane,
+                                       localOf[link.toNode], link.toLane, link.travelSeconds});
+                shortest = std::min(shortest, link.travelSeconds);
+            }
+        }
+        if (crossLinks_.empty()) shortest = DEFAULT_INTERVAL;
+        interval_ = config_.checkpointInterval == 0 ? shortest : config_.checkpointInterval;
+        if (interval_ > shortest) {
+            throw std::invalid_argument("ShardSupervisor: checkpointInterval exceeds the shortest cross-shard link");
+        }
+        crashTick_.assign(shardCount_, NO_CRASH);
+
+        checkpointOffset_ = alignUp(shardCount_ * sizeof(Control));
+        const std::size_t checkpointStride = alignUp(config_.checkpointBytes);
+        ringOffset_  = checkpointOffset_ + shardCount_ * 2 * checkpointStride;
+        mappedBytes_ = ringOffset_ + shardCount_ * shardCount_ * alignUp(ShmRing::bytesFor(config_.ringCapacity));
+
+        // Shared and anonymous: inherited by every forked shard; pages are
+        // only backed once touched
+        memory_ = ::mmap(nullptr, mappedBytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (memory_ == MAP_FAILED) {
+            memory_ = nullptr;
+            throw std::runtime_error(std::string("ShardSupervisor: mmap failed: ") + std::strerror(errno));
+        }
+        for (std::size_t s = 0; s < shardCount_; ++s) new (&control(s)) Control;
+        for (std::size_t from = 0; from < shardCount_; ++from) {
+            for (std::size_t to = 0; to < shardCount_; ++to) {
+                auto* base = static_cast<uint8_t*>(memory_) + ringOffset_ +
+                             (from * shardCount_ + to) * alignUp(ShmRing::bytesFor(config_.ringCapacity));
+                ShmRing::create(base, config_.ringCapacity);
+            }
+        }
+    }
+
+    ShardSupervisor::~ShardSupervisor() {
+        if (memory_) ::munmap(memory_, mappedBytes_);
+    }
+
+    ShardSupervisor::Control& ShardSupervisor::control(std::size_t shard) const noexcept {
+        return static_cast<Control*>(memory_)[shard];
+    }
+
+    uint8_t* ShardSupervisor::checkpointBuffer(std::size_t shard, uint64_t which) const noexcept {
+        return static_cast<uint8_t*>(memory_) + checkpointOffset_ +
+               (shard * 2 + which % 2) * alignUp(config_.checkpointBytes);
+    }
+
+    ShmRing ShardSupervisor::ring(std::size_t from, std::size_t to) const noexcept {
+        return ShmRing::attach(static_cast<uint8_t*>(memory_) + ringOffset_ +
+                               (from * shardCount_ + to) * alignUp(ShmRing::bytesFor(config_.ringCapacity)));
+    }
+
+    void ShardSupervisor::injectCrash(std::size_t shard, uint64_t tick) {
+        crashTick_.at(shard) = tick;
+    }
+
+    ShardRunResult ShardSupervisor::run(uint64_t ticks) {
+        if (ran_) throw std::runtime_error("ShardSupervisor: run() can only be called once");
+        ran_ = true;
+
+        std::vector<pid_t> pids(shardCount_, -1);
+        auto killAll = [&] {
+            for (pid_t& pid : pids) {
+                if (pid > 0) {
+                    ::kill(pid, SIGKILL);
+                    ::waitpid(pid, nullptr, 0);
+                    pid = -1;
+                }
+            }
+        };
+        auto spawn = [&](std::size_t shard, bool first) {
+            const pid_t pid = ::fork();
+            if (pid < 0) {
+                const int err = errno;
+                killAll();
+                throw std::runtime_error(std::string("ShardSupervisor: fork failed: ") + std::strerror(err));
+            }
+            if (pid == 0) runShard(shard, ticks, first);
+            pids[shard] = pid;
+        };
+
+        for (std::size_t s = 0; s < shardCount_; ++s) spawn(s, true);
+
+        ShardRunResult result;
+        std::size_t running = shardCount_;
+        while (running > 0) {
+            int status = 0;
+            const pid_t pid = ::waitpid(-1, &status, 0);
+            if (pid < 0) {
+                if (errno == EINTR) continue;
+                const int err = errno;
+                killAll();
+                throw std::runtime_error(std::string("ShardSupervisor: waitpid failed: ") + std::strerror(err));
+            }
+            const auto it = std::find(pids.begin(), pids.end(), pid);
+            if (it == pids.end()) continue;
+            const auto shard = static_cast<std::size_t>(it - pids.begin());
+            *it = -1;
+
+            if (WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                control(shard).finished.load(std::memory_order_acquire)) {
+                --running;
+                continue;
+            }
+            if (result.restarts >= config_.maxRestarts) {
+                killAll();
+                throw std::runtime_error("ShardSupervisor: shard " + std::to_string(shard) +
+                                         " failed after " + std::to_string(result.restarts) + " restarts");
+            }
+            ++result.restarts;
+            spawn(shard, false);
+        }
+
+        result.shards.reserve(shardCount_);
+        for (std::size_t s = 0; s < shardCount_; ++s) result.shards.push_back(control(s).result);
+        return result;
+    }
+
+    void ShardSupervisor::runShard(std::size_t shard, uint64_t ticks, bool firstIncarnation) {
+#ifdef __linux__
+        ::prctl(PR_SET_PDEATHSIG, SIGKILL);  // Don't outlive the supervisor
+#endif
+        int code = 0;
+        try {
+            shardLoop(shard, ticks, firstIncarnation);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "shard %zu: %s\n", shard, e.what());
+            code = 1;
+        }
+        // Skip the supervisor's destructors and atexit handlers
+        ::_exit(code);
+    }
+
+    void ShardSupervisor::shardLoop(std::size_t shard, uint64_t ticks, bool firstIncarnation) {
+        Control& self = control(shard);
+        const auto& nodes = shardNodes_[shard];
+
+        // Build this shard's part of the network
+        coordination::NetworkCoordinator network(spec_.network);
+        network.setThreadCount(config_.threadsPerShard);
+        std::vector<std::shared_ptr<engine::TrafficEngine>> engines;
+        std::vector<std::size_t> localOf(spec_.nodes.size(), 0);
+        for (const std::size_t global : nodes) {
+            const auto& node = spec_.nodes[global];
+            localOf[global] = engines.size();
+            engines.push_back(std::make_shared<engine::TrafficEngine>(node.lanes, node.config));
+            network.addIntersection(engines.back(), node.offsetSeconds);
+        }
+        for (const auto& link : spec_.links) {
+            if (spec_.nodes[link.fromNode].shard == shard && spec_.nodes[link.toNode].shard == shard) {
+                network.addLink(localOf[link.fromNode], link.fromLane,
+                                localOf[link.toNode], link.toLane, link.travelSeconds);
+            }
+        }
+        std::vector<uint32_t> portLink;  ///< Port → cross link
+        for (std::size_t c = 0; c < crossLinks_.size(); ++c) {
+            if (crossLinks_[c].fromShard == shard) {
+                network.addPort(crossLinks_[c].fromLocal, crossLinks_[c].fromLane);
+                portLink.push_back(static_cast<uint32_t>(c));
+            }
+        }
+
+        // Process state; everything below is what a checkpoint holds
+        uint64_t tick = 0;
+        uint64_t digest = 0;
+        uint64_t received = 0;
+        std::vector<uint64_t> writeCursor(shardCount_, 0);  ///< Per destination shard
+        std::vector<uint64_t> readCursor(shardCount_, 0);   ///< Per source shard
+        std::vector<FlowRecord> pending;                    ///< Received, not yet due
+        coordination::NetworkState state;
+
+        auto publishCursors = [&] {
+            for (std::size_t s = 0; s < shardCount_; ++s) {
+                if (s == shard) continue;
+                ring(shard, s).publishTail(writeCursor[s]);
+                ring(s, shard).publishHead(readCursor[s]);
+            }
+        };
+
+        const uint64_t committed = self.commit.load(std::memory_order_acquire);
+        if (committed > 0) {
+            const uint8_t* buffer = checkpointBuffer(shard, committed);
+            uint64_t size = 0;
+            std::memcpy(&size, buffer, sizeof(size));
+            ByteReader in(buffer + sizeof(size), size);
+            tick     = in.get<uint64_t>();
+            digest   = in.get<uint64_t>();
+            received = in.get<uint64_t>();
+            in.getVector(writeCursor);
+            in.getVector(readCursor);
+            in.getVector(pending);
+            getState(in, state);
+            network.restoreState(state);
+            // The previous process may have died between commit and publish
+            publishCursors();
+        }
+
+        std::vector<uint8_t> image;
+        auto checkpoint = [&](uint64_t doneTicks) {
+            network.saveState(state);
+            ByteWriter out(image);
+            out.put(doneTicks);
+            out.put(digest);
+            out.put(received);
+            out.putVector(writeCursor);
+            out.putVector(readCursor);
+            out.putVector(pending);
+            putState(out, state);
+            if (image.size() + sizeof(uint64_t) > config_.checkpointBytes) {
+                throw std::runtime_error("checkpoint of " + std::to_string(image.size()) +
+                                         " bytes exceeds checkpointBytes");
+            }
+
+            // Write the idle buffer, then flip to it
+            const uint64_t next = self.commit.load(std::memory_order_relaxed) + 1;
+            uint8_t* buffer = checkpointBuffer(shard, next);
+            const uint64_t size = image.size();
+            std::memcpy(buffer, &size, sizeof(size));
+            std::memcpy(buffer + sizeof(size), image.data(), image.size());
+            self.commit.store(next, std::memory_order_release);
+            publishCursors();
+        };
+
+        for (; tick < ticks; ++tick) {
+            if (firstIncarnation && tick == crashTick_[shard]) ::kill(::getpid(), SIGKILL);
+
+            // Barrier: every shard has finished the previous tick
+            for (std::size_t s = 0; s < shardCount_; ++s) {
+                while (control(s).done.load(std::memory_order_acquire) < tick) std::this_thread::yield();
+            }
+
+            // Collect published flows from upstream shards
+            for (std::size_t s = 0; s < shardCount_; ++s) {
+                if (s == shard) continue;
+                const ShmRing in = ring(s, shard);
+                const uint64_t tail = in.publishedTail();
+                for (; readCursor[s] < tail; ++readCursor[s]) pending.push_back(in.at(readCursor[s]));
+            }
+
+            // Deliver flows whose link travel time has passed
+            for (std::size_t k = 0; k < pending.size();) {
+                const auto& link = crossLinks_[pending[k].link];
+                const uint64_t due = pending[k].releaseTick + link.travelSeconds;
+                if (due > tick) {
+                    ++k;
+                    continue;
+                }
+                if (due < tick) throw std::runtime_error("flow on cross link " + std::to_string(pending[k].link) + " arrived late");
+                const engine::LaneDelta delta{static_cast<uint32_t>(link.toLane),
+                                              static_cast<int32_t>(pending[k].vehicles)};
+                engines[link.toLocal]->applyDeltas({&delta, 1});
+                received += pending[k].vehicles;
+                pending[k] = pending.back();
+                pending.pop_back();
+            }
+
+            network.tick(static_cast<uint32_t>(tick));
+
+            const auto& decisions = network.lastDecisions();
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                digest = digestDecision(digest, tick, nodes[i], decisions[i]);
+            }
+
+            // Send vehicles released onto ports (published with the next checkpoint)
+            const auto flows = network.portFlows();
+            for (std::size_t p = 0; p < flows.size(); ++p) {
+                if (flows[p] == 0) continue;
+                const uint32_t c = portLink[p];
+                const uint32_t to = crossLinks_[c].toShard;
+                if (!ring(shard, to).tryWrite(writeCursor[to], {c, flows[p], tick})) {
+                    throw std::runtime_error("ring to shard " + std::to_string(to) + " is full; raise ringCapacity");
+                }
+            }
+
+            if ((tick + 1) % interval_ == 0 || tick + 1 == ticks) checkpoint(tick + 1);
+            self.done.store(tick + 1, std::memory_order_release);
+        }
+
+        self.result = {network.stats(), digest, received};
+        self.finished.store(1, std::memory_order_release);
+    }
+
+}
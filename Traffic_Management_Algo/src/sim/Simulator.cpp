@@ -0,0 +1,154 @@
+#include "sim/Simulator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace tip::sim {
+
+    namespace {
+        /// Highest mean arrival rate accepted per lane; keeps inversion sampling short.
+        constexpr double MAX_RATE_PER_SECOND = 10.0;
+
+        /// Cap on one Poisson draw, far above any accepted rate's tail.
+        constexpr uint32_t MAX_DRAW = 128;
+
+        constexpr uint32_t SECONDS_PER_DAY = 86400;
+    }
+
+    Simulator::Simulator(SimConfig config)
+        : config_(config), rng_(config.seed)
+    {
+        if (!(config_.saturationFlow >= 0.0)) {
+            throw std::invalid_argument("Simulator: saturationFlow must be non-negative");
+        }
+    }
+
+    void Simulator::addIntersection(std::shared_ptr<engine::TrafficEngine> engine,
+                                    int32_t offsetSeconds,
+                                    std::vector<ArrivalProfile> profiles)
+    {
+        if (profiles.size() != engine->lanes().size()) {
+            throw std::invalid_argument("Simulator: expected one arrival profile per lane");
+        }
+        for (const auto& profile : profiles) {
+            double peak = profile.ratePerSecond;
+            for (double f : profile.hourlyFactors) peak = std::max(peak, profile.ratePerSecond * f);
+            if (!(profile.ratePerSecond >= 0.0) || peak > MAX_RATE_PER_SECOND ||
+                std::any_of(profile.hourlyFactors.begin(), profile.hourlyFactors.end(),
+                            [](double f) { return !(f >= 0.0); })) {
+                throw std::invalid_argument("Simulator: arrival rates must be within [0, 10] per second");
+            }
+        }
+
+        laneBase_.push_back(profiles_.size());
+        for (auto& profile : profiles) profiles_.push_back(std::move(profile));
+        lambda_.resize(profiles_.size(), 0.0);
+        emptyChance_.resize(profiles_.size(), 1.0);
+        credit_.resize(profiles_.size(), 0.0);
+        ratesHour_ = std::numeric_limits<uint32_t>::max(); // recompute for the new lanes
+
+        corridor_.addIntersection(engine, offsetSeconds);
+        engines_.push_back(std::move(engine));
+    }
+
+    void Simulator::addIntersection(std::shared_ptr<engine::TrafficEngine> engine,
+                                    int32_t offsetSeconds,
+                                    const ArrivalProfile& profile)
+    {
+        std::vector<ArrivalProfile> profiles(engine->lanes().size(), profile);
+        addIntersection(std::move(engine), offsetSeconds, std::move(profiles));
+    }
+
+    void Simulator::tick() {
+        const auto secondOfDay = static_cast<uint32_t>((config_.startSecond + stats_.ticks) % SECONDS_PER_DAY);
+        updateRates(secondOfDay);
+
+        arrive();
+        corridor_.tick(static_cast<uint32_t>(stats_.ticks));
+        discharge();
+
+        ++stats_.ticks;
+    }
+
+    void Simulator::run(uint64_t ticks) {
+        for (uint64_t t = 0; t < ticks; ++t) tick();
+    }
+
+    void Simulator::updateRates(uint32_t secondOfDay) {
+        const uint32_t hour = secondOfDay / 3600;
+        if (hour == ratesHour_) return;
+        ratesHour_ = hour;
+        for (std::size_t l = 0; l < profiles_.size(); ++l) {
+            lambda_[l]      = profiles_[l].ratePerSecond * profiles_[l].factorAt(secondOfDay);
+            emptyChance_[l] = std::exp(-lambda_[l]);
+        }
+    }
+
+    uint32_t Simulator::samplePoisson(std::size_t l) {
+        const double u = static_cast<double>(rng_() >> 11) * 0x1.0p-53;
+        double p = emptyChance_[l];
+        double cumulative = p;
+        uint32_t k = 0;
+        // Rounding can leave cumulative just below 1; the bound keeps the loop finite
+        while (u > cumulative && k < MAX_DRAW) {
+            ++k;
+            p *= lambda_[l] / k;
+            cumulative += p;
+        }
+        return k;
+    }
+
+    void Simulator::arrive() {
+        for (std::size_t i = 0; i < engines_.size(); ++i) {
+            const auto& lanes = std::as_const(*engines_[i]).lanes();
+            const std::size_t base = laneBase_[i];
+            deltas_.clear();
+            for (std::size_t l = 0; l < lanes.size(); ++l) {
+                const uint32_t arrivals = samplePoisson(base + l);
+                const uint32_t room = config_.laneCapacity - std::min(lanes[l].queueLength, config_.laneCapacity);
+                const uint32_t joined = std::min(arrivals, room);
+                if (joined > 0) {
+                    deltas_.push_back({static_cast<uint32_t>(l), static_cast<int32_t>(joined)});
+                }
+                stats_.arrivals += joined;
+                stats_.blocked  += arrivals - joined;
+            }
+            engines_[i]->applyDeltas(deltas_);
+        }
+    }
+
+    void Simulator::discharge() {
+        const auto& decisions = corridor_.lastDecisions();
+        for (std::size_t i = 0; i < engines_.size(); ++i) {
+            auto& engine = *engines_[i];
+            const auto& lanes = std::as_const(engine).lanes();
+            const auto& d = decisions[i];
+            const model::LaneMask green = d.signalState == model::SignalPhase::GREEN
+                                        ? engine.phases()[d.selectedPhaseIndex].mask
+                                        : model::LaneMask{0};
+            double* credit = credit_.data() + laneBase_[i];
+            deltas_.clear();
+
+            for (std::size_t l = 0; l < lanes.size(); ++l) {
+                uint32_t departed = 0;
+                if (model::testLane(green, l)) {
+                    credit[l] += config_.saturationFlow;
+                    const auto capacity = static_cast<uint32_t>(credit[l]);
+                    credit[l] -= capacity;
+                    departed = std::min(capacity, lanes[l].queueLength);
+                    if (departed > 0) {
+                        deltas_.push_back({static_cast<uint32_t>(l), -static_cast<int32_t>(departed)});
+                    }
+                    stats_.departures += departed;
+                } else {
+                    credit[l] = 0.0;
+                }
+                stats_.queuedVehicleSeconds += lanes[l].queueLength - departed;
+            }
+            engine.applyDeltas(deltas_);
+        }
+    }
+
+}
@@ -0,0 +1,212 @@
+
+#include "trace/TraceReader.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace tip::trace {
+
+    using encoding::getVarint;
+    using encoding::unzigzag;
+
+    namespace {
+        /// Bounds of the next length-prefixed column; advances pos past it.
+        struct Column {
+            const uint8_t* pos;
+            const uint8_t* end;
+        };
+
+        Column nextColumn(const uint8_t*& pos, const uint8_t* end) {
+            const uint64_t length = getVarint(pos, end);
+            if (length > static_cast<uint64_t>(end - pos)) {
+                throw std::runtime_error("trace: column overruns chunk");
+            }
+            Column column{pos, pos + length};
+            pos += length;
+            return column;
+        }
+
+        uint8_t getByte(Column& column) {
+            if (column.pos == column.end) throw std::runtime_error("trace: truncated column");
+            return *column.pos++;
+        }
+
+        uint64_t getVarint(Column& column) {
+            return encoding::getVarint(column.pos, column.end);
+        }
+    }
+
+    TraceReader::TraceReader(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::runtime_error("TraceReader: cannot open " + path);
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("TraceReader: " + path + " is truncated");
+        }
+        mappingSize_ = static_cast<std::size_t>(st.st_size);
+        mapping_ = ::mmap(nullptr, mappingSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            throw std::runtime_error("TraceReader: cannot map " + path);
+        }
+
+        try {
+            const auto* base = static_cast<const uint8_t*>(mapping_);
+            const uint8_t* end = base + mappingSize_;
+
+            FileHeader file;
+            std::memcpy(&file, base, sizeof(file));
+            if (std::memcmp(file.magic, MAGIC, sizeof(MAGIC)) != 0) {
+                throw std::runtime_error("TraceReader: " + path + " is not a trace file");
+            }
+            if (file.version != FORMAT_VERSION) {
+                throw std::runtime_error("TraceReader: " + path + " has unsupported version " +
+                                         std::to_string(file.version));
+            }
+
+            firstTick_ = std::numeric_limits<uint64_t>::max();
+            for (const uint8_t* pos = base + sizeof(FileHeader); pos != end;) {
+                ChunkHeader header;
+                if (static_cast<std::size_t>(end - pos) < sizeof(header)) {
+                    throw std::runtime_error("TraceReader: " + path + " ends inside a chunk header");
+                }
+                std::memcpy(&header, pos, sizeof(header));
+                pos += sizeof(header);
+                if (header.payloadBytes > static_cast<uint64_t>(end - pos)) {
+                    throw std::runtime_error("TraceReader: " + path + " ends inside a chunk");
+                }
+
+                if (header.kind == ChunkKind::PHASE_NAMES) {
+                    readNames(header, pos, pos + header.payloadBytes);
+                } else if (header.kind == ChunkKind::DECISIONS) {
+                    // Every record and every lane sample takes at least one
+                    // payload byte, so larger counts mean a corrupt header
+                    if (header.count > header.payloadBytes ||
+                        (header.laneCount != 0 && header.count > header.payloadBytes / header.laneCount)) {
+                        throw std::runtime_error("TraceReader: " + path + " has a chunk too small for its records");
+                    }
+                    chunks_.push_back({header, pos});
+                    recordCount_ += header.count;
+                    firstTick_ = std::min(firstTick_, header.firstTick);
+                    lastTick_  = std::max(lastTick_, header.lastTick);
+                }
+                // Unknown chunk kinds are skipped
+                pos += header.payloadBytes;
+            }
+            if (chunks_.empty()) firstTick_ = 0;
+        } catch (...) {
+            ::munmap(mapping_, mappingSize_);
+            throw;
+        }
+    }
+
+    TraceReader::~TraceReader() {
+        if (mapping_) {
+            ::munmap(mapping_, mappingSize_);
+        }
+    }
+
+    void TraceReader::readNames(const ChunkHeader& header, const uint8_t* pos, const uint8_t* end) {
+        for (uint32_t i = 0; i < header.count; ++i) {
+            const uint64_t id = getVarint(pos, end);
+            const uint64_t length = getVarint(pos, end);
+            if (length > static_cast<uint64_t>(end - pos) || id > std::numeric_limits<uint32_t>::max()) {
+                throw std::runtime_error("TraceReader: malformed phase name");
+            }
+            if (id >= nameIds_.size()) nameIds_.resize(id + 1, model::NO_PHASE_NAME);
+            nameIds_[id] = model::internPhaseName({reinterpret_cast<const char*>(pos), length});
+            pos += length;
+        }
+    }
+
+    void TraceReader::decode(std::size_t chunk) const {
+        const auto& header = chunks_[chunk].header;
+        const std::size_t count = header.count;
+        const std::size_t lanes = header.laneCount;
+        const uint8_t* pos = chunks_[chunk].payload;
+        const uint8_t* end = pos + header.payloadBytes;
+
+        ticks_.resize(count);
+        decisions_.assign(count, model::Decision{});
+        samples_.resize(count * lanes);
+
+        Column column = nextColumn(pos, end);
+        uint64_t tick = header.firstTick;
+        for (std::size_t r = 0; r < count; ++r) {
+            tick += static_cast<uint64_t>(unzigzag(getVarint(column)));
+            ticks_[r] = tick;
+        }
+
+        column = nextColumn(pos, end);
+        for (auto& d : decisions_) d.selectedPhaseIndex = getVarint(column);
+
+        column = nextColumn(pos, end);
+        for (auto& d : decisions_) {
+            const uint64_t id = getVarint(column);
+            d.phaseNameId = id < nameIds_.size() ? nameIds_[id] : model::NO_PHASE_NAME;
+        }
+
+        column = nextColumn(pos, end);
+        for (auto& d : decisions_) d.signalState = static_cast<model::SignalPhase>(getByte(column));
+
+        column = nextColumn(pos, end);
+        for (auto& d : decisions_) d.activePriority = static_cast<model::PriorityReason>(getByte(column));
+
+        column = nextColumn(pos, end);
+        for (auto& d : decisions_) d.greenDuration = static_cast<uint32_t>(getVarint(column));
+
+        column = nextColumn(pos, end);
+        uint64_t score = 0;
+        for (auto& d : decisions_) {
+            score ^= getVarint(column);
+            d.phaseScore = std::bit_cast<double>(score);
+        }
+
+        column = nextColumn(pos, end);
+        for (std::size_t l = 0; l < lanes; ++l) {
+            uint64_t q = 0;
+            for (std::size_t r = 0; r < count; ++r) {
+                q += static_cast<uint64_t>(unzigzag(getVarint(column)));
+                samples_[r * lanes + l].queueLength = static_cast<uint32_t>(q);
+            }
+        }
+
+        column = nextColumn(pos, end);
+        for (std::size_t l = 0; l < lanes; ++l) {
+            uint64_t w = 0;
+            for (std::size_t r = 0; r < count; ++r) {
+                w += static_cast<uint64_t>(unzigzag(getVarint(column)));
+                samples_[r * lanes + l].waitCounter = static_cast<uint32_t>(w);
+            }
+        }
+
+        column = nextColumn(pos, end);
+        for (std::size_t l = 0; l < lanes; ++l) {
+            uint64_t bits = 0;
+            for (std::size_t r = 0; r < count; ++r) {
+                bits ^= getVarint(column);
+                samples_[r * lanes + l].bleBoost = std::bit_cast<double>(bits);
+            }
+        }
+
+        column = nextColumn(pos, end);
+        for (std::size_t l = 0; l < lanes; ++l) {
+            for (std::size_t r = 0; r < count; ++r) {
+                samples_[r * lanes + l].priorityReason = static_cast<model::PriorityReason>(getByte(column));
+            }
+        }
+    }
+
+}
@@ -0,0 +1,235 @@
+
+#include "trace/TraceWriter.hpp"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace tip::trace {
+
+    using encoding::putVarint;
+    using encoding::zigzag;
+
+    namespace {
+        void appendColumn(std::vector<uint8_t>& payload, const std::vector<uint8_t>& column) {
+            putVarint(payload, column.size());
+            payload.insert(payload.end(), column.begin(), column.end());
+        }
+
+        [[nodiscard]] int64_t delta(uint64_t value, uint64_t previous) noexcept {
+            return static_cast<int64_t>(value - previous);
+        }
+    }
+
+    // --- EngineRecorder ---
+
+    EngineRecorder::EngineRecorder(TraceWriter& writer, uint32_t engineId,
+                                   std::size_t laneCount, std::size_t capacity)
+        : writer_(writer), engineId_(engineId), laneCount_(laneCount), capacity_(capacity)
+    {
+        ticks_.reserve(capacity_);
+        decisions_.reserve(capacity_);
+        lanes_.reserve(capacity_ * laneCount_);
+    }
+
+    void EngineRecorder::record(uint64_t tick, const model::Decision& decision,
+                                std::span<const model::Lane> lanes) {
+        if (lanes.size() != laneCount_) {
+            throw std::invalid_argument("EngineRecorder: engine " + std::to_string(engineId_) +
+                                        " records " + std::to_string(laneCount_) + " lanes, got " +
+                                        std::to_string(lanes.size()));
+        }
+        ticks_.push_back(tick);
+        decisions_.push_back(decision);
+        for (const auto& lane : lanes) {
+            lanes_.push_back({lane.queueLength, lane.waitCounter, lane.bleBoost, lane.priorityReason});
+        }
+        if (ticks_.size() >= capacity_) {
+            flush();
+        }
+    }
+
+    void EngineRecorder::flush() {
+        const std::size_t count = ticks_.size();
+        if (count == 0) return;
+
+        payload_.clear();
+
+        column_.clear();
+        uint64_t previousTick = ticks_.front();
+        for (uint64_t tick : ticks_) {
+            putVarint(column_, zigzag(delta(tick, previousTick)));
+            previousTick = tick;
+        }
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        for (const auto& d : decisions_) putVarint(column_, d.selectedPhaseIndex);
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        for (const auto& d : decisions_) putVarint(column_, d.phaseNameId);
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        for (const auto& d : decisions_) column_.push_back(static_cast<uint8_t>(d.signalState));
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        for (const auto& d : decisions_) column_.push_back(static_cast<uint8_t>(d.activePriority));
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        for (const auto& d : decisions_) putVarint(column_, d.greenDuration);
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        uint64_t previousScore = 0;
+        for (const auto& d : decisions_) {
+            const auto bits = std::bit_cast<uint64_t>(d.phaseScore);
+            putVarint(column_, bits ^ previousScore);
+            previousScore = bits;
+        }
+        appendColumn(payload_, column_);
+
+        // Lane columns run along time for one lane, then the next lane
+        column_.clear();
+        for (std::size_t l = 0; l < laneCount_; ++l) {
+            uint64_t previous = 0;
+            for (std::size_t r = 0; r < count; ++r) {
+                const uint64_t q = lanes_[r * laneCount_ + l].queueLength;
+                putVarint(column_, zigzag(delta(q, previous)));
+                previous = q;
+            }
+        }
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        for (std::size_t l = 0; l < laneCount_; ++l) {
+            uint64_t previous = 0;
+            for (std::size_t r = 0; r < count; ++r) {
+                const uint64_t w = lanes_[r * laneCount_ + l].waitCounter;
+                putVarint(column_, zigzag(delta(w, previous)));
+                previous = w;
+            }
+        }
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        for (std::size_t l = 0; l < laneCount_; ++l) {
+            uint64_t previous = 0;
+            for (std::size_t r = 0; r < count; ++r) {
+                const auto bits = std::bit_cast<uint64_t>(lanes_[r * laneCount_ + l].bleBoost);
+                putVarint(column_, bits ^ previous);
+                previous = bits;
+            }
+        }
+        appendColumn(payload_, column_);
+
+        column_.clear();
+        for (std::size_t l = 0; l < laneCount_; ++l) {
+            for (std::size_t r = 0; r < count; ++r) {
+                column_.push_back(static_cast<uint8_t>(lanes_[r * laneCount_ + l].priorityReason));
+            }
+        }
+        appendColumn(payload_, column_);
+
+        ChunkHeader header{};
+        header.kind         = ChunkKind::DECISIONS;
+        header.engineId     = engineId_;
+        header.count        = static_cast<uint32_t>(count);
+        header.laneCount    = static_cast<uint32_t>(laneCount_);
+        header.firstTick    = ticks_.front();
+        header.lastTick     = ticks_.back();
+        header.payloadBytes = payload_.size();
+        writer_.writeChunk(header, payload_, decisions_);
+
+        ticks_.clear();
+        decisions_.clear();
+        lanes_.clear();
+    }
+
+    // --- TraceWriter ---
+
+    TraceWriter::TraceWriter(const std::string& path, std::size_t recordsPerChunk)
+        : out_(path, std::ios::binary | std::ios::trunc)
+        , path_(path)
+        , recordsPerChunk_(std::max<std::size_t>(1, recordsPerChunk))
+    {
+        if (!out_) {
+            throw std::runtime_error("TraceWriter: cannot create " + path);
+        }
+        FileHeader header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = FORMAT_VERSION;
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+
+    TraceWriter::~TraceWriter() {
+        try {
+            flush();
+        } catch (...) {
+            // Destructors must not throw; an incomplete final chunk is dropped
+        }
+    }
+
+    EngineRecorder& TraceWriter::recorder(uint32_t engineId, std::size_t laneCount) {
+        std::lock_guard lock(mutex_);
+        auto& slot = recorders_[engineId];
+        if (!slot) {
+            slot.reset(new EngineRecorder(*this, engineId, laneCount, recordsPerChunk_));
+        } else if (slot->laneCount() != laneCount) {
+            throw std::invalid_argument("TraceWriter: engine " + std::to_string(engineId) +
+                                        " already records " + std::to_string(slot->laneCount()) + " lanes");
+        }
+        return *slot;
+    }
+
+    void TraceWriter::flush() {
+        std::vector<EngineRecorder*> recorders;
+        {
+            std::lock_guard lock(mutex_);
+            for (auto& [id, recorder] : recorders_) recorders.push_back(recorder.get());
+        }
+        for (auto* recorder : recorders) recorder->flush();
+
+        std::lock_guard lock(mutex_);
+        out_.flush();
+        if (!out_) {
+            throw std::runtime_error("TraceWriter: failed writing " + path_);
+        }
+    }
+
+    void TraceWriter::writeChunk(const ChunkHeader& header, std::span<const uint8_t> payload,
+                                 std::span<const model::Decision> decisions) {
+        std::lock_guard lock(mutex_);
+
+        // Define phase names before the first chunk that uses them
+        namesPayload_.clear();
+        uint32_t newNames = 0;
+        for (const auto& d : decisions) {
+            if (!namesWritten_.insert(d.phaseNameId).second) continue;
+            const auto name = d.phaseName();
+            putVarint(namesPayload_, d.phaseNameId);
+            putVarint(namesPayload_, name.size());
+            namesPayload_.insert(namesPayload_.end(), name.begin(), name.end());
+            ++newNames;
+        }
+        if (newNames > 0) {
+            ChunkHeader names{};
+            names.kind         = ChunkKind::PHASE_NAMES;
+            names.count        = newNames;
+            names.payloadBytes = namesPayload_.size();
+            out_.write(reinterpret_cast<const char*>(&names), sizeof(names));
+            out_.write(reinterpret_cast<const char*>(namesPayload_.data()),
+                       static_cast<std::streamsize>(namesPayload_.size()));
+        }
+
+        out_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out_.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        if (!out_) {
+            throw std::runtime_error("TraceWriter: failed writing " + path_);
+        }
+    }
+
+}
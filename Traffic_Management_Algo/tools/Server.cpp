@@ -0,0 +1,45 @@
+
+/// Native replacement for algo_api.py: serves /update and /status from
+/// tip_core engines, one per intersection ID.
+///
+/// Usage: tip_server [port=8000]
+
+#include "server/HttpServer.hpp"
+#include "server/TrafficService.hpp"
+
+#include <csignal>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+using namespace tip;
+
+static server::HttpServer* runningServer = nullptr;
+
+static void onSignal(int) {
+    if (runningServer) runningServer->stop();
+}
+
+int main(int argc, char** argv) {
+    const auto port = static_cast<uint16_t>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8000);
+
+    try {
+        server::TrafficService service;
+        server::HttpServer httpServer(port, [&](auto requests, auto responses) {
+            service.handle(requests, responses);
+        });
+
+        runningServer = &httpServer;
+        std::signal(SIGINT, onSignal);
+        std::signal(SIGTERM, onSignal);
+
+        std::cout << "tip_server listening on port " << httpServer.port() << "\n" << std::flush;
+        httpServer.run();
+        std::cout << "tip_server stopped after " << service.stepCount() << " engine steps across "
+                  << service.intersectionCount() << " intersections\n";
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,160 @@
+/// Runs a grid district as shard processes, once cleanly and once with a
+/// shard killed mid-run, and checks both against one in-process network.
+/// Repeats this with dynamic phase mode on, where the restarted shard must
+/// also rebuild its dynamic phases from the checkpoint.
+///
+/// Usage: tip_shards [rows=16] [cols=16] [shards=4] [ticks=900]
+
+#include "shard/ShardSupervisor.hpp"
+#include "engine/TrafficEngine.hpp"
+#include "model/Lane.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace tip;
+
+/// Approach a's vehicles head east, south, west, north for a = 0..3;
+/// lane 2a is its through lane, 2a + 1 its left turn.
+static constexpr int ROW_STEP[4] = {0, 1, 0, -1};
+static constexpr int COL_STEP[4] = {1, 0, -1, 0};
+
+/// With paths, lanes whose centerlines cross conflict, which dynamic mode
+/// needs to have anything to search.
+static std::vector<model::Lane> createFourWayIntersection(std::mt19937& rng, bool paths) {
+    std::vector<model::Lane> lanes;
+    std::size_t id = 0;
+    for (uint16_t a = 0; a < 4; ++a) {
+        model::Direction dir(a, 4);
+        std::vector<model::Point> through, left;
+        if (paths) {
+            const double dx = COL_STEP[a], dy = ROW_STEP[a];
+            through = {{-10.0 * dx + dy, -10.0 * dy - dx}, {10.0 * dx + dy, 10.0 * dy - dx}};
+            left    = {{-9.0 * dx + dy, -9.0 * dy - dx}, {0.0, 0.0}, {-10.0 * dy, 10.0 * dx}};
+        }
+        lanes.push_back({id++, dir, model::MovementType::THROUGH,        through, static_cast<uint32_t>(rng() % 40)});
+        lanes.push_back({id++, dir, model::MovementType::LEFT_PROTECTED, left,    static_cast<uint32_t>(rng() % 12)});
+    }
+    return lanes;
+}
+
+/// Grid whose columns are split into vertical strips, one per shard.
+static shard::NetworkSpec buildGrid(int rows, int cols, int shards, bool dynamic) {
+    std::mt19937 rng(42);
+    engine::EngineConfig config;
+    config.dynamicPhases = dynamic;
+    shard::NetworkSpec spec;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            spec.nodes.push_back({createFourWayIntersection(rng, dynamic), config, (r * 7 + c * 3) % 30,
+                                  static_cast<uint32_t>(c * shards / cols)});
+        }
+    }
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            for (int a = 0; a < 4; ++a) {
+                for (int turn = 0; turn < 2; ++turn) {
+                    const int heading = turn == 0 ? a : (a + 3) % 4;
+                    const int nr = r + ROW_STEP[heading];
+                    const int nc = c + COL_STEP[heading];
+                    if (nr < 0 || nr >= rows || nc < 0 || nc >= cols) continue;
+                    spec.links.push_back({static_cast<std::size_t>(r * cols + c), static_cast<std::size_t>(2 * a + turn),
+                                          static_cast<std::size_t>(nr * cols + nc), static_cast<std::size_t>(2 * heading),
+                                          static_cast<uint32_t>(20 + (r * 7 + c * 3) % 15)});
+                }
+            }
+        }
+    }
+    return spec;
+}
+
+/// The same network in one process, reported per shard.
+static std::vector<shard::ShardResult> runInProcess(const shard::NetworkSpec& spec, std::size_t shards, uint64_t ticks) {
+    coordination::NetworkCoordinator network(spec.network);
+    for (const auto& node : spec.nodes) {
+        network.addIntersection(std::make_shared<engine::TrafficEngine>(node.lanes, node.config), node.offsetSeconds);
+    }
+    for (const auto& link : spec.links) {
+        network.addLink(link.fromNode, link.fromLane, link.toNode, link.toLane, link.travelSeconds);
+    }
+
+    std::vector<shard::ShardResult> results(shards);
+    for (uint64_t t = 0; t < ticks; ++t) {
+        network.tick(static_cast<uint32_t>(t));
+        const auto& decisions = network.lastDecisions();
+        for (std::size_t i = 0; i < spec.nodes.size(); ++i) {
+            auto& digest = results[spec.nodes[i].shard].decisionDigest;
+            digest = shard::digestDecision(digest, t, i, decisions[i]);
+        }
+    }
+    results[0].stats = network.stats();  // Totals only
+    return results;
+}
+
+static bool matches(const shard::ShardRunResult& run, const std::vector<shard::ShardResult>& reference) {
+    coordination::NetworkStats total;
+    uint64_t received = 0;
+    bool same = true;
+    for (std::size_t s = 0; s < run.shards.size(); ++s) {
+        const auto& stats = run.shards[s].stats;
+        same = same && run.shards[s].decisionDigest == reference[s].decisionDigest;
+        total.departures += stats.departures;
+        total.exits      += stats.exits;
+        total.delivered  += stats.delivered;
+        total.queuedVehicleSeconds += stats.queuedVehicleSeconds;
+        received += run.shards[s].received;
+    }
+    const auto& expected = reference[0].stats;
+    return same && total.departures == expected.departures && total.exits == expected.exits
+        && total.delivered + received == expected.delivered
+        && total.queuedVehicleSeconds == expected.queuedVehicleSeconds;
+}
+
+int main(int argc, char** argv) {
+    const int      rows   = argc > 1 ? std::atoi(argv[1]) : 16;
+    const int      cols   = argc > 2 ? std::atoi(argv[2]) : 16;
+    const int      shards = argc > 3 ? std::atoi(argv[3]) : 4;
+    const uint64_t ticks  = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 900;
+    if (rows <= 0 || cols <= 0 || shards <= 0 || shards > cols) {
+        std::cerr << "need positive rows and cols and 1 <= shards <= cols\n";
+        return 2;
+    }
+
+    std::cout << "Sharded network: " << rows << "x" << cols << " grid, " << shards << " shards, "
+              << ticks << " ticks\n";
+
+    bool ok = true;
+    for (const bool dynamic : {false, true}) {
+        const auto spec = buildGrid(rows, cols, shards, dynamic);
+        const char* mode = dynamic ? " dynamic" : " planned";
+
+        auto start = std::chrono::steady_clock::now();
+        const auto reference = runInProcess(spec, static_cast<std::size_t>(shards), ticks);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "  in-process" << mode << " | " << std::fixed << std::setprecision(2) << elapsed.count() << " s"
+                  << " | departures=" << reference[0].stats.departures << "\n";
+
+        for (const bool crash : {false, true}) {
+            shard::ShardSupervisor supervisor(spec);
+            if (crash) supervisor.injectCrash(static_cast<std::size_t>(shards / 2), ticks / 2 + 7);
+
+            start = std::chrono::steady_clock::now();
+            const auto run = supervisor.run(ticks);
+            elapsed = std::chrono::steady_clock::now() - start;
+
+            const bool same = matches(run, reference);
+            ok = ok && same;
+            std::cout << "  " << (crash ? "with crash" : "clean     ") << mode
+                      << " | " << elapsed.count() << " s"
+                      << " | checkpoint every " << supervisor.checkpointInterval() << " ticks"
+                      << " | restarts=" << run.restarts
+                      << " | " << (same ? "identical" : "MISMATCH") << "\n";
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,50 @@
+
+/// Prints the decisions in a trace file as text, optionally limited to a
+/// tick range and one engine.
+///
+/// Usage: tip_trace_dump <file> [fromTick=0] [toTick=max] [engineId=all]
+
+#include "trace/TraceReader.hpp"
+
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <limits>
+
+using namespace tip;
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <file> [fromTick] [toTick] [engineId]\n";
+        return 2;
+    }
+    const uint64_t fromTick = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+    const uint64_t toTick   = argc > 3 ? std::strtoull(argv[3], nullptr, 10)
+                                       : std::numeric_limits<uint64_t>::max();
+    const bool     oneEngine = argc > 4;
+    const auto     engineId  = oneEngine ? static_cast<uint32_t>(std::strtoul(argv[4], nullptr, 10)) : 0U;
+
+    try {
+        trace::TraceReader reader(argv[1]);
+        std::cout << "# " << reader.recordCount() << " records, ticks "
+                  << reader.firstTick() << ".." << reader.lastTick() << "\n";
+
+        reader.forEachInRange(fromTick, toTick, [&](const trace::TraceRecord& record) {
+            if (oneEngine && record.engineId != engineId) return;
+            std::cout << record.tick << " engine=" << record.engineId
+                      << " phase=" << record.decision.selectedPhaseIndex
+                      << " | " << record.decision.summary() << "\n";
+            for (std::size_t l = 0; l < record.lanes.size(); ++l) {
+                const auto& lane = record.lanes[l];
+                std::cout << "    lane " << l << ": queue=" << lane.queueLength
+                          << " wait=" << lane.waitCounter
+                          << " boost=" << lane.bleBoost
+                          << " priority=" << model::to_string(lane.priorityReason) << "\n";
+            }
+        });
+    } catch (const std::exception& e) {
+        std::cerr << "error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}